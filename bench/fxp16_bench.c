@@ -0,0 +1,305 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_bench.c
+
+    \brief  Throughput benchmark of the scalar and batched fxp16 functions
+
+    \details Prints ns per element of every case for every kernel implementation
+             the CPU can run. An optional argument selects the cases whose name
+             contains it. Inputs are fixed pseudo random data, so runs of the
+             same build are comparable.
+*/
+
+#include "fxp16.h"
+#include "fxp16_complex.h"
+#include "fxp16_dispatch.h"
+#include "fxp16_gemm.h"
+#include "fxp16_goertzel.h"
+#include "fxp16_lut.h"
+#include "fxp16_mat.h"
+#include "fxp16_moments.h"
+#include "fxp16_pipe.h"
+#include "fxp16_ring.h"
+#include "fxp16_view.h"
+#include "fxp16_wrap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+#define BENCH_N         4096            /* elements per call, L1/L2 resident */
+#define BENCH_MIN_NS    200000000.0     /* measure each case for at least 0.2 s */
+#define BENCH_GEMM      64              /* square gemm size */
+
+
+static fxp16_t         x[BENCH_N], y[BENCH_N], z[BENCH_N];
+static float           f[BENCH_N];
+static fxp32_t         w[BENCH_N], u[BENCH_N];
+static fxp16_complex_t ca[BENCH_N], cb[BENCH_N], cy[BENCH_N];
+static fxp16_t         ga[BENCH_GEMM * BENCH_GEMM], gb[BENCH_GEMM * BENCH_GEMM], gc[BENCH_GEMM * BENCH_GEMM];
+static fxp16_t         lut[FXP16_LUT_ENTRIES];
+static fxp16_fmod_const_t twopi;
+static fxp16_rng_t     rng;
+static fxp16_mat3_t    rot;
+static fxp16_goertzel_t gz;
+static fxp32_t         gz_state[FXP16_GOERTZEL_STATE(4, 64)];
+static fxp16_sdft_t    sd;
+static fxp16_t         sd_delay[256];
+static fxp16_ring_t    ring;
+static fxp16_pipe_t    pipe;
+static fxp16_t         ring_buf[1024];
+static fxp16_t         px[BENCH_N], py[BENCH_N], pz[BENCH_N];
+static volatile fxp16_t sink;
+
+
+static void bench_sin(void)     { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_sin(x[i]); }
+static void bench_atan2(void)   { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_atan2(x[i], z[i]); }
+static void bench_sqrt(void)    { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_sqrt((fxp16_t)(x[i] & INT16_MAX), FXP16_Q8); }
+static void bench_tanh(void)    { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_tanh(FXP16_Q15, x[i], FXP16_Q12); }
+static void bench_mult(void)    { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_mult(x[i], FXP16_Q12, z[i], FXP16_Q12); }
+static void bench_mult_even(void)  { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_mult_mode(x[i], FXP16_Q12, z[i], FXP16_Q12, FXP16_ROUND_NEAREST_EVEN, NULL); }
+static void bench_mult_stoch(void) { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_mult_mode(x[i], FXP16_Q12, z[i], FXP16_Q12, FXP16_ROUND_STOCHASTIC, &rng); }
+static void bench_div(void)     { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_div(x[i], FXP16_Q8, z[i] | 1, FXP16_Q8); }
+static void bench_fmod(void)    { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_fmod(x[i], FXP16_Q12, FXP16_Q12_M_TWOPI, FXP16_Q12); }
+static void bench_fmod_const(void) { for (int i = 0; i < BENCH_N; i++) y[i] = fxp16_fmod_const(x[i], &twopi); }
+static void bench_tanh_vec(void)    { fxp16_tanh_vec(FXP16_Q15, x, FXP16_Q12, y, BENCH_N); }
+static void bench_sigmoid_vec(void) { fxp16_sigmoid_vec(FXP16_Q15, x, FXP16_Q12, y, BENCH_N); }
+static void bench_fp2fp_vec(void)   { fxp16_fp2fp_vec(x, y, BENCH_N, FXP16_Q12, FXP16_Q8); }
+static void bench_narrow_vec(void)  { fxp16_narrow_vec(w, y, BENCH_N, 24, FXP16_Q12); }
+static void bench_flt2fp_vec(void)  { fxp16_flt2fp_vec(f, y, BENCH_N, FXP16_Q12); }
+static void bench_fp2flt_vec(void)  { fxp16_fp2flt_vec(x, f, BENCH_N, FXP16_Q12); }
+static void bench_cmul_vec(void)    { fxp16_cmul_vec(ca, cb, cy, BENCH_N, FXP16_Q15); }
+static void bench_cmag_vec(void)    { fxp16_cmag_vec(ca, y, BENCH_N); }
+static void bench_lut_gather(void)  { fxp16_lut_gather(lut, x, y, BENCH_N); }
+static void bench_round_vec(void)   { fxp16_round_vec(x, y, BENCH_N, FXP16_Q8, FXP16_ROUND_NEAREST_EVEN); }
+static void bench_remainder_vec(void) { fxp16_remainder_vec(x, y, BENCH_N, FXP16_Q12, FXP16_Q12_M_TWOPI, FXP16_Q12); }
+static void bench_unwrap_vec(void)  { fxp16_unwrap_t st = FXP16_UNWRAP_INIT; fxp16_unwrap_vec(&st, x, u, BENCH_N); }
+static void bench_mat3_soa(void)    { fxp16_mat3_transform_soa(&rot, FXP16_Q14, x, y, z, px, py, pz, BENCH_N); }
+static void bench_quat_norm(void)
+{
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        fxp16_quat_t q = { x[i], z[i], (fxp16_t)(x[i] >> 1), (fxp16_t)(z[i] >> 3) };
+        sink = fxp16_quat_normalize(q).w;
+    }
+}
+
+static void bench_rms_vec(void)     { sink = fxp16_rms_vec(x, BENCH_N, FXP16_Q15, FXP16_Q15); }
+static void bench_minmax_vec(void)  { fxp16_t lo, hi; fxp16_minmax_vec(x, BENCH_N, &lo, &hi); sink = hi; }
+static void bench_goertzel(void)    { fxp16_goertzel_block(&gz, x, BENCH_N / 64); }
+static void bench_sdft(void)        { fxp16_sdft_block(&sd, x, BENCH_N); }
+
+static void bench_deinterleave(void)
+{
+    fxp16_t *const planes[4] = { y, y + BENCH_N / 4, y + BENCH_N / 2, y + 3 * BENCH_N / 4 };
+    fxp16_deinterleave(x, planes, 4, BENCH_N / 4);
+}
+
+static void bench_fp2fp_view(void)
+{
+    for (size_t c = 0; c < 3; c++)
+    {
+        fxp16_fp2fp_view(fxp16_cview_channel(x, BENCH_N / 3, 3, c), fxp16_view_channel(y, BENCH_N / 3, 3, c), FXP16_Q12, FXP16_Q15);
+    }
+}
+
+/* 16 channels of BENCH_N / 16 through 4 fused requantize stages */
+static void bench_pipe(void)
+{
+    const fxp16_t *in[16];
+    fxp16_t *out[16];
+
+    for (int c = 0; c < 16; c++)
+    {
+        in[c]  = x + c * (BENCH_N / 16);
+        out[c] = y + c * (BENCH_N / 16);
+    }
+    fxp16_pipe_run(&pipe, in, out, NULL, 16, BENCH_N / 16);
+}
+
+static void bench_ring(void)
+{
+    for (int i = 0; i < BENCH_N; i += 256)
+    {
+        fxp16_ring_write(&ring, x + i, 256);
+        fxp16_ring_read(&ring, y + i, 256);
+    }
+}
+
+static void bench_gemm(void)
+{
+    fxp16_gemm(BENCH_GEMM, BENCH_GEMM, BENCH_GEMM, ga, BENCH_GEMM, FXP16_Q12, gb, BENCH_GEMM, FXP16_Q12,
+               gc, BENCH_GEMM, FXP16_Q12, NULL);
+}
+
+
+typedef struct {
+    const char *name;
+    void      (*fn)(void);
+    double      elems;      /* elements (or MACs) per call */
+    int         batched;    /* runs the dispatched kernels */
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    { "sin",         bench_sin,         BENCH_N, 0 },
+    { "atan2",       bench_atan2,       BENCH_N, 0 },
+    { "sqrt",        bench_sqrt,        BENCH_N, 0 },
+    { "tanh",        bench_tanh,        BENCH_N, 0 },
+    { "mult",        bench_mult,        BENCH_N, 0 },
+    { "mult_even",   bench_mult_even,   BENCH_N, 0 },
+    { "mult_stoch",  bench_mult_stoch,  BENCH_N, 0 },
+    { "div",         bench_div,         BENCH_N, 0 },
+    { "fmod",        bench_fmod,        BENCH_N, 0 },
+    { "fmod_const",  bench_fmod_const,  BENCH_N, 0 },
+    { "unwrap_vec",  bench_unwrap_vec,  BENCH_N, 0 },
+    { "remainder_vec", bench_remainder_vec, BENCH_N, 0 },
+    { "mat3_soa",    bench_mat3_soa,    BENCH_N, 0 },
+    { "quat_norm",   bench_quat_norm,   BENCH_N, 0 },
+    { "tanh_vec",    bench_tanh_vec,    BENCH_N, 1 },
+    { "sigmoid_vec", bench_sigmoid_vec, BENCH_N, 1 },
+    { "fp2fp_vec",   bench_fp2fp_vec,   BENCH_N, 1 },
+    { "narrow_vec",  bench_narrow_vec,  BENCH_N, 1 },
+    { "flt2fp_vec",  bench_flt2fp_vec,  BENCH_N, 1 },
+    { "fp2flt_vec",  bench_fp2flt_vec,  BENCH_N, 1 },
+    { "cmul_vec",    bench_cmul_vec,    BENCH_N, 1 },
+    { "cmag_vec",    bench_cmag_vec,    BENCH_N, 1 },
+    { "lut_gather",  bench_lut_gather,  BENCH_N, 1 },
+    { "round_vec",   bench_round_vec,   BENCH_N, 1 },
+    { "rms_vec",     bench_rms_vec,     BENCH_N, 1 },
+    { "minmax_vec",  bench_minmax_vec,  BENCH_N, 1 },
+    { "goertzel",    bench_goertzel,    BENCH_N * 4, 1 },
+    { "sdft (bin)",  bench_sdft,        BENCH_N * 4, 0 },
+    { "ring",        bench_ring,        BENCH_N, 0 },
+    { "deinterleave4", bench_deinterleave, BENCH_N, 1 },
+    { "fp2fp_view s3", bench_fp2fp_view, BENCH_N / 3 * 3, 1 },
+    { "pipe (4 st)", bench_pipe,        BENCH_N, 1 },
+    { "gemm (MAC)",  bench_gemm,        (double)BENCH_GEMM * BENCH_GEMM * BENCH_GEMM, 1 },
+};
+
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double bench_run(const bench_case_t *c)
+{
+    double t0, t;
+    long calls = 0;
+
+    c->fn();    /* warm up */
+
+    t0 = bench_now_ns();
+    do
+    {
+        c->fn();
+        calls++;
+        t = bench_now_ns() - t0;
+    } while (t < BENCH_MIN_NS);
+
+    sink = y[0];
+    return t / (calls * c->elems);
+}
+
+static void bench_init(void)
+{
+    uint32_t s = 12345u;
+    const fxp16_lut_q_t q = { FXP16_Q12, FXP16_Q15 };
+
+    fxp16_rng_seed(&rng, 1);
+    fxp16_fmod_const_init(&twopi, FXP16_Q12, FXP16_Q12_M_TWOPI, FXP16_Q12);
+    fxp16_goertzel_init(&gz, (const fxp16_t[4]){ 1000, 3000, 7000, 15000 }, 4, 64, gz_state);
+    fxp16_ring_init(&ring, ring_buf, 1024);
+    {
+        static const fxp16_pipe_fp2fp_t up = { FXP16_Q12, FXP16_Q13 }, down = { FXP16_Q13, FXP16_Q12 };
+        const fxp16_pipe_stage_t st[4] = {
+            { "up",   fxp16_pipe_fp2fp, &up,   NULL, 0, FXP16_PIPE_ELEMENTWISE },
+            { "down", fxp16_pipe_fp2fp, &down, NULL, 0, FXP16_PIPE_ELEMENTWISE },
+            { "up",   fxp16_pipe_fp2fp, &up,   NULL, 0, FXP16_PIPE_ELEMENTWISE },
+            { "down", fxp16_pipe_fp2fp, &down, NULL, 0, FXP16_PIPE_ELEMENTWISE },
+        };
+        fxp16_pipe_init(&pipe, st, 4, BENCH_N / 16, 1);
+    }
+    fxp16_sdft_init(&sd, 256, (const size_t[4]){ 3, 17, 40, 90 }, 4, sd_delay);
+    fxp16_quat_to_mat3(fxp16_euler_to_quat((fxp16_euler_t){ 3000, -2000, 9000 }), &rot);
+
+    for (int i = 0; i < BENCH_N; i++)
+    {
+        s = s * 1103515245u + 12345u; x[i] = (fxp16_t)(s >> 16);
+        s = s * 1103515245u + 12345u; z[i] = (fxp16_t)(s >> 16);
+        w[i]  = (fxp32_t)s >> 4;
+        f[i]  = (float)x[i] / 4096.0f;
+        ca[i] = (fxp16_complex_t){ x[i], z[i] };
+        cb[i] = (fxp16_complex_t){ z[i], x[i] };
+    }
+
+    for (int i = 0; i < BENCH_GEMM * BENCH_GEMM; i++)
+    {
+        ga[i] = x[i % BENCH_N] >> 4;
+        gb[i] = z[i % BENCH_N] >> 4;
+    }
+
+    fxp16_lut_build(lut, fxp16_lut_tanh, &q);
+}
+
+
+int main(int argc, char **argv)
+{
+    const char *filter = (argc > 1) ? argv[1] : NULL;
+
+    bench_init();
+
+    printf("fxp16 %d.%d.%d, cpu: %s\n", FXP16_VERSION_MAJOR, FXP16_VERSION_MINOR, FXP16_VERSION_PATCH,
+           fxp16_isa_name(fxp16_dispatch_cpu()));
+    printf("%-14s %-8s %10s\n", "case", "kernels", "ns/elem");
+
+    for (size_t k = 0; k < sizeof(bench_cases) / sizeof(bench_cases[0]); k++)
+    {
+        const bench_case_t *c = &bench_cases[k];
+
+        if (filter && !strstr(c->name, filter)) continue;
+
+        for (int isa = 0; isa < FXP16_ISA_COUNT; isa++)
+        {
+            if (fxp16_dispatch_force((fxp16_isa_t)isa) != 0) continue;
+
+            printf("%-14s %-8s %10.3f\n", c->name, fxp16_isa_name((fxp16_isa_t)isa), bench_run(c));
+            fflush(stdout);
+
+            if (!c->batched) break;
+        }
+    }
+
+    fxp16_dispatch_reset();
+    return EXIT_SUCCESS;
+}
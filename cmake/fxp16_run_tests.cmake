@@ -0,0 +1,46 @@
+# Runs the myunit suite and fails on every failed assertion except the known
+# failures listed below. Usage: cmake -DFXP16_TESTS=<exe> -P fxp16_run_tests.cmake
+#
+# Known failures: some INRANGE assertions of the sin/cos/tan testcases compare
+# the error against pinned statistics (+-1%) that do not match the current
+# CORDIC implementation (e.g. sin mean: pinned 7.31e-5, measured 7.56e-5).
+# They fail on the original tree as well and stay visible in the output until
+# re-pinned. Entries are <testcase>:<line> of myunit/myunit_fxp16.c, so every
+# other assertion of these testcases still counts.
+
+cmake_minimum_required(VERSION 3.16)
+
+set(FXP16_KNOWN_FAILURES
+    "fxp16_sin:254"     # mean error
+    "fxp16_cos:277"     # mean error
+    "fxp16_tan:373"     # max error
+    "fxp16_tan:376")    # mean error
+
+execute_process(COMMAND ${FXP16_TESTS}
+                OUTPUT_VARIABLE out
+                ERROR_VARIABLE err
+                RESULT_VARIABLE rc)
+
+string(REGEX MATCHALL "<TCF> selftest [A-Za-z0-9_]+ [0-9]+ \"[A-Z_]+\"" failures "${out}")
+string(REGEX MATCH "<TSE> [^\n]*" summary "${out}")
+
+set(unexpected "")
+foreach(f ${failures})
+    string(REGEX REPLACE "<TCF> selftest ([A-Za-z0-9_]+) ([0-9]+) .*" "\\1:\\2" tc "${f}")
+    if(tc IN_LIST FXP16_KNOWN_FAILURES)
+        message(STATUS "known failure: ${f}")
+    else()
+        list(APPEND unexpected "${f}")
+    endif()
+endforeach()
+
+if(NOT summary)
+    message(FATAL_ERROR "fxp16_tests did not finish (exit ${rc})\n${err}")
+endif()
+
+message(STATUS "${summary}")
+
+if(unexpected)
+    string(REPLACE ";" "\n" unexpected "${unexpected}")
+    message(FATAL_ERROR "failed assertions:\n${unexpected}")
+endif()
@@ -0,0 +1,894 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_diff.c
+
+    \brief  Differential test harness for the fxp16 fast paths
+*/
+
+#include "fxp16_diff.h"
+#include "fxp16_kernels.h"
+#include "fxp16_complex.h"
+#include "fxp16_lut.h"
+#include "fxp16_wrap.h"
+#include "fxp16_goertzel.h"
+#include "fxp16_moments.h"
+#include "fxp16_view.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define FXP16_DIFF_BLOCK        1000        /* elements per fast path call, not a multiple of any vector width */
+#define FXP16_DIFF_CHUNK        65536       /* inputs per work item */
+#define FXP16_DIFF_LUTS         5
+
+
+typedef struct fxp16_diff_case_s fxp16_diff_case_t;
+
+typedef struct {
+    const fxp16_diff_case_t *c;
+    fxp16_diff_report_fn     report;
+    uint64_t                 mismatches;
+} fxp16_diff_ctx_t;
+
+/* checks n inputs (a[i], b[i]) of one configuration */
+typedef void (*fxp16_diff_check_fn)(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n);
+
+struct fxp16_diff_case_s {
+    const char         *name;
+    unsigned            configs;    /* number of Q configurations */
+    int                 sampled;    /* 0: a runs over all 16 bit inputs, 1: random (a, b) */
+    fxp16_diff_check_fn check;
+};
+
+
+static pthread_mutex_t fxp16_diff_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned fxp16_diff_reports[32];
+
+
+static void fxp16_diff_fail(fxp16_diff_ctx_t *ctx, unsigned cfg, int64_t a, int64_t b, int64_t expect, int64_t got);
+
+
+/* ---- bit-exact model of the basic operations ---------------------------- */
+
+static int64_t fxp16_diff_floor_div(int64_t n, int64_t d)
+{
+    int64_t q = n / d;
+    return (n % d != 0 && (n < 0) != (d < 0)) ? q - 1 : q;
+}
+
+/* v / 2^s as the library rounds it: half up for v >= 0, toward -inf for v < 0 */
+static int64_t fxp16_diff_rshift(int64_t v, unsigned s)
+{
+    int64_t d = (int64_t)1 << s;
+
+#if FXP16CONF_ARSHIFT_W_ROUNDING
+    if (s > 0 && v >= 0)
+        return fxp16_diff_floor_div(v + d / 2, d);
+#endif
+
+    return fxp16_diff_floor_div(v, d);
+}
+
+static fxp16_t fxp16_diff_sat(int64_t v)
+{
+    return (fxp16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+
+static fxp16_t fxp16_diff_mult_model(fxp16_t x, fxp16_t y, unsigned yfrac)
+{
+    return fxp16_diff_sat(fxp16_diff_rshift((int64_t)x * y, yfrac));
+}
+
+static fxp16_t fxp16_diff_div_model(fxp16_t x, fxp16_t y, unsigned yfrac)
+{
+    if (y == 0) return (x < 0) ? INT16_MIN : INT16_MAX;
+    return fxp16_diff_sat((int64_t)x * ((int64_t)1 << yfrac) / y);
+}
+
+/* x - trunc(x / y) * y with the product rounded back to the format of x */
+static fxp16_t fxp16_diff_fmod_model(fxp16_t x, unsigned xfrac, fxp16_t y, unsigned yfrac)
+{
+    if (y == 0) return 0;
+
+    int64_t xs = (int64_t)1 << xfrac, ys = (int64_t)1 << yfrac;
+    int64_t n  = x * ys / (y * xs);
+
+    return fxp16_diff_sat(x - fxp16_diff_rshift(n * xs * y, yfrac));
+}
+
+/* x rounded to a multiple of 2^frac, as integral value (to_int) or in the format of x */
+static fxp16_t fxp16_diff_round_model(fxp16_t x, unsigned frac, fxp16_round_mode_t mode, int to_int)
+{
+    int64_t d  = (int64_t)1 << frac;
+    int64_t fl = fxp16_diff_floor_div(x, d);
+    int64_t r2 = 2 * (x - fl * d);
+    int64_t n  = fl;
+
+    switch (mode)
+    {
+        case FXP16_ROUND_STOCHASTIC:
+        case FXP16_ROUND_NEAREST_AWAY:  n += (r2 > d || (r2 == d && x >= 0)); break;
+        case FXP16_ROUND_NEAREST_EVEN:  n += (r2 > d || (r2 == d && (fl & 1))); break;
+        case FXP16_ROUND_FLOOR:         break;
+        case FXP16_ROUND_CEIL:          n += (r2 != 0); break;
+        case FXP16_ROUND_TRUNC:         n += (r2 != 0 && x < 0); break;
+        case FXP16_ROUND_HALF_UP:       n += (r2 >= d); break;
+    }
+
+    return fxp16_diff_sat(to_int ? n : n * d);
+}
+
+/* v / 2^s rounded by mode; the stochastic offset u is drawn by the caller */
+static int64_t fxp16_diff_arshift_model(int64_t v, unsigned s, fxp16_round_mode_t mode, uint32_t u)
+{
+    int64_t d  = (int64_t)1 << s;
+    int64_t fl = fxp16_diff_floor_div(v, d);
+    int64_t r2 = 2 * (v - fl * d);
+
+    switch (mode)
+    {
+        case FXP16_ROUND_NEAREST_AWAY:  return fl + (r2 > d || (r2 == d && v >= 0));
+        case FXP16_ROUND_NEAREST_EVEN:  return fl + (r2 > d || (r2 == d && (fl & 1)));
+        case FXP16_ROUND_FLOOR:         return fl;
+        case FXP16_ROUND_CEIL:          return fl + (r2 != 0);
+        case FXP16_ROUND_TRUNC:         return fl + (r2 != 0 && v < 0);
+        case FXP16_ROUND_HALF_UP:       return fl + (r2 >= d);
+        default:                        return fxp16_diff_floor_div(v + (u & (d - 1)), d);
+    }
+}
+
+/* x - n * y with n = x / y rounded to nearest even */
+static fxp16_t fxp16_diff_remquo_model(fxp16_t x, unsigned xfrac, fxp16_t y, unsigned yfrac, int64_t *quo)
+{
+    int64_t num = x * ((int64_t)1 << yfrac), den = y * ((int64_t)1 << xfrac);
+    int64_t q   = num / den;
+    int64_t r2  = 2 * (num - q * den);
+
+    if (r2 < 0) r2 = -r2;
+    if (r2 > llabs(den) || (r2 == llabs(den) && (q & 1)))
+        q += ((num < 0) != (den < 0)) ? -1 : 1;
+
+    *quo = q;
+    return fxp16_diff_sat(x - fxp16_diff_rshift(q * den, yfrac));
+}
+
+
+/* ---- cases --------------------------------------------------------------- */
+
+/* spreads a random 32 bit value over all magnitudes */
+static int32_t fxp16_diff_i32(uint32_t a, uint32_t b)
+{
+    return (int32_t)a >> (b & 31);
+}
+
+/* random float bit patterns and, more often, values near the fixed point grid */
+static float fxp16_diff_flt(uint32_t a, uint32_t b)
+{
+    float f;
+
+    if ((b & 3) == 0)
+    {
+        memcpy(&f, &a, sizeof(f));
+        return f;
+    }
+
+    return ldexpf((float)fxp16_diff_i32(a, b), -(int)((b >> 5) % 40));
+}
+
+static double fxp16_diff_dbl(uint32_t a, uint32_t b)
+{
+    uint64_t u = ((uint64_t)a << 32) | b;
+    double d;
+
+    if ((b & 3) == 0)
+    {
+        memcpy(&d, &u, sizeof(d));
+        return d;
+    }
+
+    return ldexp((double)fxp16_diff_i32(a, b) + (double)(b >> 16) / 65536.0, -(int)((b >> 5) % 40));
+}
+
+
+static void fxp16_diff_fp2fp(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t fo = cfg >> 4, fn = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_fp2fp_vec(x, y, n, fo, fn);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_fp2fp(x[i], fo, fn);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_narrow(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp32_t x[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t y[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t fo = cfg >> 4, fn = cfg & 15;
+
+    for (size_t i = 0; i < n; i++) x[i] = fxp16_diff_i32(a[i], b[i]);
+    fxp16_narrow_vec(x, y, n, fo, fn);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_requant32(x[i], (int)fo - (int)fn);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_tanh(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t yf = cfg >> 4, xf = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_tanh_vec(yf, x, xf, y, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_tanh_lut(yf, x[i], xf);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_sigmoid(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t yf = cfg >> 4, xf = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_sigmoid_vec(yf, x, xf, y, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_sigmoid_lut(yf, x[i], xf);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_fp2flt(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 };
+    float y[FXP16_DIFF_BLOCK] = { 0 };
+    (void)b;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_fp2flt_vec(x, y, n, cfg);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        float e = fxp16_fp2flt(x[i], cfg);
+        uint32_t ue, ug;
+        memcpy(&ue, &e, sizeof(ue));
+        memcpy(&ug, &y[i], sizeof(ug));
+        if (ue != ug) fxp16_diff_fail(ctx, cfg, x[i], 0, ue, ug);
+    }
+}
+
+static void fxp16_diff_flt2fp(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    float x[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t y[FXP16_DIFF_BLOCK] = { 0 };
+
+    for (size_t i = 0; i < n; i++) x[i] = fxp16_diff_flt(a[i], b[i]);
+    fxp16_flt2fp_vec(x, y, n, cfg);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_flt2fp(x[i], cfg);
+        uint32_t u;
+        memcpy(&u, &x[i], sizeof(u));
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, u, 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_dbl2fp(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    double x[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t y[FXP16_DIFF_BLOCK] = { 0 };
+
+    for (size_t i = 0; i < n; i++) x[i] = fxp16_diff_dbl(a[i], b[i]);
+    fxp16_dbl2fp_vec(x, y, n, cfg);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_dbl2fp(x[i], cfg);
+        int64_t u;
+        memcpy(&u, &x[i], sizeof(u));
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, u, 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_cmul(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_complex_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 }, z[FXP16_DIFF_BLOCK] = { 0 };
+
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i].re = (fxp16_t)a[i]; x[i].im = (fxp16_t)(a[i] >> 16);
+        y[i].re = (fxp16_t)b[i]; y[i].im = (fxp16_t)(b[i] >> 16);
+    }
+    fxp16_cmul_vec(x, y, z, n, cfg);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_complex_t e = fxp16_cmul(x[i], y[i], cfg);
+        if (e.re != z[i].re || e.im != z[i].im)
+        {
+            fxp16_diff_fail(ctx, cfg, a[i], b[i], ((uint32_t)(uint16_t)e.re << 16) | (uint16_t)e.im,
+                            ((uint32_t)(uint16_t)z[i].re << 16) | (uint16_t)z[i].im);
+        }
+    }
+}
+
+static void fxp16_diff_cmag(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_complex_t z[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t re[FXP16_DIFF_BLOCK], im[FXP16_DIFF_BLOCK], m[FXP16_DIFF_BLOCK], s[FXP16_DIFF_BLOCK];
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        z[i].re = re[i] = (fxp16_t)a[i];
+        z[i].im = im[i] = (fxp16_t)(a[i] >> 16);
+    }
+    fxp16_cmag_vec(z, m, n);
+    fxp16_cmag_soa(re, im, s, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_cmag(z[i]);
+        if (e != m[i]) fxp16_diff_fail(ctx, cfg, re[i], im[i], e, m[i]);
+        if (e != s[i]) fxp16_diff_fail(ctx, cfg, re[i], im[i], e, s[i]);
+    }
+}
+
+static void fxp16_diff_atan2(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_complex_t z[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t re[FXP16_DIFF_BLOCK], im[FXP16_DIFF_BLOCK], v[FXP16_DIFF_BLOCK], s[FXP16_DIFF_BLOCK];
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        z[i].re = re[i] = (fxp16_t)a[i];
+        z[i].im = im[i] = (fxp16_t)(a[i] >> 16);
+    }
+    fxp16_carg_vec(z, v, n);
+    fxp16_carg_soa(re, im, s, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_atan2(im[i], re[i]);
+        if (e != v[i]) fxp16_diff_fail(ctx, cfg, im[i], re[i], e, v[i]);
+        if (e != s[i]) fxp16_diff_fail(ctx, cfg, im[i], re[i], e, s[i]);
+    }
+}
+
+
+static fxp16_t fxp16_diff_luts[FXP16_DIFF_LUTS][FXP16_LUT_ENTRIES];
+static pthread_once_t fxp16_diff_luts_once = PTHREAD_ONCE_INIT;
+
+static const struct {
+    fxp16_lut_fn_t fn;
+    fxp16_lut_q_t  q;
+} fxp16_diff_lut_fns[FXP16_DIFF_LUTS] = {
+    { fxp16_lut_sin,  { FXP16_Q15, FXP16_Q15 } },
+    { fxp16_lut_cos,  { FXP16_Q15, FXP16_Q15 } },
+    { fxp16_lut_sqrt, { FXP16_Q8,  FXP16_Q8  } },
+    { fxp16_lut_atan, { FXP16_Q8,  FXP16_Q15 } },
+    { fxp16_lut_tanh, { FXP16_Q12, FXP16_Q15 } },
+};
+
+static void fxp16_diff_luts_build(void)
+{
+    for (int i = 0; i < FXP16_DIFF_LUTS; i++)
+    {
+        fxp16_lut_build(fxp16_diff_luts[i], fxp16_diff_lut_fns[i].fn, &fxp16_diff_lut_fns[i].q);
+    }
+}
+
+static void fxp16_diff_lut(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    (void)b;
+
+    pthread_once(&fxp16_diff_luts_once, fxp16_diff_luts_build);
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_lut_gather(fxp16_diff_luts[cfg], x, y, n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_diff_lut_fns[cfg].fn(x[i], &fxp16_diff_lut_fns[cfg].q);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+}
+
+static void fxp16_diff_mult(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t x = (fxp16_t)a[i], y = (fxp16_t)(a[i] >> 16);
+        fxp16_t e = fxp16_diff_mult_model(x, y, f2);
+        fxp16_t g = fxp16_mult(x, f1, y, f2);
+        if (e != g) fxp16_diff_fail(ctx, cfg, x, y, e, g);
+    }
+}
+
+static void fxp16_diff_div(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t x = (fxp16_t)a[i], y = (fxp16_t)(a[i] >> 16);
+        fxp16_t e = fxp16_diff_div_model(x, y, f2);
+        fxp16_t g = fxp16_div(x, f1, y, f2);
+        if (e != g) fxp16_diff_fail(ctx, cfg, x, y, e, g);
+    }
+}
+
+static void fxp16_diff_fmod(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t x = (fxp16_t)a[i], y = (fxp16_t)(a[i] >> 16);
+        fxp16_t e = fxp16_diff_fmod_model(x, f1, y, f2);
+        fxp16_t g = fxp16_fmod(x, f1, y, f2);
+        if (e != g) fxp16_diff_fail(ctx, cfg, x, y, e, g);
+    }
+}
+
+static void fxp16_diff_fmod_const(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    fxp16_fmod_const_t c;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t x = (fxp16_t)a[i], y = (fxp16_t)(a[i] >> 16);
+        if (fxp16_fmod_const_init(&c, f1, y, f2) != 0) continue;
+        fxp16_t e = fxp16_diff_fmod_model(x, f1, y, f2);
+        fxp16_t g = fxp16_fmod_const(x, &c);
+        if (e != g) fxp16_diff_fail(ctx, cfg, x, y, e, g);
+    }
+}
+
+/* cfg: frac | mode << 4 | to_int << 7 */
+static void fxp16_diff_round(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t frac = cfg & 15;
+    fxp16_round_mode_t mode = (fxp16_round_mode_t)((cfg >> 4) & 7);
+    int to_int = cfg >> 7;
+    (void)b;
+
+    if (mode > FXP16_ROUND_STOCHASTIC) return;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    if (to_int) fxp16_lround_vec(x, y, n, frac, mode);
+    else        fxp16_round_vec(x, y, n, frac, mode);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_diff_round_model(x[i], frac, mode, to_int);
+        if (e != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 0, e, y[i]);
+    }
+
+    if (mode == FXP16_ROUND_NEAREST_EVEN && !to_int)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            fxp16_t g = fxp16_rint(x[i], frac);
+            if (g != y[i]) fxp16_diff_fail(ctx, cfg, x[i], 1, y[i], g);
+        }
+    }
+}
+
+static void fxp16_diff_remquo(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    int64_t qe;
+    int q;
+    (void)b;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t x = (fxp16_t)a[i], y = (fxp16_t)(a[i] >> 16);
+        if (y == 0) continue;
+        fxp16_t e = fxp16_diff_remquo_model(x, f1, y, f2, &qe);
+        fxp16_t g = fxp16_remquo(x, f1, y, f2, &q);
+        if (e != g) fxp16_diff_fail(ctx, cfg, x, y, e, g);
+        if (qe != q) fxp16_diff_fail(ctx, cfg, x, y, qe, q);
+    }
+}
+
+/* one divisor per block, taken from b[0] */
+static void fxp16_diff_remquo_vec(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, r[FXP16_DIFF_BLOCK] = { 0 };
+    int     quo[FXP16_DIFF_BLOCK] = { 0 };
+    uint8_t f1 = cfg >> 4, f2 = cfg & 15;
+    fxp16_t y = (fxp16_t)(b[0] >> (b[0] & 15));
+    int64_t qe;
+
+    if (n == 0 || y == 0) return;
+
+    for (size_t i = 0; i < n; i++) x[i] = (fxp16_t)a[i];
+    fxp16_remquo_vec(x, r, quo, n, f1, y, f2);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t e = fxp16_diff_remquo_model(x[i], f1, y, f2, &qe);
+        if (e != r[i]) fxp16_diff_fail(ctx, cfg, x[i], y, e, r[i]);
+        if (qe != quo[i]) fxp16_diff_fail(ctx, cfg, x[i], y, qe, quo[i]);
+    }
+}
+
+/* cfg: shift | mode << 5, the stochastic mode replays the generator sequence */
+static void fxp16_diff_arshift_mode(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    uint8_t shift = cfg & 31;
+    fxp16_round_mode_t mode = (fxp16_round_mode_t)(cfg >> 5);
+    fxp16_rng_t rng, ref;
+
+    if (mode > FXP16_ROUND_STOCHASTIC) return;
+    fxp16_rng_seed(&rng, n ? b[0] : 0);
+    ref = rng;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp32_t v = fxp16_diff_i32(a[i], b[i]);
+        uint32_t u = (mode == FXP16_ROUND_STOCHASTIC && shift > 0) ? fxp16_rng_next(&ref) : 0;
+        int64_t e = (shift == 0) ? v : fxp16_diff_arshift_model(v, shift, mode, u);
+        fxp32_t g = fxp32_arshift_mode(v, shift, mode, &rng);
+        if (e != g) fxp16_diff_fail(ctx, cfg, v, 0, e, g);
+    }
+}
+
+/* cfg: tone frequency; random start state and samples on a channel count that leaves a vector tail */
+static void fxp16_diff_goertzel(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    enum { C = 13 };
+    fxp16_t x[FXP16_DIFF_BLOCK];
+    fxp32_t st[FXP16_GOERTZEL_STATE(1, C)], s1[C], s2[C];
+    fxp16_t f = (fxp16_t)(cfg * 4099u);
+    fxp16_goertzel_t g;
+    size_t m = n / C;
+
+    if (m == 0 || fxp16_goertzel_init(&g, &f, 1, C, st) != 0) return;
+
+    for (size_t c = 0; c < C; c++)
+    {
+        st[c]     = s1[c] = (fxp32_t)a[c];
+        st[C + c] = s2[c] = (fxp32_t)b[c];
+    }
+    for (size_t i = 0; i < m * C; i++) x[i] = (fxp16_t)(a[i] ^ (b[i] >> 16));
+
+    fxp16_goertzel_block(&g, x, m);
+
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t c = 0; c < C; c++)
+        {
+            int64_t p = fxp16_diff_floor_div((int64_t)g.coef[0] * s1[c] + (1 << 13), 1 << 14);
+            uint32_t s0 = (uint32_t)x[i * C + c] + (uint32_t)p - (uint32_t)s2[c];
+            s2[c] = s1[c];
+            s1[c] = (fxp32_t)s0;
+        }
+    }
+
+    for (size_t c = 0; c < C; c++)
+    {
+        if (st[c] != s1[c])     fxp16_diff_fail(ctx, cfg, c, 1, s1[c], st[c]);
+        if (st[C + c] != s2[c]) fxp16_diff_fail(ctx, cfg, c, 2, s2[c], st[C + c]);
+    }
+}
+
+/* cfg 0: random samples, 1: only -32768 and 32767, 2..3: smaller magnitudes; unaligned start */
+static void fxp16_diff_moments(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK];
+    fxp16_moments_t m = FXP16_MOMENTS_INIT;
+    int64_t sum = 0;
+    uint64_t sq = 0;
+    fxp16_t lo = INT16_MAX, hi = INT16_MIN;
+    size_t o = n ? b[0] % 16 : 0;
+
+    if (o > n) o = n;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = (cfg == 1) ? ((a[i] & 1) ? INT16_MIN : INT16_MAX) : (fxp16_t)((int32_t)a[i] >> (16 + 2 * cfg));
+    }
+    for (size_t i = o; i < n; i++)
+    {
+        sum += x[i];
+        sq  += (uint64_t)((int64_t)x[i] * x[i]);
+        lo = x[i] < lo ? x[i] : lo;
+        hi = x[i] > hi ? x[i] : hi;
+    }
+
+    fxp16_moments_update(&m, x + o, n - o);
+
+    if (m.sum != sum)       fxp16_diff_fail(ctx, cfg, (int64_t)n, 1, sum, m.sum);
+    if (m.sumsq_lo != sq)   fxp16_diff_fail(ctx, cfg, (int64_t)n, 2, (int64_t)sq, (int64_t)m.sumsq_lo);
+    if (m.min != lo)        fxp16_diff_fail(ctx, cfg, (int64_t)n, 3, lo, m.min);
+    if (m.max != hi)        fxp16_diff_fail(ctx, cfg, (int64_t)n, 4, hi, m.max);
+}
+
+
+/* cfg + 1 channels, frames after a random offset; planes and back */
+static void fxp16_diff_interleave(fxp16_diff_ctx_t *ctx, unsigned cfg, const uint32_t *a, const uint32_t *b, size_t n)
+{
+    fxp16_t x[FXP16_DIFF_BLOCK] = { 0 }, p[FXP16_DIFF_BLOCK] = { 0 }, y[FXP16_DIFF_BLOCK] = { 0 };
+    fxp16_t *planes[8] = { 0 };
+    const fxp16_t *cplanes[8] = { 0 };
+    size_t ch = (cfg < 8) ? cfg + 1 : 8;
+    size_t o = n ? b[0] % 16 : 0;
+    size_t frames = (n > o) ? (n - o) / ch : 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = (fxp16_t)(a[i] >> 16);
+    }
+    for (size_t c = 0; c < ch; c++)
+    {
+        planes[c] = p + c * frames;
+        cplanes[c] = planes[c];
+    }
+
+    fxp16_deinterleave(x + o, planes, ch, frames);
+    for (size_t f = 0; f < frames; f++)
+    {
+        for (size_t c = 0; c < ch; c++)
+        {
+            if (planes[c][f] != x[o + f * ch + c]) fxp16_diff_fail(ctx, cfg, (int64_t)f, (int64_t)c, x[o + f * ch + c], planes[c][f]);
+        }
+    }
+
+    fxp16_interleave(cplanes, y, ch, frames);
+    for (size_t i = 0; i < frames * ch; i++)
+    {
+        if (y[i] != x[o + i]) fxp16_diff_fail(ctx, cfg, (int64_t)i, -1, x[o + i], y[i]);
+    }
+}
+
+static const fxp16_diff_case_t fxp16_diff_cases[] = {
+    { "fp2fp_vec",   256, 0, fxp16_diff_fp2fp   },
+    { "narrow_vec",  512, 1, fxp16_diff_narrow  },
+    { "tanh_vec",    256, 0, fxp16_diff_tanh    },
+    { "sigmoid_vec", 256, 0, fxp16_diff_sigmoid },
+    { "fp2flt_vec",   16, 0, fxp16_diff_fp2flt  },
+    { "flt2fp_vec",   16, 1, fxp16_diff_flt2fp  },
+    { "dbl2fp_vec",   16, 1, fxp16_diff_dbl2fp  },
+    { "cmul_vec",     16, 1, fxp16_diff_cmul    },
+    { "cmag_vec",      1, 1, fxp16_diff_cmag    },
+    { "carg_vec",      1, 1, fxp16_diff_atan2   },
+    { "lut_gather", FXP16_DIFF_LUTS, 0, fxp16_diff_lut },
+    { "mult",        256, 1, fxp16_diff_mult    },
+    { "div",         256, 1, fxp16_diff_div     },
+    { "fmod",        256, 1, fxp16_diff_fmod    },
+    { "fmod_const",  256, 1, fxp16_diff_fmod_const },
+    { "round_vec",   256, 0, fxp16_diff_round   },
+    { "remquo",      256, 1, fxp16_diff_remquo  },
+    { "remquo_vec",  256, 1, fxp16_diff_remquo_vec },
+    { "arshift_mode", 256, 1, fxp16_diff_arshift_mode },
+    { "goertzel",     16, 1, fxp16_diff_goertzel },
+    { "moments",       4, 1, fxp16_diff_moments },
+    { "interleave",    8, 1, fxp16_diff_interleave },
+};
+
+#define FXP16_DIFF_CASES    (sizeof(fxp16_diff_cases) / sizeof(fxp16_diff_cases[0]))
+
+
+static void fxp16_diff_fail(fxp16_diff_ctx_t *ctx, unsigned cfg, int64_t a, int64_t b, int64_t expect, int64_t got)
+{
+    fxp16_diff_mismatch_t m = { ctx->c->name, cfg, a, b, expect, got };
+    size_t idx = (size_t)(ctx->c - fxp16_diff_cases);
+
+    ctx->mismatches++;
+
+    pthread_mutex_lock(&fxp16_diff_lock);
+    if (fxp16_diff_reports[idx] < FXP16_DIFF_MAX_REPORTS)
+    {
+        fxp16_diff_reports[idx]++;
+        ctx->report(&m);
+    }
+    pthread_mutex_unlock(&fxp16_diff_lock);
+}
+
+
+void fxp16_diff_print(const fxp16_diff_mismatch_t *m)
+{
+    printf("fxp16_diff: %s cfg %u input (%lld, %lld): expected %lld, got %lld\n",
+           m->name, m->cfg, (long long)m->a, (long long)m->b, (long long)m->expect, (long long)m->got);
+}
+
+
+/* ---- runner ------------------------------------------------------------- */
+
+typedef struct {
+    uint64_t samples;
+    uint64_t seed;
+    fxp16_diff_report_fn report;
+    atomic_uint_fast64_t next;
+    atomic_uint_fast64_t mismatches;
+} fxp16_diff_run_t;
+
+static uint64_t fxp16_diff_splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t fxp16_diff_chunks(const fxp16_diff_case_t *c, uint64_t samples)
+{
+    uint64_t inputs = c->sampled ? samples : 65536;
+    return c->configs * ((inputs + FXP16_DIFF_CHUNK - 1) / FXP16_DIFF_CHUNK);
+}
+
+/* runs work item w: one chunk of one configuration of one case */
+static uint64_t fxp16_diff_item(fxp16_diff_run_t *run, uint64_t w)
+{
+    uint32_t a[FXP16_DIFF_BLOCK], b[FXP16_DIFF_BLOCK];
+    size_t k = 0;
+
+    while (k < FXP16_DIFF_CASES && w >= fxp16_diff_chunks(&fxp16_diff_cases[k], run->samples))
+    {
+        w -= fxp16_diff_chunks(&fxp16_diff_cases[k], run->samples);
+        k++;
+    }
+    if (k == FXP16_DIFF_CASES) return 0;
+
+    const fxp16_diff_case_t *c = &fxp16_diff_cases[k];
+    fxp16_diff_ctx_t ctx = { c, run->report, 0 };
+    uint64_t inputs = c->sampled ? run->samples : 65536;
+    uint64_t per_cfg = (inputs + FXP16_DIFF_CHUNK - 1) / FXP16_DIFF_CHUNK;
+    unsigned cfg = (unsigned)(w / per_cfg);
+    uint64_t begin = (w % per_cfg) * FXP16_DIFF_CHUNK;
+    uint64_t end = begin + FXP16_DIFF_CHUNK < inputs ? begin + FXP16_DIFF_CHUNK : inputs;
+
+    while (begin < end)
+    {
+        size_t n = (end - begin) < FXP16_DIFF_BLOCK ? (size_t)(end - begin) : FXP16_DIFF_BLOCK;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (c->sampled)
+            {
+                uint64_t r = fxp16_diff_splitmix64(run->seed ^ ((uint64_t)k << 56) ^ ((uint64_t)cfg << 40) ^ (begin + i));
+                a[i] = (uint32_t)r;
+                b[i] = (uint32_t)(r >> 32);
+            }
+            else
+            {
+                a[i] = (uint32_t)(begin + i);
+                b[i] = 0;
+            }
+        }
+
+        c->check(&ctx, cfg, a, b, n);
+        begin += n;
+    }
+
+    return ctx.mismatches;
+}
+
+static void *fxp16_diff_worker(void *arg)
+{
+    fxp16_diff_run_t *run = arg;
+    uint64_t total = 0;
+
+    for (size_t k = 0; k < FXP16_DIFF_CASES; k++)
+    {
+        total += fxp16_diff_chunks(&fxp16_diff_cases[k], run->samples);
+    }
+
+    for (uint64_t w; (w = atomic_fetch_add(&run->next, 1)) < total; )
+    {
+        atomic_fetch_add(&run->mismatches, fxp16_diff_item(run, w));
+    }
+
+    return NULL;
+}
+
+
+uint64_t fxp16_diff_run(unsigned threads, uint64_t samples, uint64_t seed, fxp16_diff_report_fn report)
+{
+    fxp16_diff_run_t run;
+    pthread_t tid[64];
+    unsigned started = 0;
+
+    run.samples = samples;
+    run.seed = seed;
+    run.report = report ? report : fxp16_diff_print;
+    atomic_init(&run.next, 0);
+    atomic_init(&run.mismatches, 0);
+
+    memset(fxp16_diff_reports, 0, sizeof(fxp16_diff_reports));
+
+    if (threads > sizeof(tid) / sizeof(tid[0])) threads = sizeof(tid) / sizeof(tid[0]);
+
+    while (started + 1 < threads && pthread_create(&tid[started], NULL, fxp16_diff_worker, &run) == 0)
+    {
+        started++;
+    }
+
+    fxp16_diff_worker(&run);
+
+    while (started)
+    {
+        pthread_join(tid[--started], NULL);
+    }
+
+    return atomic_load(&run.mismatches);
+}
+
+
+uint64_t fxp16_diff_check_one(uint32_t a, uint32_t b, unsigned cfg, fxp16_diff_report_fn report)
+{
+    uint64_t mismatches = 0;
+
+    for (size_t k = 0; k < FXP16_DIFF_CASES; k++)
+    {
+        const fxp16_diff_case_t *c = &fxp16_diff_cases[k];
+        fxp16_diff_ctx_t ctx = { c, report ? report : fxp16_diff_print, 0 };
+        uint32_t a16 = c->sampled ? a : (uint16_t)a;
+
+        c->check(&ctx, cfg % c->configs, &a16, &b, 1);
+        mismatches += ctx.mismatches;
+    }
+
+    return mismatches;
+}
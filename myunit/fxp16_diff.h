@@ -0,0 +1,90 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_diff.h
+
+    \brief  Differential test harness for the fxp16 fast paths
+
+    \details Runs every batched, SIMD and table entry point against its scalar
+             reference in fxp16.c, and the basic binary operations against an
+             independent bit-exact model. Unary functions are checked over all
+             65536 inputs of every Q configuration, binary functions over a
+             reproducible random sample. Work is split over threads; every
+             mismatch is reported with its exact input.
+*/
+
+#ifndef _FXP16_DIFF_H_
+#define _FXP16_DIFF_H_
+
+#include "fxp16.h"
+
+
+#define FXP16_DIFF_MAX_REPORTS  8       /* reports per case and run, further mismatches are only counted */
+
+
+/*! \brief One mismatch between a fast path and its reference */
+typedef struct {
+    const char *name;       /*!< case name */
+    unsigned    cfg;        /*!< Q configuration, case specific (mostly frac1 * 16 + frac2) */
+    int64_t     a;          /*!< first input (bit pattern for float inputs) */
+    int64_t     b;          /*!< second input, 0 for unary cases */
+    int64_t     expect;     /*!< reference result (bit pattern for float results) */
+    int64_t     got;        /*!< fast path result */
+} fxp16_diff_mismatch_t;
+
+/*! \brief Mismatch callback, called serialized */
+typedef void (*fxp16_diff_report_fn)(const fxp16_diff_mismatch_t *m);
+
+
+/*!
+    \brief      Runs all cases
+    \param[in]  threads     Worker threads, 0 or 1 runs in the caller
+    \param[in]  samples     Random inputs per configuration of the binary cases
+    \param[in]  seed        Seed of the binary samples
+    \param[in]  report      Mismatch callback, NULL for fxp16_diff_print()
+    \returns    Number of mismatches
+*/
+uint64_t fxp16_diff_run(unsigned threads, uint64_t samples, uint64_t seed, fxp16_diff_report_fn report);
+
+/*!
+    \brief      Checks all cases at one input
+    \details    Entry point of the fuzzer: a, b and cfg are taken modulo the input
+                and configuration space of every case.
+    \param[in]  a       First input
+    \param[in]  b       Second input
+    \param[in]  cfg     Configuration selector
+    \param[in]  report  Mismatch callback, NULL for fxp16_diff_print()
+    \returns    Number of mismatches
+*/
+uint64_t fxp16_diff_check_one(uint32_t a, uint32_t b, unsigned cfg, fxp16_diff_report_fn report);
+
+/*! \brief Prints a mismatch to stdout */
+void fxp16_diff_print(const fxp16_diff_mismatch_t *m);
+
+#endif /* _FXP16_DIFF_H_ */
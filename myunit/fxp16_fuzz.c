@@ -0,0 +1,59 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_fuzz.c
+
+    \brief  libFuzzer entry point of the differential harness
+
+    \details Build with clang -fsanitize=fuzzer together with the library sources and
+             myunit/fxp16_diff.c. Every input is decoded into two 32 bit inputs
+             and a configuration selector; any mismatch aborts.
+*/
+
+#include "fxp16_diff.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t buf[10] = { 0 };
+    uint32_t a, b;
+    uint16_t cfg;
+
+    memcpy(buf, data, size < sizeof(buf) ? size : sizeof(buf));
+    memcpy(&a, buf, sizeof(a));
+    memcpy(&b, buf + 4, sizeof(b));
+    memcpy(&cfg, buf + 8, sizeof(cfg));
+
+    if (fxp16_diff_check_one(a, b, cfg, NULL))
+        abort();
+
+    return 0;
+}
@@ -37,9 +37,28 @@
 
 
 #include "fxp16.h"
+#include "fxp16_kernels.h"
+#include "fxp16_gemm.h"
+#include "fxp16_complex.h"
+#include "fxp16_bfp.h"
+#include "fxp16_stats.h"
+#include "fxp16_lut.h"
+#include "fxp16_lut_file.h"
+#include "fxp16_diff.h"
+#include "fxp16_dispatch.h"
+#include "fxp16_wrap.h"
+#include "fxp16_mat.h"
+#include "fxp16_goertzel.h"
+#include "fxp16_moments.h"
+#include "fxp16_pipe.h"
+#include "fxp16_ring.h"
+#include "fxp16_arena.h"
+#include "fxp16_view.h"
 #include "math.h"
 #include "stdio.h"
 #include <float.h>
+#include <string.h>
+#include <stdlib.h>
 
 
 
@@ -800,6 +819,1747 @@ MYUNIT_TESTCASE(fxp16_sinh)
 }
 
 
+MYUNIT_TESTCASE(fxp16_sinhcosh)
+{
+    static const uint8_t qpairs[][2] = {
+        {FXP16_Q8, FXP16_Q4}, {FXP16_Q12, FXP16_Q12}, {FXP16_Q15, FXP16_Q15}, {FXP16_Q4, FXP16_Q0}
+    };
+
+    static fxp16_t x[1<<16], s[1<<16], c[1<<16], t[1<<16];
+
+    for (size_t idx = 0; idx < sizeof(qpairs)/sizeof(*qpairs); idx++)
+    {
+        uint8_t x_frac = qpairs[idx][0];
+        uint8_t y_frac = qpairs[idx][1];
+        uint32_t mismatch = 0;
+
+        for (int32_t fp_x = INT16_MIN; fp_x <= INT16_MAX; fp_x++)
+        {
+            fxp16_t fs, fc, ft;
+            fxp16_sinhcoshtanh(y_frac, (fxp16_t)fp_x, x_frac, &fs, &fc, &ft);
+
+            if (fs != fxp16_sinh(y_frac, (fxp16_t)fp_x, x_frac)) mismatch++;
+            if (fc != fxp16_cosh(y_frac, (fxp16_t)fp_x, x_frac)) mismatch++;
+            if (ft != fxp16_tanh(y_frac, (fxp16_t)fp_x, x_frac)) mismatch++;
+
+            x[fp_x - INT16_MIN] = (fxp16_t)fp_x;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+
+        fxp16_sinhcosh_vec(y_frac, x, x_frac, s, c, t, 1<<16);
+
+        mismatch = 0;
+        for (int32_t i = 0; i < (1<<16); i++)
+        {
+            fxp16_t fs, fc;
+            fxp16_sinhcosh(y_frac, x[i], x_frac, &fs, &fc);
+            if (s[i] != fs || c[i] != fc || t[i] != fxp16_tanh(y_frac, x[i], x_frac)) mismatch++;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    }
+}
+
+
+
+/* max. deviation of fxp16_tanh_vec / fxp16_sigmoid_vec from the reference path in LSB, per y_frac */
+static const int myunit_tanh_vec_err_lsb[16]    = {1,1,1,1,1,1,1,1,1,1,1,1,1,2,4,9};
+static const int myunit_sigmoid_vec_err_lsb[16] = {1,1,1,1,1,1,1,1,1,1,1,1,1,2,2,4};
+
+MYUNIT_TESTCASE(fxp16_tanh_vec)
+{
+    static const uint8_t qpairs[][2] = {
+        {FXP16_Q8, FXP16_Q15}, {FXP16_Q12, FXP16_Q7}, {FXP16_Q15, FXP16_Q15}, {FXP16_Q0, FXP16_Q14}, {FXP16_Q4, FXP16_Q10}
+    };
+
+    static fxp16_t x[(1<<16)+5], y[(1<<16)+5], yref[(1<<16)+5];
+    const size_t n = (1<<16)+5;     /* odd length exercises the vector tail */
+
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = (fxp16_t)(INT16_MIN + (int32_t)(i & 0xFFFF));
+    }
+
+    for (size_t idx = 0; idx < sizeof(qpairs)/sizeof(*qpairs); idx++)
+    {
+        uint8_t x_frac = qpairs[idx][0];
+        uint8_t y_frac = qpairs[idx][1];
+        int maxerr = 0;
+        uint32_t mismatch = 0;
+
+        MYUNIT_PRINTF("Processing x_frac %d y_frac %d ...\n", x_frac, y_frac);
+
+        fxp16_tanh_vec(y_frac, x, x_frac, y, n);
+        fxp16_tanh_vec_scalar(y_frac, x, x_frac, yref, n);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            int err = abs(y[i] - fxp16_tanh(y_frac, x[i], x_frac));
+            if (err > maxerr) maxerr = err;
+            if (y[i] != yref[i]) mismatch++;
+            if (x[i] != INT16_MIN && y[i] != -y[(size_t)(-x[i] - INT16_MIN)]) mismatch++;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+        MYUNIT_ASSERT_INRANGE(maxerr, 0, myunit_tanh_vec_err_lsb[y_frac]);
+
+        fxp16_sigmoid_vec(y_frac, x, x_frac, y, n);
+        fxp16_sigmoid_vec_scalar(y_frac, x, x_frac, yref, n);
+
+        maxerr = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double ref = (1.0 + fxp16_fp2flt(fxp16_tanh(FXP16_Q15, x[i], x_frac+1), FXP16_Q15)) / 2.0;
+            long lref = lround(ref * (1 << y_frac));
+            if (lref > INT16_MAX) lref = INT16_MAX;
+
+            int err = abs(y[i] - (int)lref);
+            if (err > maxerr) maxerr = err;
+            if (y[i] != yref[i]) mismatch++;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+        MYUNIT_ASSERT_INRANGE(maxerr, 0, myunit_sigmoid_vec_err_lsb[y_frac]);
+    }
+}
+
+
+/* naive reference: wrapping 32 bit accumulator, single requantization */
+static void myunit_gemm_ref(size_t m, size_t n, size_t k, const fxp16_t *a, uint8_t a_frac,
+                            const fxp16_t *b, uint8_t b_frac, fxp16_t *c, const uint8_t *c_frac_rows)
+{
+    for (size_t i = 0; i < m; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            uint32_t acc = 0;
+            for (size_t p = 0; p < k; p++)
+            {
+                acc += (uint32_t)((fxp32_t)a[i*k+p] * b[p*n+j]);
+            }
+            c[i*n+j] = fxp16_requant32((fxp32_t)acc, (int)a_frac + b_frac - c_frac_rows[i]);
+        }
+    }
+}
+
+MYUNIT_TESTCASE(fxp16_gemm)
+{
+    static const size_t dims[][3] = {
+        {1, 1, 1}, {4, 16, 2}, {7, 37, 301}, {33, 65, 129}, {70, 130, 257}, {5, 3, 1000}
+    };
+
+    static fxp16_t a[70*1000], b[1000*130], c[70*130], cref[70*130], y[70], yref[70];
+    static uint8_t fracs[70];
+    uint32_t seed = 12345;
+
+    for (size_t idx = 0; idx < sizeof(dims)/sizeof(*dims); idx++)
+    {
+        size_t m = dims[idx][0], n = dims[idx][1], k = dims[idx][2];
+        /* small operands stay in range, the last pass uses full scale and wraps */
+        int full = (idx == sizeof(dims)/sizeof(*dims) - 1);
+        uint32_t mismatch = 0;
+
+        MYUNIT_PRINTF("Processing m %zu n %zu k %zu ...\n", m, n, k);
+
+        for (size_t i = 0; i < m*k; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            a[i] = full ? (fxp16_t)(seed >> 16) : (fxp16_t)((int32_t)(seed >> 16) % 2048);
+        }
+
+        for (size_t i = 0; i < k*n; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            b[i] = full ? (fxp16_t)(seed >> 16) : (fxp16_t)((int32_t)(seed >> 16) % 2048);
+        }
+
+        for (size_t i = 0; i < m; i++)
+        {
+            fracs[i] = (uint8_t)((i * 7) % 31);     /* exercises left and right shifts */
+        }
+
+        myunit_gemm_ref(m, n, k, a, FXP16_Q11, b, FXP16_Q12, cref, fracs);
+        fxp16_gemm(m, n, k, a, k, FXP16_Q11, b, n, FXP16_Q12, c, n, 0, fracs);
+
+        for (size_t i = 0; i < m*n; i++)
+        {
+            if (c[i] != cref[i]) mismatch++;
+        }
+
+        /* gemv: first column of B as vector, same fractional bits for all rows */
+        for (size_t p = 0; p < k; p++)
+        {
+            b[p] = b[p*n];
+        }
+
+        fxp16_gemv(m, k, a, k, FXP16_Q11, b, FXP16_Q12, y, FXP16_Q10, NULL);
+
+        for (size_t i = 0; i < m; i++)
+        {
+            fracs[i] = FXP16_Q10;
+        }
+
+        myunit_gemm_ref(m, 1, k, a, FXP16_Q11, b, FXP16_Q12, yref, fracs);
+
+        for (size_t i = 0; i < m; i++)
+        {
+            if (y[i] != yref[i]) mismatch++;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    }
+}
+
+
+#define MYUNIT_CPLX_EDGES   (9*9*9*9)                   /* all combinations of 9 edge values in 4 operands */
+#define MYUNIT_CPLX_N       (MYUNIT_CPLX_EDGES + 4096 + 8)  /* odd length exercises the vector tail */
+
+MYUNIT_TESTCASE(fxp16_complex)
+{
+    static const fxp16_t edge[] = {INT16_MIN, INT16_MIN+1, -16384, -1, 0, 1, 16384, INT16_MAX-1, INT16_MAX};
+    const size_t nedge = sizeof(edge)/sizeof(*edge);
+    const size_t n = MYUNIT_CPLX_N;
+
+    static fxp16_complex_t a[MYUNIT_CPLX_N], b[MYUNIT_CPLX_N], y[MYUNIT_CPLX_N], yref[MYUNIT_CPLX_N];
+    static fxp16_t re[MYUNIT_CPLX_N], im[MYUNIT_CPLX_N], bre[MYUNIT_CPLX_N], bim[MYUNIT_CPLX_N];
+    static fxp16_t yre[MYUNIT_CPLX_N], yim[MYUNIT_CPLX_N];
+    static fxp16_t mag[MYUNIT_CPLX_N], magref[MYUNIT_CPLX_N], arg[MYUNIT_CPLX_N];
+    uint32_t seed = 4711;
+    uint32_t mismatch = 0;
+    double maxerr = 0.0;
+
+    MYUNIT_ASSERT_EQUAL(nedge*nedge*nedge*nedge, MYUNIT_CPLX_EDGES);
+
+    /* all edge value combinations first, random values after */
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i < MYUNIT_CPLX_EDGES)
+        {
+            a[i].re = edge[i % nedge];
+            a[i].im = edge[(i / nedge) % nedge];
+            b[i].re = edge[(i / (nedge*nedge)) % nedge];
+            b[i].im = edge[i / (nedge*nedge*nedge)];
+        }
+        else
+        {
+            seed = seed * 1103515245u + 12345u; a[i].re = (fxp16_t)(seed >> 16);
+            seed = seed * 1103515245u + 12345u; a[i].im = (fxp16_t)(seed >> 16);
+            seed = seed * 1103515245u + 12345u; b[i].re = (fxp16_t)(seed >> 16);
+            seed = seed * 1103515245u + 12345u; b[i].im = (fxp16_t)(seed >> 16);
+        }
+
+        re[i] = a[i].re;
+        im[i] = a[i].im;
+        bre[i] = b[i].re;
+        bim[i] = b[i].im;
+    }
+
+    for (uint8_t frac = 0; frac <= FXP16_Q15; frac += 5)
+    {
+        MYUNIT_PRINTF("Processing frac %d ...\n", frac);
+
+        fxp16_cmul_vec(a, b, y, n, frac);
+        fxp16_cmul_vec_scalar(a, b, yref, n, frac);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            double scale = ldexp(1.0, -frac);
+            double dre = ((double)a[i].re * b[i].re - (double)a[i].im * b[i].im) * scale;
+            double dim = ((double)a[i].re * b[i].im + (double)a[i].im * b[i].re) * scale;
+            dre = fmin(fmax(dre, INT16_MIN), INT16_MAX);
+            dim = fmin(fmax(dim, INT16_MIN), INT16_MAX);
+
+            maxerr = fmax(maxerr, fmax(fabs(y[i].re - dre), fabs(y[i].im - dim)));
+            if (y[i].re != yref[i].re || y[i].im != yref[i].im) mismatch++;
+        }
+
+        /* in place on the multiplicator */
+        memcpy(yref, a, sizeof(a));
+        fxp16_cmul_vec(yref, b, yref, n, frac);
+        if (memcmp(yref, y, sizeof(y)) != 0) mismatch++;
+
+        fxp16_cmul_soa(re, im, bre, bim, yre, yim, n, frac);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (yre[i] != y[i].re || yim[i] != y[i].im) mismatch++;
+        }
+
+        for (size_t len = 0; len < 40; len += 13)
+        {
+            fxp16_complex_t acc = {1234, -4321};
+            int64_t sr = (int64_t)acc.re * ((int64_t)1 << frac), si = (int64_t)acc.im * ((int64_t)1 << frac);
+
+            for (size_t i = 0; i < len; i++)
+            {
+                sr += (int64_t)a[n-1-i].re * b[n-1-i].re - (int64_t)a[n-1-i].im * b[n-1-i].im;
+                si += (int64_t)a[n-1-i].re * b[n-1-i].im + (int64_t)a[n-1-i].im * b[n-1-i].re;
+            }
+
+            fpxx_arshift_m(sr, frac);
+            fpxx_arshift_m(si, frac);
+            fxp16_sat_m(sr);
+            fxp16_sat_m(si);
+
+            fxp16_complex_t r = fxp16_cmac(acc, a + n - len, b + n - len, len, frac);
+            if (r.re != sr || r.im != si) mismatch++;
+        }
+    }
+
+    /* single fxp32_arshift rounding: below 1 LSB (negative halves round down) */
+    MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    MYUNIT_ASSERT_INRANGE(maxerr, 0.0, 1.0);
+
+    /* edge products accumulate without intermediate rounding or saturation */
+    {
+        fxp16_complex_t acc = {0, 0};
+        fxp16_complex_t r = fxp16_cmac(acc, a, b, n, FXP16_Q15);
+        fxp16_complex_t rsoa = fxp16_cmac_soa(acc, re, im, bre, bim, n, FXP16_Q15);
+        MYUNIT_ASSERT_EQUAL(r.re, rsoa.re);
+        MYUNIT_ASSERT_EQUAL(r.im, rsoa.im);
+    }
+
+    fxp16_cmag_vec(a, mag, n);
+    fxp16_cmag_vec_scalar(a, magref, n);
+    fxp16_carg_vec(a, arg, n);
+
+    mismatch = 0;
+    maxerr = 0.0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double dmag = fmin(hypot(a[i].re, a[i].im), INT16_MAX);
+
+        maxerr = fmax(maxerr, fabs(mag[i] - dmag));
+        if (mag[i] != magref[i]) mismatch++;
+        if (arg[i] != fxp16_atan2(a[i].im, a[i].re)) mismatch++;
+    }
+
+    fxp16_cmag_soa(re, im, magref, n);
+    if (memcmp(mag, magref, sizeof(mag)) != 0) mismatch++;
+
+    fxp16_carg_soa(re, im, magref, n);
+    if (memcmp(arg, magref, sizeof(arg)) != 0) mismatch++;
+
+    MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    /* the documented bound of fxp16_cmag(); a few inputs land just above 0.5 LSB */
+    MYUNIT_PRINTF("cmag max. error %f LSB\n", maxerr);
+    MYUNIT_ASSERT_INRANGE(maxerr, 0.0, 1.0);
+    MYUNIT_ASSERT_EQUAL(fxp16_conj(a[0]).im, INT16_MAX);
+}
+
+
+MYUNIT_TESTCASE(fxp16_bfp)
+{
+    static const int scales[] = {0, 1, 7, 12, 15};      /* magnitude of the test data: 2^scale */
+    const size_t n = 1000 + 3;      /* odd length exercises the vector tail */
+
+    static fxp16_t xa[1003], xb[1003], ma[1003], mb[1003], my[1003], back[1003];
+    fxp16_bfp_t a, b, y;
+    uint32_t seed = 815;
+    uint32_t mismatch = 0;
+    double maxerr = 0.0;
+
+    fxp16_bfp_init(&a, ma, n);
+    fxp16_bfp_init(&b, mb, n);
+    fxp16_bfp_init(&y, my, n);
+
+    for (size_t sa = 0; sa < sizeof(scales)/sizeof(*scales); sa++)
+    {
+        for (size_t sb = 0; sb < sizeof(scales)/sizeof(*scales); sb++)
+        {
+            int hmax = 0;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                xa[i] = (fxp16_t)((int32_t)(seed >> 8) % (1 << scales[sa]));
+                seed = seed * 1103515245u + 12345u;
+                xb[i] = (fxp16_t)((int32_t)(seed >> 8) % (1 << scales[sb]));
+            }
+            xa[n-1] = (scales[sa] == 15) ? INT16_MIN : xa[n-1];
+
+            /* headroom against a per element reference */
+            for (size_t i = 0; i < n; i++)
+            {
+                int bits = 0;
+                while (bits < 15 && (xa[i] >> bits) != 0 && (xa[i] >> bits) != -1) bits++;
+                if (bits > hmax) hmax = bits;
+            }
+            if (fxp16_headroom_vec(xa, n) != 15 - hmax) mismatch++;
+            if (fxp16_kernels()->signmag_or(xa, n) != fxp16_signmag_or_scalar(xa, n)) mismatch++;
+
+            /* lossless round trip through a normalized block */
+            fxp16_bfp_from_fxp(&a, xa, FXP16_Q8);
+            fxp16_bfp_from_fxp(&b, xb, FXP16_Q12);
+            fxp16_bfp_denormalize(&a, back, FXP16_Q8);
+            if (memcmp(back, xa, sizeof(xa)) != 0) mismatch++;
+            if (scales[sa] > 0 && fxp16_headroom_vec(a.m, n) != 0) mismatch++;
+
+            fxp16_bfp_add(&a, &b, &y);
+            for (size_t i = 0; i < n; i++)
+            {
+                double ref = ldexp(xa[i], -FXP16_Q8) + ldexp(xb[i], -FXP16_Q12);
+                maxerr = fmax(maxerr, fabs(ldexp(y.m[i], y.exp) - ref) / ldexp(1.0, y.exp));
+            }
+
+            fxp16_bfp_mult(&a, &b, &y);
+            for (size_t i = 0; i < n; i++)
+            {
+                double ref = ldexp(xa[i], -FXP16_Q8) * ldexp(xb[i], -FXP16_Q12);
+                maxerr = fmax(maxerr, fabs(ldexp(y.m[i], y.exp) - ref) / ldexp(1.0, y.exp));
+            }
+
+            {
+                int exp;
+                double ref = 0.0;
+                fxp16_t d = fxp16_bfp_dot(&a, &b, &exp);
+
+                for (size_t i = 0; i < n; i++)
+                {
+                    ref += ldexp(xa[i], -FXP16_Q8) * ldexp(xb[i], -FXP16_Q12);
+                }
+                maxerr = fmax(maxerr, fabs(ldexp(d, exp) - ref) / ldexp(1.0, exp));
+            }
+
+            /* aliasing output and operand */
+            fxp16_bfp_mult(&a, &b, &y);
+            memcpy(back, y.m, sizeof(back));
+            fxp16_bfp_mult(&a, &b, &a);
+            if (memcmp(back, a.m, sizeof(back)) != 0 || a.exp != y.exp) mismatch++;
+        }
+    }
+
+    MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    MYUNIT_ASSERT_INRANGE(maxerr, 0.0, 1.0);
+
+    /* a maximum that rounds up to 2^15 takes one more bit instead of saturating */
+    {
+        fxp16_t m1[1] = { 32766 }, m2[1] = { 16385 }, m3[1];
+        fxp16_bfp_t b1, b2, b3;
+        int exp;
+
+        fxp16_bfp_init(&b1, m1, 1);
+        fxp16_bfp_init(&b2, m2, 1);
+        fxp16_bfp_init(&b3, m3, 1);
+
+        fxp16_bfp_mult(&b1, &b2, &b3);      /* 536870910 */
+        MYUNIT_ASSERT_EQUAL(m3[0], 16384);
+        MYUNIT_ASSERT_EQUAL(b3.exp, 15);
+        MYUNIT_ASSERT_EQUAL(fxp16_bfp_dot(&b1, &b2, &exp), 16384);
+        MYUNIT_ASSERT_EQUAL(exp, 15);
+
+        m1[0] = 32767;                      /* 32767 + 0.5 */
+        m2[0] = 1;
+        b2.exp = -1;
+        fxp16_bfp_add(&b1, &b2, &b3);
+        MYUNIT_ASSERT_EQUAL(m3[0], 16384);
+        MYUNIT_ASSERT_EQUAL(b3.exp, 1);
+
+        /* all zero: the exponent does not drift */
+        m1[0] = 0;
+        b1.exp = -3;
+        fxp16_bfp_normalize(&b1);
+        fxp16_bfp_normalize(&b1);
+        MYUNIT_ASSERT_EQUAL(b1.exp, -3);
+        fxp16_bfp_from_fxp(&b1, m1, FXP16_Q12);
+        MYUNIT_ASSERT_EQUAL(b1.exp, -FXP16_Q12);
+    }
+}
+
+
+MYUNIT_TESTCASE(fxp16_flt2fp_vec)
+{
+    const size_t n = 4 * 65536 + 1000 + 5;     /* odd length exercises the vector tail */
+
+    static float  xf[4*65536+1005], yf[4*65536+1005];
+    static double xd[4*65536+1005], yd[4*65536+1005];
+    static fxp16_t y[4*65536+1005], yref[4*65536+1005];
+    uint32_t seed = 2024;
+
+    for (uint8_t frac = 0; frac <= FXP16_Q15; frac += 5)
+    {
+        uint32_t mismatch = 0;
+        size_t k = 0;
+
+        MYUNIT_PRINTF("Processing frac %d ...\n", frac);
+
+        /* every representable value, the rounding ties around it and their neighbours */
+        for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+        {
+            double tie = ldexp(v + 0.5, -frac);
+            xd[k] = ldexp(v, -frac);     xf[k++] = (float)ldexp(v, -frac);
+            xd[k] = tie;                 xf[k++] = (float)tie;
+            xd[k] = nextafter(tie, 0.0); xf[k++] = nextafterf((float)tie, 0.0f);
+            xd[k] = nextafter(tie, 1e9); xf[k++] = nextafterf((float)tie, 1e9f);
+        }
+
+        /* special values and random bit patterns */
+        for (; k < n; k++)
+        {
+            uint32_t bits;
+            uint64_t dbits;
+
+            seed = seed * 1103515245u + 12345u;
+            bits = seed;
+            memcpy(&xf[k], &bits, sizeof(bits));
+            dbits = ((uint64_t)bits << 32) | (seed * 2654435761u);
+            memcpy(&xd[k], &dbits, sizeof(dbits));
+        }
+        xf[n-1] = INFINITY;  xd[n-1] = INFINITY;
+        xf[n-2] = -INFINITY; xd[n-2] = -INFINITY;
+        xf[n-3] = NAN;       xd[n-3] = NAN;
+        xf[n-4] = -0.0f;     xd[n-4] = -0.0;
+        xf[n-5] = 1e30f;     xd[n-5] = -1e300;
+
+        fxp16_flt2fp_vec(xf, y, n, frac);
+        for (size_t i = 0; i < n; i++)
+        {
+            fxp16_t ref = isnan(xf[i]) ? 0 : fxp16_flt2fp(xf[i], frac);
+            if (y[i] != ref) mismatch++;
+        }
+
+        fxp16_dbl2fp_vec(xd, yref, n, frac);
+        for (size_t i = 0; i < n; i++)
+        {
+            fxp16_t ref = isnan(xd[i]) ? 0 : fxp16_dbl2fp(xd[i], frac);
+            if (yref[i] != ref) mismatch++;
+        }
+
+        fxp16_fp2flt_vec(y, yf, n, frac);
+        fxp16_fp2dbl_vec(yref, yd, n, frac);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (yf[i] != fxp16_fp2flt(y[i], frac)) mismatch++;
+            if (yd[i] != fxp16_fp2dbl(yref[i], frac)) mismatch++;
+        }
+
+        MYUNIT_ASSERT_EQUAL(mismatch, 0);
+    }
+}
+
+
+MYUNIT_TESTCASE(fxp16_fp2fp_vec)
+{
+    const size_t n = 65536 + 7;     /* odd length exercises the vector tail */
+
+    static fxp16_t x[65536+7], y[65536+7];
+    static fxp32_t x32[65536+7];
+    uint32_t seed = 99;
+    uint32_t mismatch = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = (fxp16_t)(INT16_MIN + (int32_t)(i & 0xFFFF));
+        seed = seed * 1103515245u + 12345u;
+        /* spread the magnitudes over the whole 32 bit range */
+        x32[i] = (fxp32_t)(seed ^ (seed << 13)) >> (seed >> 27);
+    }
+    x32[0] = INT32_MIN; x32[1] = INT32_MAX; x32[2] = -1; x32[3] = 0;
+
+    for (uint8_t fracold = 0; fracold <= FXP16_Q15; fracold++)
+    {
+        for (uint8_t fracnew = 0; fracnew <= FXP16_Q15; fracnew++)
+        {
+            fxp16_fp2fp_vec(x, y, n, fracold, fracnew);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                if (y[i] != fxp16_fp2fp(x[i], fracold, fracnew)) mismatch++;
+            }
+
+            /* in place gives the same result */
+            memcpy(y, x, sizeof(x));
+            fxp16_fp2fp_vec(y, y, n, fracold, fracnew);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                if (y[i] != fxp16_fp2fp(x[i], fracold, fracnew)) mismatch++;
+            }
+        }
+    }
+
+    MYUNIT_ASSERT_EQUAL(mismatch, 0);
+
+    for (uint8_t fracold = 0; fracold <= 31; fracold += 3)
+    {
+        for (uint8_t fracnew = 0; fracnew <= 31; fracnew += 2)
+        {
+            int shift = (int)fracold - fracnew;
+
+            fxp16_narrow_vec(x32, y, n, fracold, fracnew);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                int64_t ref = x32[i];
+
+                if (shift > 0)
+                {
+                    ref = fxp32_arshift(x32[i], shift);
+                }
+                else
+                {
+                    ref *= (int64_t)1 << -shift;
+                }
+                fxp16_sat_m(ref);
+
+                if (y[i] != ref) mismatch++;
+            }
+        }
+    }
+
+    MYUNIT_ASSERT_EQUAL(mismatch, 0);
+}
+
+
+#if FXP16CONF_STATUS_FLAGS
+#include <pthread.h>
+
+static void *myunit_status_thread(void *arg)
+{
+    (void)arg;
+    fxp16_add(INT16_MAX, 1);
+    return (void *)(uintptr_t)fxp16_status_get_and_clear();
+}
+#endif
+
+MYUNIT_TESTCASE(fxp16_status)
+{
+    fxp16_status_get_and_clear();
+
+#if FXP16CONF_STATUS_FLAGS
+    static fxp16_t x[100], y[100];
+    pthread_t tid;
+    void *other;
+
+    fxp16_add(INT16_MAX, 1);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), FXP16_STATUS_OVERFLOW);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), 0);
+
+    fxp16_mult(1, FXP16_Q15, 1, FXP16_Q15);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get(), FXP16_STATUS_UNDERFLOW);
+
+    /* sticky: flags accumulate until cleared */
+    MYUNIT_ASSERT_EQUAL(fxp16_div(-5, FXP16_Q8, 0, FXP16_Q8), INT16_MIN);
+    fxp16_fmod(5, FXP16_Q8, 0, FXP16_Q8);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(),
+                        (FXP16_STATUS_UNDERFLOW | FXP16_STATUS_DIVBYZERO | FXP16_STATUS_DOMAIN));
+
+    /* in range results never raise flags, internal guard clamps are silent */
+    for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+    {
+        fxp16_sin((fxp16_t)v);
+        fxp16_cos((fxp16_t)v);
+        fxp16_fp2fp((fxp16_t)v, FXP16_Q8, FXP16_Q8);
+    }
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), 0);
+
+    /* batched kernels report every element */
+    for (int i = 0; i < 100; i++) x[i] = (fxp16_t)(i - 50);
+    x[77] = 20000;
+    fxp16_fp2fp_vec(x, y, 100, FXP16_Q8, FXP16_Q9);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), FXP16_STATUS_OVERFLOW);
+
+    /* flags are per thread */
+    pthread_create(&tid, NULL, myunit_status_thread, NULL);
+    pthread_join(tid, &other);
+    MYUNIT_ASSERT_EQUAL((uintptr_t)other, FXP16_STATUS_OVERFLOW);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), 0);
+#else
+    fxp16_add(INT16_MAX, 1);
+    MYUNIT_ASSERT_EQUAL(fxp16_status_get_and_clear(), 0);
+#endif
+}
+
+
+#if FXP16CONF_STATS
+#include <pthread.h>
+
+static void *myunit_stats_thread(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < 10; i++) fxp16_add(INT16_MAX, 1);
+    return NULL;
+}
+#endif
+
+MYUNIT_TESTCASE(fxp16_stats)
+{
+    static fxp16_stats_t st[FXP16_STATS_COUNT];
+
+    fxp16_stats_reset();
+
+#if FXP16CONF_STATS
+    pthread_t tid;
+
+    MYUNIT_ASSERT_EQUAL(strcmp(fxp16_stats_name(FXP16_STATS_atan2), "atan2"), 0);
+
+    fxp16_add(INT16_MAX, 1);
+    fxp16_add(1, 1);
+    fxp16_tan(FXP16_Q15_ONE_HALF, FXP16_Q15);     /* +pi/2 */
+    fxp16_stats_get(st);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].calls, 2);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].saturations, 1);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].early_exits, 0);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_tan].calls, 1);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_tan].early_exits, 1);
+
+    /* nested calls are counted and own the events raised inside them */
+    fxp16_asin(0);
+    fxp16_stats_get(st);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_asin].calls, 1);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_asin].early_exits, 0);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_sqrt].calls, 1);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_atan2].calls, 1);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_atan2].early_exits, 1);
+
+    /* counters of other threads are aggregated, also after they exit */
+    pthread_create(&tid, NULL, myunit_stats_thread, NULL);
+    pthread_join(tid, NULL);
+    fxp16_stats_get(st);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].calls, 12);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].saturations, 11);
+
+    fxp16_stats_reset();
+    fxp16_stats_get(st);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].calls, 0);
+#else
+    fxp16_add(INT16_MAX, 1);
+    fxp16_stats_get(st);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].calls, 0);
+    MYUNIT_ASSERT_EQUAL(st[FXP16_STATS_add].saturations, 0);
+#endif
+}
+
+
+MYUNIT_TESTCASE(fxp16_lut)
+{
+    static fxp16_t lut[FXP16_LUT_ENTRIES];
+    static fxp16_t x[FXP16_LUT_SIZE + 7], y[FXP16_LUT_SIZE + 7];
+    const fxp16_lut_q_t q = { FXP16_Q12, FXP16_Q15 };
+    char line[64];
+    int errors = 0;
+    FILE *f;
+
+    /* bit-identical to the computing path over the full domain */
+    fxp16_lut_build(lut, fxp16_lut_sin, NULL);
+    for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+    {
+        errors += fxp16_lut_lookup(lut, (fxp16_t)v) != fxp16_sin((fxp16_t)v);
+    }
+    MYUNIT_ASSERT_EQUAL(errors, 0);
+
+    /* gather: every index incl. -1 (last entry, pad read), odd tail */
+    fxp16_lut_build(lut, fxp16_lut_tanh, &q);
+    for (size_t i = 0; i < sizeof(x) / sizeof(x[0]); i++)
+    {
+        x[i] = (fxp16_t)(INT16_MAX - (int32_t)i);
+    }
+    fxp16_lut_gather(lut, x, y, sizeof(x) / sizeof(x[0]));
+    for (size_t i = 0; i < sizeof(x) / sizeof(x[0]); i++)
+    {
+        errors += y[i] != fxp16_tanh(FXP16_Q15, x[i], FXP16_Q12);
+    }
+    MYUNIT_ASSERT_EQUAL(errors, 0);
+
+    /* in place */
+    fxp16_lut_gather(lut, x, x, sizeof(x) / sizeof(x[0]));
+    MYUNIT_ASSERT_EQUAL(memcmp(x, y, sizeof(x)), 0);
+
+    /* generator output */
+    f = tmpfile();
+    MYUNIT_ASSERT_EQUAL((f != NULL), 1);
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_write_c(f, "tanh_q12_q15", lut), 0);
+    rewind(f);
+    MYUNIT_ASSERT_EQUAL((fgets(line, sizeof(line), f) != NULL), 1);
+    MYUNIT_ASSERT_EQUAL(strcmp(line, "const fxp16_t tanh_q12_q15[FXP16_LUT_ENTRIES] = {\n"), 0);
+    MYUNIT_ASSERT_EQUAL(fscanf(f, "%d", &errors), 1);
+    MYUNIT_ASSERT_EQUAL(errors, lut[0]);
+    fclose(f);
+}
+
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <pthread.h>
+
+static fxp16_t myunit_lut_file_table[FXP16_LUT_ENTRIES];
+
+/* writes the same table to the same path a few times */
+static void *myunit_lut_file_writer(void *arg)
+{
+    const fxp16_lut_q_t q8 = { FXP16_Q8, FXP16_Q8 };
+    intptr_t errors = 0;
+
+    for (int i = 0; i < 32; i++)
+    {
+        errors += fxp16_lut_file_write((const char *)arg, FXP16_LUT_ID_SQRT, &q8, myunit_lut_file_table) != 0;
+    }
+    return (void *)errors;
+}
+#endif
+
+MYUNIT_TESTCASE(fxp16_lut_file)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    const fxp16_lut_q_t q8 = { FXP16_Q8, FXP16_Q8 }, q9 = { FXP16_Q9, FXP16_Q9 };
+    fxp16_lut_map_t map, other;
+    char path[64];
+    int errors = 0;
+    FILE *f;
+
+    snprintf(path, sizeof(path), "/tmp/myunit_fxp16_lut_%ld.bin", (long)getpid());
+    unlink(path);
+
+    /* missing file: built, written, mapped */
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_open(&map, path, FXP16_LUT_ID_SQRT, NULL, &q8), 0);
+    MYUNIT_ASSERT_EQUAL(map.size, sizeof(fxp16_lut_file_header_t) + FXP16_LUT_ENTRIES * sizeof(fxp16_t));
+    for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+    {
+        errors += fxp16_lut_lookup(map.lut, (fxp16_t)v) != fxp16_sqrt((fxp16_t)v, FXP16_Q8);
+    }
+    MYUNIT_ASSERT_EQUAL(errors, 0);
+
+    /* existing file is mapped as is, header must match the request */
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_map(&other, path, FXP16_LUT_ID_SQRT, &q8), 0);
+    MYUNIT_ASSERT_EQUAL(memcmp(other.lut, map.lut, FXP16_LUT_ENTRIES * sizeof(fxp16_t)), 0);
+    fxp16_lut_file_close(&other);
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_map(&other, path, FXP16_LUT_ID_SQRT, &q9), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_map(&other, path, FXP16_LUT_ID_CBRT, &q8), -1);
+    MYUNIT_ASSERT_EQUAL((other.lut == NULL), 1);
+    fxp16_lut_file_close(&map);
+
+    /* a corrupted entry fails the checksum and is rebuilt */
+    f = fopen(path, "r+b");
+    fseek(f, sizeof(fxp16_lut_file_header_t) + 1000, SEEK_SET);
+    fputc(0x55, f);
+    fclose(f);
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_map(&map, path, FXP16_LUT_ID_SQRT, &q8), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_open(&map, path, FXP16_LUT_ID_SQRT, NULL, &q8), 0);
+    MYUNIT_ASSERT_EQUAL(map.lut[500], fxp16_sqrt(500, FXP16_Q8));
+    fxp16_lut_file_close(&map);
+
+    /* writers in threads of one process each use their own temporary file */
+    {
+        pthread_t tid[4];
+        void *ret;
+
+        fxp16_lut_build(myunit_lut_file_table, fxp16_lut_sqrt, &q8);
+        for (int t = 0; t < 4; t++)
+        {
+            pthread_create(&tid[t], NULL, myunit_lut_file_writer, path);
+        }
+        for (int t = 0; t < 4; t++)
+        {
+            pthread_join(tid[t], &ret);
+            errors += (int)(intptr_t)ret;
+        }
+        MYUNIT_ASSERT_EQUAL(errors, 0);
+        MYUNIT_ASSERT_EQUAL(fxp16_lut_file_map(&map, path, FXP16_LUT_ID_SQRT, &q8), 0);
+        fxp16_lut_file_close(&map);
+    }
+
+    /* unwritable location: heap fallback */
+    MYUNIT_ASSERT_EQUAL(fxp16_lut_file_open(&map, "/nonexistent/dir/lut.bin", FXP16_LUT_ID_SIN, NULL, NULL), 0);
+    MYUNIT_ASSERT_EQUAL(map.size, 0);
+    MYUNIT_ASSERT_EQUAL(map.lut[1000], fxp16_sin(1000));
+    fxp16_lut_file_close(&map);
+
+    unlink(path);
+#endif
+}
+
+
+MYUNIT_TESTCASE(fxp16_diff)
+{
+    /* every fast path against its scalar reference: all 16 bit inputs, 64k samples per binary config */
+    MYUNIT_ASSERT_EQUAL(fxp16_diff_run(8, 65536, 0x5EEDull, NULL), 0);
+
+    /* single input entry point of the fuzzer */
+    for (unsigned cfg = 0; cfg < 512; cfg++)
+    {
+        MYUNIT_ASSERT_EQUAL(fxp16_diff_check_one(0x80007FFFu, 0xFFFF8000u, cfg, NULL), 0);
+    }
+}
+
+
+MYUNIT_TESTCASE(fxp16_dispatch)
+{
+    fxp16_isa_t cpu = fxp16_dispatch_cpu();
+    fxp16_isa_t best;
+
+    fxp16_dispatch_reset();
+    best = fxp16_dispatch_selected();
+    MYUNIT_ASSERT_EQUAL((best <= cpu), 1);
+    MYUNIT_ASSERT_EQUAL(strcmp(fxp16_isa_name(FXP16_ISA_AVX2), "avx2"), 0);
+    MYUNIT_ASSERT_EQUAL(strcmp(fxp16_isa_name(FXP16_ISA_COUNT), "?"), 0);
+
+    /* every implementation the CPU can run matches the scalar references */
+    for (int isa = 0; isa < FXP16_ISA_COUNT; isa++)
+    {
+        if (fxp16_dispatch_force((fxp16_isa_t)isa) != 0)
+        {
+            MYUNIT_ASSERT_EQUAL((isa != FXP16_ISA_SCALAR), 1);
+            continue;
+        }
+
+        MYUNIT_ASSERT_EQUAL((int)fxp16_dispatch_selected(), isa);
+        MYUNIT_ASSERT_EQUAL(fxp16_diff_run(1, 4096, isa, NULL), 0);
+    }
+
+    /* environment cap */
+    setenv(FXP16_DISPATCH_ENV, "scalar", 1);
+    fxp16_dispatch_reset();
+    MYUNIT_ASSERT_EQUAL(fxp16_dispatch_selected(), FXP16_ISA_SCALAR);
+    unsetenv(FXP16_DISPATCH_ENV);
+    fxp16_dispatch_reset();
+    MYUNIT_ASSERT_EQUAL(fxp16_dispatch_selected(), best);
+}
+
+MYUNIT_TESTCASE(fxp16_wrap)
+{
+    static const struct { uint8_t xfrac; fxp16_t y; uint8_t yfrac; } div[] = {
+        { 12, FXP16_Q12_M_TWOPI, 12 }, { 8, -3, 0 }, { 15, 16384, 15 }, { 0, 7, 0 },
+        { 10, INT16_MIN, 15 }, { 15, 1, 15 }, { 4, 32767, 2 },
+    };
+    static fxp16_t phase[1000];
+    static fxp32_t out[1000];
+    fxp16_fmod_const_t c;
+    fxp16_unwrap_t st = FXP16_UNWRAP_INIT;
+    int bad = 0;
+
+    /* constant divisor: bit-identical to fxp16_fmod over the whole input range */
+    MYUNIT_ASSERT_EQUAL(fxp16_fmod_const_init(&c, 15, 0, 15), -1);
+    for (size_t k = 0; k < sizeof(div) / sizeof(div[0]); k++)
+    {
+        MYUNIT_ASSERT_EQUAL(fxp16_fmod_const_init(&c, div[k].xfrac, div[k].y, div[k].yfrac), 0);
+        for (int32_t x = INT16_MIN; x <= INT16_MAX; x++)
+        {
+            bad += fxp16_fmod_const((fxp16_t)x, &c) != fxp16_fmod((fxp16_t)x, div[k].xfrac, div[k].y, div[k].yfrac);
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    MYUNIT_ASSERT_EQUAL(fxp16_wrap_pi(32768), INT16_MIN);
+    MYUNIT_ASSERT_EQUAL(fxp16_wrap_pi(-32769), INT16_MAX);
+    MYUNIT_ASSERT_EQUAL(fxp16_wrap_pi(3 * 65536 + 5), 5);
+    MYUNIT_ASSERT_EQUAL(fxp16_wrap_pi(-12345), -12345);
+
+    /* wrapped ramps unwrap exactly, also across calls */
+    for (int step = -12345; step <= 12345; step += 24690)
+    {
+        for (int i = 0; i < 1000; i++) phase[i] = fxp16_wrap_pi(100 + (fxp32_t)i * step);
+
+        st = (fxp16_unwrap_t)FXP16_UNWRAP_INIT;
+        fxp16_unwrap_vec(&st, phase, out, 300);
+        fxp16_unwrap_vec(&st, phase + 300, out + 300, 700);
+
+        bad = 0;
+        for (int i = 0; i < 1000; i++) bad += out[i] != 100 + (fxp32_t)i * step;
+        MYUNIT_ASSERT_EQUAL(bad, 0);
+        MYUNIT_ASSERT_EQUAL(st.acc, out[999]);
+    }
+
+    /* angles of a rotating vector: unwrapped phase follows the rotation */
+    for (int i = 0; i < 1000; i++)
+    {
+        fxp16_t theta = fxp16_wrap_pi((fxp32_t)i * 1000);
+        phase[i] = fxp16_atan2(fxp16_sin(theta) / 2, fxp16_cos(theta) / 2);
+    }
+    st = (fxp16_unwrap_t)FXP16_UNWRAP_INIT;
+    fxp16_unwrap_vec(&st, phase, out, 1000);
+
+    bad = 0;
+    for (int i = 0; i < 1000; i++) bad += abs(out[i] - (fxp32_t)i * 1000) > 16;
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+}
+
+MYUNIT_TESTCASE(fxp16_round_vec)
+{
+    /* -2.5 -1.5 -0.5 0.5 1.5 2.5 in Q8, then values that saturate or are not halfway */
+    static const fxp16_t x[10] = { -640, -384, -128, 128, 384, 640, INT16_MAX, INT16_MIN, 200, -200 };
+    static const fxp16_t expect[5][10] = {
+        { -768, -512, -256, 256, 512, 768, INT16_MAX, INT16_MIN, 256, -256 },  /* nearest, away */
+        { -512, -512,    0,   0, 512, 512, INT16_MAX, INT16_MIN, 256, -256 },  /* nearest, even */
+        { -768, -512, -256,   0, 256, 512,     32512, INT16_MIN,   0, -256 },  /* floor */
+        { -512, -256,    0, 256, 512, 768, INT16_MAX, INT16_MIN, 256,    0 },  /* ceil */
+        { -512, -256,    0,   0, 256, 512,     32512, INT16_MIN,   0,    0 },  /* trunc */
+    };
+    fxp16_t y[10];
+    int bad = 0;
+    int q;
+
+    for (int m = 0; m < 5; m++)
+    {
+        fxp16_round_vec(x, y, 10, FXP16_Q8, (fxp16_round_mode_t)m);
+        for (int i = 0; i < 10; i++) bad += y[i] != expect[m][i];
+
+        fxp16_lround_vec(x, y, 10, FXP16_Q8, (fxp16_round_mode_t)m);
+        for (int i = 0; i < 10; i++) bad += y[i] != ((expect[m][i] == INT16_MAX) ? 128 : expect[m][i] / 256);
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* the scalar forms agree with the array modes */
+    MYUNIT_ASSERT_EQUAL(fxp16_rint(-384, FXP16_Q8), -512);
+    MYUNIT_ASSERT_EQUAL(fxp16_nearbyint(640, FXP16_Q8), 512);
+    MYUNIT_ASSERT_EQUAL(fxp16_round(640, FXP16_Q8), 768);
+    MYUNIT_ASSERT_EQUAL(fxp16_lround(-640, FXP16_Q8), -3);
+    MYUNIT_ASSERT_EQUAL(fxp16_rint(12345, FXP16_Q0), 12345);
+
+    /* remainder: quotient rounded to nearest even */
+    MYUNIT_ASSERT_EQUAL(fxp16_remquo(5 << 8, FXP16_Q8, 2 << 8, FXP16_Q8, &q), 1 << 8);
+    MYUNIT_ASSERT_EQUAL(q, 2);
+    MYUNIT_ASSERT_EQUAL(fxp16_remquo(7 << 8, FXP16_Q8, 2 << 8, FXP16_Q8, &q), -(1 << 8));
+    MYUNIT_ASSERT_EQUAL(q, 4);
+    MYUNIT_ASSERT_EQUAL(fxp16_remquo(-(7 << 8), FXP16_Q8, 2 << 8, FXP16_Q8, &q), 1 << 8);
+    MYUNIT_ASSERT_EQUAL(q, -4);
+    MYUNIT_ASSERT_EQUAL(fxp16_remainder(FXP16_Q12_M_TWOPI - 100, FXP16_Q12, FXP16_Q12_M_TWOPI, FXP16_Q12), -100);
+    MYUNIT_ASSERT_EQUAL(fxp16_fmod(FXP16_Q12_M_TWOPI - 100, FXP16_Q12, FXP16_Q12_M_TWOPI, FXP16_Q12), FXP16_Q12_M_TWOPI - 100);
+
+    /* array form, in place, against the scalar one */
+    {
+        fxp16_t v[37], ref[37];
+        int quo[37];
+
+        for (int i = 0; i < 37; i++) v[i] = (fxp16_t)(i * 1771 - 32000);
+        for (int i = 0; i < 37; i++) ref[i] = fxp16_remainder(v[i], FXP16_Q10, 1000, FXP16_Q8);
+        fxp16_remquo_vec(v, v, quo, 37, FXP16_Q10, 1000, FXP16_Q8);
+
+        bad = 0;
+        for (int i = 0; i < 37; i++) bad += v[i] != ref[i];
+        MYUNIT_ASSERT_EQUAL(bad, 0);
+    }
+
+    MYUNIT_ASSERT_EQUAL(fxp16_remainder(100, FXP16_Q8, 0, FXP16_Q8), 0);
+}
+
+MYUNIT_TESTCASE(fxp16_round_mode)
+{
+    fxp16_rng_t rng;
+    int64_t sum[FXP16_ROUND_STOCHASTIC + 1] = { 0 };
+    long ones = 0;
+
+    fxp16_rng_seed(&rng, 1234);
+
+    /* -1.5 LSB */
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_NEAREST_AWAY, NULL), -2);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_NEAREST_EVEN, NULL), -2);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_FLOOR, NULL), -2);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_CEIL, NULL), -1);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_TRUNC, NULL), -1);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-3, 1, FXP16_ROUND_HALF_UP, NULL), -1);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(INT32_MAX, 31, FXP16_ROUND_CEIL, NULL), 1);
+    MYUNIT_ASSERT_EQUAL(fxp32_arshift_mode(-7, 0, FXP16_ROUND_STOCHASTIC, &rng), -7);
+
+    /* -0.5 * 3 LSB in Q15 and -1.5 converted from Q4 to Q0 */
+    MYUNIT_ASSERT_EQUAL(fxp16_mult_mode(-3, FXP16_Q15, 16384, FXP16_Q15, FXP16_ROUND_NEAREST_EVEN, NULL), -2);
+    MYUNIT_ASSERT_EQUAL(fxp16_mult_mode(-3, FXP16_Q15, 16384, FXP16_Q15, FXP16_ROUND_TRUNC, NULL), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_mult_mode(INT16_MIN, FXP16_Q15, INT16_MIN, FXP16_Q15, FXP16_ROUND_FLOOR, NULL), INT16_MAX);
+    MYUNIT_ASSERT_EQUAL(fxp16_fp2fp_mode(-24, FXP16_Q4, FXP16_Q0, FXP16_ROUND_NEAREST_EVEN, NULL), -2);
+    MYUNIT_ASSERT_EQUAL(fxp16_fp2fp_mode(-24, FXP16_Q4, FXP16_Q0, FXP16_ROUND_HALF_UP, NULL), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_fp2fp_mode(-24, FXP16_Q4, FXP16_Q8, FXP16_ROUND_FLOOR, NULL), fxp16_fp2fp(-24, FXP16_Q4, FXP16_Q8));
+
+    /* the deterministic modes agree with the library wide rounding where it is defined */
+    for (int32_t v = 0; v <= INT16_MAX; v += 7)
+    {
+        if (fxp32_arshift_mode(v, 5, FXP16_ROUND_HALF_UP, NULL) != fxp32_arshift(v, 5)) sum[0]++;
+        if (fxp32_arshift_mode(-v, 5, FXP16_ROUND_FLOOR, NULL) != (-v >> 5)) sum[0]++;
+    }
+    MYUNIT_ASSERT_EQUAL(sum[0], 0);
+
+    /* summed rounding error over the whole fxp16 range, in 1/16 LSB */
+    sum[0] = 0;
+    for (int32_t v = INT16_MIN; v <= INT16_MAX; v++)
+    {
+        for (int m = 0; m <= FXP16_ROUND_STOCHASTIC; m++)
+        {
+            sum[m] += fxp32_arshift_mode(v, 4, (fxp16_round_mode_t)m, &rng) * 16 - v;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(sum[FXP16_ROUND_NEAREST_EVEN], 0);
+    MYUNIT_ASSERT_EQUAL(sum[FXP16_ROUND_HALF_UP], 32768);
+    MYUNIT_ASSERT_EQUAL(sum[FXP16_ROUND_FLOOR], -491520);
+    MYUNIT_ASSERT_EQUAL((llabs(sum[FXP16_ROUND_STOCHASTIC]) < 16384), 1);
+
+    /* stochastic rounding keeps signals below one LSB: 0.25 LSB rounds up a quarter of the time */
+    for (int i = 0; i < 100000; i++) ones += fxp32_arshift_mode(1, 2, FXP16_ROUND_STOCHASTIC, &rng);
+    MYUNIT_ASSERT_EQUAL((labs(ones - 25000) < 1500), 1);
+}
+
+MYUNIT_TESTCASE(fxp16_mat)
+{
+    fxp16_mat3_t a, b, r;
+    fxp16_mat4_t t;
+    fxp16_t v[3] = { 1000, -2000, 3000 };
+    fxp16_t x[2] = { 8192, -100 }, y[2] = { 0, 200 }, z[2] = { 0, 300 };
+    int bad = 0;
+
+    /* identity, transpose, product with aliasing */
+    fxp16_mat3_identity(&a, FXP16_Q14);
+    MYUNIT_ASSERT_EQUAL(a.m[1][1], 16384);
+    MYUNIT_ASSERT_EQUAL(a.m[1][2], 0);
+    fxp16_mat3_mulv(&a, v, v, FXP16_Q14);
+    MYUNIT_ASSERT_EQUAL(v[0], 1000);
+    MYUNIT_ASSERT_EQUAL(v[1], -2000);
+
+    for (int i = 0; i < 9; i++) (&b.m[0][0])[i] = (fxp16_t)(i * 1000 - 4000);
+    fxp16_mat3_transpose(&b, &r);
+    MYUNIT_ASSERT_EQUAL(r.m[0][2], b.m[2][0]);
+    fxp16_mat3_mul(&b, &a, &b, FXP16_Q14);
+    MYUNIT_ASSERT_EQUAL(b.m[2][1], 3000);
+
+    /* full scale sums do not wrap: 4 * (-1.0 * -1.0) saturates */
+    for (int i = 0; i < 16; i++) (&t.m[0][0])[i] = INT16_MIN;
+    fxp16_mat4_mul(&t, &t, &t, FXP16_Q15);
+    MYUNIT_ASSERT_EQUAL(t.m[3][3], INT16_MAX);
+
+    /* affine: rotate 90 degrees about z, then translate by (0.25, 0, 0) in Q15 */
+    fxp16_mat4_identity(&t, FXP16_Q14);
+    t.m[0][0] = 0; t.m[0][1] = -16384; t.m[1][0] = 16384; t.m[1][1] = 0;
+    t.m[0][3] = 8192;
+    fxp16_mat4_transform_soa(&t, FXP16_Q14, x, y, z, x, y, z, 2);
+    MYUNIT_ASSERT_EQUAL(x[0], 8192);
+    MYUNIT_ASSERT_EQUAL(y[0], 8192);
+    MYUNIT_ASSERT_EQUAL(x[1], 8192 - 200);
+    MYUNIT_ASSERT_EQUAL(y[1], -100);
+    MYUNIT_ASSERT_EQUAL(z[1], 300);
+
+    /* normalization through rsqrt, over the whole magnitude range */
+    for (int32_t s = 1; s <= INT16_MAX; s = s * 3 + 1)
+    {
+        fxp16_quat_t q = { (fxp16_t)s, (fxp16_t)(-s / 2), (fxp16_t)(s / 3), (fxp16_t)(s / 5) };
+        q = fxp16_quat_normalize(q);
+        double n = sqrt((double)q.w * q.w + (double)q.x * q.x + (double)q.y * q.y + (double)q.z * q.z);
+        if (s >= 30 && fabs(n - 16384.0) > 2.0) bad++;
+    }
+    {
+        fxp16_quat_t q = { INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN };
+        q = fxp16_quat_normalize(q);
+        MYUNIT_ASSERT_EQUAL(q.w, -8192);
+        MYUNIT_ASSERT_EQUAL(q.z, -8192);
+        q.w = q.x = q.y = q.z = 0;
+        q = fxp16_quat_normalize(q);
+        MYUNIT_ASSERT_EQUAL(q.w, 16384);
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* Euler round trip, and the quaternion product composes rotations like the matrices */
+    for (int32_t roll = -30000; roll <= 30000; roll += 7500)
+    {
+        for (int32_t pitch = -12000; pitch <= 12000; pitch += 4000)
+        {
+            fxp16_euler_t e = { (fxp16_t)roll, (fxp16_t)pitch, (fxp16_t)(roll / 3 + pitch) };
+            fxp16_euler_t f = fxp16_quat_to_euler(fxp16_euler_to_quat(e));
+            if (abs(f.roll - e.roll) > 40 || abs(f.pitch - e.pitch) > 40 || abs(f.yaw - e.yaw) > 40) bad++;
+
+            fxp16_quat_t p = fxp16_euler_to_quat(e);
+            fxp16_quat_t q = fxp16_quat_mul(p, fxp16_quat_conj(fxp16_euler_to_quat(f)));
+            if (abs(q.w) < 16300) bad++;
+
+            fxp16_quat_to_mat3(p, &a);
+            fxp16_quat_to_mat3(fxp16_euler_to_quat(f), &b);
+            fxp16_mat3_mul(&a, &b, &r, FXP16_Q14);
+            fxp16_quat_to_mat3(fxp16_quat_mul(p, fxp16_euler_to_quat(f)), &b);
+            for (int i = 0; i < 9; i++) if (abs((&r.m[0][0])[i] - (&b.m[0][0])[i]) > 32) bad++;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* 90 degrees about z maps x onto y */
+    {
+        fxp16_euler_t e = { 0, 0, 16384 };
+        x[0] = 16384; y[0] = 0; z[0] = 0;
+        fxp16_quat_rotate_soa(fxp16_euler_to_quat(e), x, y, z, x, y, z, 1);
+        MYUNIT_ASSERT_EQUAL((abs(x[0]) <= 8 && abs(y[0] - 16384) <= 8 && abs(z[0]) <= 8), 1);
+    }
+}
+
+MYUNIT_TESTCASE(fxp16_goertzel)
+{
+    enum { C = 10, N = 256, T = 3, L = 64 };
+    static fxp16_t x[N * C];
+    const fxp16_t freq[T] = { 4096, 8192, 12288 };     /* 16, 32 and 48 cycles per block */
+    fxp32_t state[FXP16_GOERTZEL_STATE(T, C)], pow[T * C];
+    fxp16_t mag[T * C], delay[L], smag[2];
+    fxp16_complex_t y[T * C];
+    fxp16_goertzel_t g;
+    fxp16_sdft_t sd;
+    const size_t bins[2] = { 4, 10 };
+    int bad = 0;
+
+    MYUNIT_ASSERT_EQUAL(fxp16_goertzel_init(&g, freq, 0, C, state), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_goertzel_init(&g, freq, FXP16CONF_GOERTZEL_MAX_TONES + 1, C, state), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_goertzel_init(&g, freq, T, C, state), 0);
+
+    /* channel c carries tone c % T at amplitude 0.25 */
+    for (int i = 0; i < N; i++)
+    {
+        for (int c = 0; c < C; c++)
+        {
+            x[i * C + c] = (fxp16_t)(fxp16_sin((fxp16_t)(uint16_t)(i * freq[c % T])) >> 2);
+        }
+    }
+
+    /* two calls make one block; A n / 2^(shift + 1) = 8192 * 256 / 2^7 = 16384 */
+    fxp16_goertzel_block(&g, x, N / 2);
+    fxp16_goertzel_block(&g, x + N / 2 * C, N / 2);
+    fxp16_goertzel_mag(&g, mag, 6);
+    fxp16_goertzel_power(&g, pow, 6);
+    fxp16_goertzel_dft(&g, y, 6);
+
+    for (int t = 0; t < T; t++)
+    {
+        for (int c = 0; c < C; c++)
+        {
+            fxp16_t m = mag[t * C + c];
+            if (c % T == t ? abs(m - 16384) > 64 : m > 64) bad++;
+            if (pow[t * C + c] != (fxp32_t)m * m) bad++;
+            if (m != fxp16_cmag(y[t * C + c])) bad++;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    fxp16_goertzel_reset(&g);
+    fxp16_goertzel_mag(&g, mag, 0);
+    MYUNIT_ASSERT_EQUAL(mag[T * C - 1], 0);
+
+    /* sliding DFT: a tone on bin 4 of a 64 sample window, tracked over several windows */
+    MYUNIT_ASSERT_EQUAL(fxp16_sdft_init(&sd, 0, bins, 2, delay), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_sdft_init(&sd, L, bins, 2, delay), 0);
+
+    for (int i = 0; i < 5 * L; i++)
+    {
+        fxp16_sdft_update(&sd, (fxp16_t)(fxp16_sin((fxp16_t)(uint16_t)(i * 4 * 65536 / L)) >> 2));
+
+        if (i >= L)
+        {
+            fxp16_sdft_mag(&sd, smag, 4);       /* 8192 * 64 / 2^5 = 16384 */
+            if (abs(smag[0] - 16384) > 64 || smag[1] > 64) bad++;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* a silent window decays to zero */
+    for (int i = 0; i < L; i++) fxp16_sdft_update(&sd, 0);
+    fxp16_sdft_mag(&sd, smag, 0);
+    MYUNIT_ASSERT_EQUAL((smag[0] <= 1 && smag[1] <= 1), 1);
+}
+
+MYUNIT_TESTCASE(fxp16_moments)
+{
+    enum { N = 1000 };
+    static fxp16_t x[N];
+    fxp16_moments_t m = FXP16_MOMENTS_INIT, h = FXP16_MOMENTS_INIT;
+    fxp16_t mean, var, lo, hi;
+    double sq = 0;
+    uint32_t s = 777;
+
+    /* empty */
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_rms(&m, FXP16_Q15, FXP16_Q15), 0);
+    fxp16_minmax_vec(x, 0, &lo, &hi);
+    MYUNIT_ASSERT_EQUAL(lo, INT16_MAX);
+    MYUNIT_ASSERT_EQUAL(hi, INT16_MIN);
+
+    /* square wave of +-0.25 */
+    for (int i = 0; i < N; i++) x[i] = (i & 1) ? 8192 : -8192;
+    fxp16_meanvar_vec(x, N, FXP16_Q15, FXP16_Q15, &mean, &var);
+    MYUNIT_ASSERT_EQUAL(mean, 0);
+    MYUNIT_ASSERT_EQUAL(var, 2048);
+    MYUNIT_ASSERT_EQUAL(fxp16_rms_vec(x, N, FXP16_Q15, FXP16_Q15), 8192);
+    MYUNIT_ASSERT_EQUAL(fxp16_rms_vec(x, N, FXP16_Q15, FXP16_Q10), 256);
+
+    /* +-1 LSB on a large offset keeps its standard deviation */
+    for (int i = 0; i < N; i++) x[i] = (fxp16_t)(20000 + ((i & 1) ? 1 : -1));
+    fxp16_moments_update(&m, x, N);
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_mean(&m, FXP16_Q15, FXP16_Q15), 20000);
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_std(&m, FXP16_Q15, FXP16_Q15), 1);
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_mean(&m, FXP16_Q15, FXP16_Q0), 1);
+    MYUNIT_ASSERT_EQUAL(m.min, 19999);
+    MYUNIT_ASSERT_EQUAL(m.max, 20001);
+
+    /* 1.0 in Q8 is 1.0 in Q12 */
+    for (int i = 0; i < N; i++) x[i] = (fxp16_t)((i & 1) ? 256 : -256);
+    MYUNIT_ASSERT_EQUAL(fxp16_rms_vec(x, N, FXP16_Q8, FXP16_Q12), 4096);
+    MYUNIT_ASSERT_EQUAL(fxp16_rms_vec(x, N, FXP16_Q8, FXP16_Q15), INT16_MAX);
+
+    /* random samples against a double reference, whole stream equals merged halves */
+    fxp16_moments_reset(&m);
+    for (int i = 0; i < N; i++)
+    {
+        s = s * 1103515245u + 12345u;
+        x[i] = (fxp16_t)(s >> 16);
+        sq += (double)x[i] * x[i];
+    }
+    fxp16_moments_update(&m, x, N);
+    fxp16_moments_update(&h, x, N / 3);
+    {
+        fxp16_moments_t r = FXP16_MOMENTS_INIT;
+        fxp16_moments_update(&r, x + N / 3, N - N / 3);
+        fxp16_moments_merge(&h, &r);
+    }
+    MYUNIT_ASSERT_EQUAL((fabs(fxp16_moments_rms(&m, FXP16_Q15, FXP16_Q15) - sqrt(sq / N)) <= 1.0), 1);
+    MYUNIT_ASSERT_EQUAL((m.count == h.count && m.sum == h.sum && m.sumsq_lo == h.sumsq_lo && m.sumsq_hi == h.sumsq_hi), 1);
+    MYUNIT_ASSERT_EQUAL((m.min == h.min && m.max == h.max), 1);
+
+    /* a stream whose sum of squares has left 64 bit: 2^36 samples of 0.5 */
+    fxp16_moments_reset(&m);
+    m.count = (uint64_t)1 << 36;
+    m.sum = (int64_t)1 << 50;
+    m.sumsq_hi = 1;
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_rms(&m, FXP16_Q15, FXP16_Q15), 16384);
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_mean(&m, FXP16_Q15, FXP16_Q15), 16384);
+    MYUNIT_ASSERT_EQUAL(fxp16_moments_var(&m, FXP16_Q15, FXP16_Q15), 0);
+}
+
+#include <pthread.h>
+#include <sched.h>
+
+#define MYUNIT_RING_SAMPLES     1000000
+
+/* producer: a counting sequence in blocks of varying size, through reserve/commit */
+static void *myunit_ring_producer(void *arg)
+{
+    fxp16_ring_t *r = arg;
+    uint32_t v = 0;
+
+    while (v < MYUNIT_RING_SAMPLES)
+    {
+        size_t n = 1 + v % 61;
+        fxp16_t *p;
+
+        if (n > MYUNIT_RING_SAMPLES - v) n = MYUNIT_RING_SAMPLES - v;
+        if ((p = fxp16_ring_write_reserve(r, n)) == NULL)
+        {
+            n = fxp16_ring_write_acquire(r, &p);
+            if (n > MYUNIT_RING_SAMPLES - v) n = MYUNIT_RING_SAMPLES - v;
+        }
+
+        if (n == 0) sched_yield();     /* full, let the consumer run on a single core */
+        for (size_t i = 0; i < n; i++) p[i] = (fxp16_t)(v + i);
+        fxp16_ring_write_commit(r, n);
+        v += (uint32_t)n;
+    }
+
+    return NULL;
+}
+
+MYUNIT_TESTCASE(fxp16_ring)
+{
+    static fxp16_t buf[64];
+    fxp16_ring_t r;
+    fxp16_t x[100], y[100];
+    const fxp16_t *q;
+    fxp16_t *p;
+    pthread_t tid;
+    uint32_t v = 0, bad = 0;
+
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_init(&r, buf, 48), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_init(&r, buf, 64), 0);
+
+    /* copies wrap, zero-copy regions stop at the wrap point */
+    for (int i = 0; i < 100; i++) x[i] = (fxp16_t)(i * 3);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_write(&r, x, 40), 40);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_read(&r, y, 30), 30);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_write(&r, x + 40, 60), 54);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_space(&r), 0);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_write_acquire(&r, &p), 0);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_read_acquire(&r, &q), 34);
+    MYUNIT_ASSERT_EQUAL(q[0], 90);
+    MYUNIT_ASSERT_EQUAL((fxp16_ring_read_peek(&r, 40) == NULL), 1);
+    fxp16_ring_read_release(&r, 34);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_read(&r, y + 30, 100), 30);
+    for (int i = 0; i < 30; i++) if (y[i] != x[i] || y[30 + i] != x[64 + i]) bad++;
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+    MYUNIT_ASSERT_EQUAL(fxp16_ring_count(&r), 0);
+
+    /* two threads, every sample arrives once and in order */
+    fxp16_ring_init(&r, buf, 64);
+    pthread_create(&tid, NULL, myunit_ring_producer, &r);
+    while (v < MYUNIT_RING_SAMPLES)
+    {
+        size_t n = fxp16_ring_read_acquire(&r, &q);
+        if (n == 0) sched_yield();
+        for (size_t i = 0; i < n; i++) if (q[i] != (fxp16_t)(v + i)) bad++;
+        fxp16_ring_read_release(&r, n);
+        v += (uint32_t)n;
+    }
+    pthread_join(tid, NULL);
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* double mapped: regions run across the wrap point */
+    if (fxp16_ring_init_mapped(&r, 4096) == 0)
+    {
+        /* 4000 samples from offset 4000 are contiguous */
+        for (int i = 0; i < 40; i++) fxp16_ring_write(&r, x, 100);
+        for (int i = 0; i < 40; i++) fxp16_ring_read(&r, y, 100);
+        for (int i = 0; i < 40; i++) fxp16_ring_write(&r, x, 100);
+        q = fxp16_ring_read_peek(&r, 4000);
+        MYUNIT_ASSERT_EQUAL((q != NULL), 1);
+        for (int i = 0; i < 4000; i++) if (q[i] != x[i % 100]) bad++;
+        MYUNIT_ASSERT_EQUAL(bad, 0);
+        MYUNIT_ASSERT_EQUAL(fxp16_ring_write_acquire(&r, &p), 96);
+        fxp16_ring_free(&r);
+    }
+    else
+    {
+        MYUNIT_ASSERT_EQUAL(FXP16CONF_RING_MMAP, 0);
+    }
+}
+
+
+#define MYUNIT_PIPE_CHANNELS    37
+#define MYUNIT_PIPE_BLOCK       1000    /* not a multiple of the tile */
+
+/* elementwise, with history: 4 tap moving average */
+typedef struct { fxp16_t h[3]; } myunit_pipe_fir_t;
+
+static size_t myunit_pipe_fir(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    myunit_pipe_fir_t *f = (myunit_pipe_fir_t *)state;
+    (void)arg;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_t v = x[i];
+        y[i] = (fxp16_t)(((int32_t)v + f->h[0] + f->h[1] + f->h[2]) >> 2);
+        f->h[2] = f->h[1]; f->h[1] = f->h[0]; f->h[0] = v;
+    }
+    return n;
+}
+
+/* elementwise, with a phase: mixes with fs/2, i.e. negates every other complex pair */
+static size_t myunit_pipe_mix(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    uint32_t *phase = (uint32_t *)state;
+    (void)arg;
+
+    for (size_t i = 0; i < n; i++, (*phase)++)
+    {
+        y[i] = ((*phase >> 1) & 1) ? (fxp16_t)-x[i] : x[i];
+    }
+    return n;
+}
+
+/* block: keeps every second complex pair */
+static size_t myunit_pipe_decimate(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    (void)arg; (void)state;
+
+    for (size_t i = 0; i < n / 4; i++)
+    {
+        y[2 * i] = x[4 * i];
+        y[2 * i + 1] = x[4 * i + 1];
+    }
+    return n / 4 * 2;
+}
+
+/* block: copies, after spinning as long as the channel's state says */
+static size_t myunit_pipe_spin(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const uint32_t *spin = (const uint32_t *)state;
+    (void)arg;
+
+    for (volatile uint32_t k = 0; k < *spin; k++);
+    memmove(y, x, n * sizeof(fxp16_t));
+    return n;
+}
+
+MYUNIT_TESTCASE(fxp16_pipe)
+{
+    static fxp16_t in[MYUNIT_PIPE_CHANNELS][MYUNIT_PIPE_BLOCK], out[MYUNIT_PIPE_CHANNELS][MYUNIT_PIPE_BLOCK];
+    static fxp16_t ref[MYUNIT_PIPE_BLOCK], tmp[MYUNIT_PIPE_BLOCK];
+    static myunit_pipe_fir_t fir[MYUNIT_PIPE_CHANNELS], fir_ref[MYUNIT_PIPE_CHANNELS];
+    static uint32_t phase[MYUNIT_PIPE_CHANNELS], phase_ref[MYUNIT_PIPE_CHANNELS];
+    const fxp16_t *inp[MYUNIT_PIPE_CHANNELS];
+    fxp16_t *outp[MYUNIT_PIPE_CHANNELS];
+    size_t out_n[MYUNIT_PIPE_CHANNELS];
+    const fxp16_pipe_fp2fp_t q = { FXP16_Q15, FXP16_Q13 };
+    const fxp16_pipe_stage_t stages[] = {
+        { "requant",  fxp16_pipe_fp2fp,     &q,   NULL,  0,                  FXP16_PIPE_ELEMENTWISE },
+        { "fir",      myunit_pipe_fir,      NULL, fir,   sizeof(*fir),       FXP16_PIPE_ELEMENTWISE },
+        { "mix",      myunit_pipe_mix,      NULL, phase, sizeof(*phase),     FXP16_PIPE_ELEMENTWISE },
+        { "decimate", myunit_pipe_decimate, NULL, NULL,  0,                  0 },
+        { "mag",      fxp16_pipe_cmag,      NULL, NULL,  0,                  0 },
+    };
+    static uint32_t spin[MYUNIT_PIPE_CHANNELS];
+    const fxp16_pipe_stage_t skewed[] = {
+        { "requant",  fxp16_pipe_fp2fp,     &q,   NULL,  0,                  FXP16_PIPE_ELEMENTWISE },
+        { "spin",     myunit_pipe_spin,     NULL, spin,  sizeof(*spin),      0 },
+    };
+    fxp16_pipe_timing_t t[5];
+    fxp16_pipe_t p;
+    uint32_t seed = 99, bad = 0;
+
+    MYUNIT_ASSERT_EQUAL(fxp16_pipe_init(&p, stages, 0, MYUNIT_PIPE_BLOCK, 4), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_pipe_init(&p, stages, 5, MYUNIT_PIPE_BLOCK, 4), 0);
+    MYUNIT_ASSERT_INRANGE(fxp16_pipe_threads(&p), 1, 4);
+    fxp16_pipe_set_timing(&p, 1);
+
+    for (int c = 0; c < MYUNIT_PIPE_CHANNELS; c++)
+    {
+        inp[c] = in[c];
+        outp[c] = out[c];
+    }
+
+    /* fused and threaded equals stage after stage on whole blocks, state carries over */
+    for (int block = 0; block < 2; block++)
+    {
+        for (int c = 0; c < MYUNIT_PIPE_CHANNELS; c++)
+        {
+            for (int i = 0; i < MYUNIT_PIPE_BLOCK; i++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                in[c][i] = (fxp16_t)(seed >> 16);
+            }
+        }
+
+        MYUNIT_ASSERT_EQUAL(fxp16_pipe_run(&p, inp, outp, out_n, MYUNIT_PIPE_CHANNELS, MYUNIT_PIPE_BLOCK), 0);
+
+        for (int c = 0; c < MYUNIT_PIPE_CHANNELS; c++)
+        {
+            size_t n = fxp16_pipe_fp2fp(&q, NULL, in[c], tmp, MYUNIT_PIPE_BLOCK);
+            n = myunit_pipe_fir(NULL, &fir_ref[c], tmp, tmp, n);
+            n = myunit_pipe_mix(NULL, &phase_ref[c], tmp, tmp, n);
+            n = myunit_pipe_decimate(NULL, NULL, tmp, ref, n);
+            n = fxp16_pipe_cmag(NULL, NULL, ref, tmp, n);
+
+            if (out_n[c] != n || memcmp(out[c], tmp, n * sizeof(fxp16_t)) != 0) bad++;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+    MYUNIT_ASSERT_EQUAL(out_n[0], MYUNIT_PIPE_BLOCK / 4);
+
+    /* fused stages run once per tile, block stages once per block */
+    fxp16_pipe_timing(&p, t);
+    MYUNIT_ASSERT_EQUAL(strcmp(t[1].name, "fir"), 0);
+    MYUNIT_ASSERT_EQUAL(t[0].calls, 2 * MYUNIT_PIPE_CHANNELS * ((MYUNIT_PIPE_BLOCK + FXP16CONF_PIPE_TILE - 1) / FXP16CONF_PIPE_TILE));
+    MYUNIT_ASSERT_EQUAL(t[2].samples, 2 * MYUNIT_PIPE_CHANNELS * MYUNIT_PIPE_BLOCK);
+    MYUNIT_ASSERT_EQUAL(t[3].calls, 2 * MYUNIT_PIPE_CHANNELS);
+    MYUNIT_ASSERT_EQUAL(t[4].samples, 2 * MYUNIT_PIPE_CHANNELS * MYUNIT_PIPE_BLOCK / 2);
+    MYUNIT_ASSERT_EQUAL((t[1].ns > 0), 1);
+    fxp16_pipe_timing_reset(&p);
+    fxp16_pipe_timing(&p, t);
+    MYUNIT_ASSERT_EQUAL(t[1].calls + t[1].ns, 0);
+
+    MYUNIT_ASSERT_EQUAL(fxp16_pipe_run(&p, inp, outp, NULL, MYUNIT_PIPE_CHANNELS, MYUNIT_PIPE_BLOCK + 1), -1);
+    fxp16_pipe_free(&p);
+
+    /* skewed load: the first quarter of the channels, all in worker 0's range, is
+       slow, so the other workers run dry and steal; the result stays the same */
+    for (int c = 0; c < MYUNIT_PIPE_CHANNELS; c++)
+    {
+        spin[c] = (c < MYUNIT_PIPE_CHANNELS / 4) ? 200000 : 0;
+    }
+    MYUNIT_ASSERT_EQUAL(fxp16_pipe_init(&p, skewed, 2, MYUNIT_PIPE_BLOCK, 4), 0);
+
+    /* a few blocks, in case the workers were slow to wake for the first one */
+    for (int block = 0; block < 8 && (block == 0 || fxp16_pipe_steals(&p) == 0); block++)
+    {
+        MYUNIT_ASSERT_EQUAL(fxp16_pipe_run(&p, inp, outp, out_n, MYUNIT_PIPE_CHANNELS, MYUNIT_PIPE_BLOCK), 0);
+
+        for (int c = 0; c < MYUNIT_PIPE_CHANNELS; c++)
+        {
+            size_t n = fxp16_pipe_fp2fp(&q, NULL, in[c], tmp, MYUNIT_PIPE_BLOCK);
+
+            if (out_n[c] != n || memcmp(out[c], tmp, n * sizeof(fxp16_t)) != 0) bad++;
+        }
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+    if (fxp16_pipe_threads(&p) > 1)
+    {
+        MYUNIT_ASSERT_EQUAL((fxp16_pipe_steals(&p) > 0), 1);
+    }
+    fxp16_pipe_free(&p);
+}
+
+
+#define MYUNIT_VIEW_FRAMES      301     /* vector body plus a tail */
+
+MYUNIT_TESTCASE(fxp16_view)
+{
+    static fxp16_t x[6 * MYUNIT_VIEW_FRAMES], y[6 * MYUNIT_VIEW_FRAMES], planes[6][MYUNIT_VIEW_FRAMES];
+    static fxp16_t a[MYUNIT_VIEW_FRAMES], b[MYUNIT_VIEW_FRAMES];
+    static fxp16_t lut[FXP16_LUT_ENTRIES];
+    const fxp16_lut_q_t q = { FXP16_Q12, FXP16_Q15 };
+    fxp16_t *pp[6];
+    const fxp16_t *cp[6];
+    fxp16_moments_t m1 = FXP16_MOMENTS_INIT, m2 = FXP16_MOMENTS_INIT;
+    uint32_t seed = 7, bad = 0;
+
+    for (int i = 0; i < 6 * MYUNIT_VIEW_FRAMES; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        x[i] = (fxp16_t)(seed >> 16);
+    }
+    for (int c = 0; c < 6; c++)
+    {
+        pp[c] = planes[c];
+        cp[c] = planes[c];
+    }
+
+    /* planes and back, vectorized and generic channel counts */
+    for (size_t ch = 1; ch <= 6; ch++)
+    {
+        memset(y, 0, sizeof(y));
+        fxp16_deinterleave(x, pp, ch, MYUNIT_VIEW_FRAMES);
+        for (size_t f = 0; f < MYUNIT_VIEW_FRAMES; f++)
+            for (size_t c = 0; c < ch; c++)
+                if (planes[c][f] != x[f * ch + c]) bad++;
+        fxp16_interleave(cp, y, ch, MYUNIT_VIEW_FRAMES);
+        if (memcmp(x, y, ch * MYUNIT_VIEW_FRAMES * sizeof(fxp16_t)) != 0) bad++;
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* one channel of 3, in place: the other channels are untouched */
+    memcpy(y, x, sizeof(y));
+    fxp16_fp2fp_view(fxp16_cview_channel(y, MYUNIT_VIEW_FRAMES, 3, 1), fxp16_view_channel(y, MYUNIT_VIEW_FRAMES, 3, 1),
+                     FXP16_Q15, FXP16_Q11);
+    for (int f = 0; f < MYUNIT_VIEW_FRAMES; f++)
+    {
+        if (y[3 * f] != x[3 * f] || y[3 * f + 2] != x[3 * f + 2]) bad++;
+        if (y[3 * f + 1] != fxp16_fp2fp(x[3 * f + 1], FXP16_Q15, FXP16_Q11)) bad++;
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* negative stride reverses, counts clip to the shorter view */
+    fxp16_round_view(fxp16_cview(x + MYUNIT_VIEW_FRAMES - 1, MYUNIT_VIEW_FRAMES, -1), fxp16_view(a, 100, 1),
+                     FXP16_Q8, FXP16_ROUND_NEAREST_EVEN);
+    for (int i = 0; i < 100; i++)
+        if (a[i] != fxp16_rint(x[MYUNIT_VIEW_FRAMES - 1 - i], FXP16_Q8)) bad++;
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* kernels through the tile equal the contiguous kernels on a deinterleaved copy */
+    fxp16_deinterleave(x, pp, 4, MYUNIT_VIEW_FRAMES);
+    fxp16_lut_build(lut, fxp16_lut_sin, &q);
+    fxp16_tanh_view(FXP16_Q15, fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 2), FXP16_Q12, fxp16_view(a, MYUNIT_VIEW_FRAMES, 1));
+    fxp16_tanh_vec(FXP16_Q15, planes[2], FXP16_Q12, b, MYUNIT_VIEW_FRAMES);
+    if (memcmp(a, b, sizeof(a)) != 0) bad++;
+    fxp16_sigmoid_view(FXP16_Q15, fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 3), FXP16_Q12, fxp16_view(a, MYUNIT_VIEW_FRAMES, 1));
+    fxp16_sigmoid_vec(FXP16_Q15, planes[3], FXP16_Q12, b, MYUNIT_VIEW_FRAMES);
+    if (memcmp(a, b, sizeof(a)) != 0) bad++;
+    fxp16_lut_gather_view(lut, fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 0), fxp16_view(a, MYUNIT_VIEW_FRAMES, 1));
+    fxp16_lut_gather(lut, planes[0], b, MYUNIT_VIEW_FRAMES);
+    if (memcmp(a, b, sizeof(a)) != 0) bad++;
+    fxp16_moments_update_view(&m1, fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 1));
+    fxp16_moments_update(&m2, planes[1], MYUNIT_VIEW_FRAMES);
+    if (m1.sum != m2.sum || m1.sumsq_lo != m2.sumsq_lo || m1.min != m2.min || m1.max != m2.max) bad++;
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+
+    /* elementwise scalar operations on two channels */
+    fxp16_add_view(fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 0), fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 1),
+                   fxp16_view(a, MYUNIT_VIEW_FRAMES, 1));
+    fxp16_mult_view(fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 2), FXP16_Q12, fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 3),
+                    FXP16_Q14, fxp16_view(b, MYUNIT_VIEW_FRAMES, 1));
+    for (int f = 0; f < MYUNIT_VIEW_FRAMES; f++)
+    {
+        if (a[f] != fxp16_add(planes[0][f], planes[1][f])) bad++;
+        if (b[f] != fxp16_mult(planes[2][f], FXP16_Q12, planes[3][f], FXP16_Q14)) bad++;
+    }
+    fxp16_sin_view(fxp16_cview_channel(x, MYUNIT_VIEW_FRAMES, 4, 1), fxp16_view(a, MYUNIT_VIEW_FRAMES, 1));
+    for (int f = 0; f < MYUNIT_VIEW_FRAMES; f++)
+        if (a[f] != fxp16_sin(planes[1][f])) bad++;
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+}
+
+
+MYUNIT_TESTCASE(fxp16_arena)
+{
+    enum { T = 3, C = 4, L = 64, RING = 256, BFP = 100, BLOCK = 128, THREADS = 2 };
+    static _Alignas(FXP16_ARENA_ALIGN) unsigned char mem[256 * 1024];
+    static fxp16_t ref[FXP16_LUT_ENTRIES], x[BLOCK], y[BLOCK];
+    const fxp16_t freq[T] = { 4096, 8192, 12288 };
+    const size_t bins[2] = { 4, 10 };
+    const fxp16_lut_q_t q = { FXP16_Q12, FXP16_Q15 };
+    const fxp16_pipe_fp2fp_t pq = { FXP16_Q15, FXP16_Q13 };
+    const fxp16_pipe_stage_t stage = { "requant", fxp16_pipe_fp2fp, &pq, NULL, 0, FXP16_PIPE_ELEMENTWISE };
+    const fxp16_t *in[1] = { x };
+    fxp16_t *out[1] = { y };
+    fxp16_arena_t a;
+    fxp16_goertzel_t g;
+    fxp16_sdft_t sd;
+    fxp16_ring_t r;
+    fxp16_bfp_t b;
+    fxp16_pipe_t p;
+    fxp16_t *lut;
+    void *p1, *p2;
+    size_t total, size, mark;
+    int bad = 0;
+
+    /* unaligned caller memory still gives aligned pieces */
+    MYUNIT_ASSERT_EQUAL(fxp16_arena_init(&a, NULL, 128), -1);
+    MYUNIT_ASSERT_EQUAL(fxp16_arena_init(&a, mem + 1, 1024), 0);
+    p1 = fxp16_arena_alloc(&a, 1);
+    p2 = fxp16_arena_alloc(&a, 100);
+    MYUNIT_ASSERT_EQUAL(((uintptr_t)p1 | (uintptr_t)p2) % FXP16_ARENA_ALIGN, 0);
+    MYUNIT_ASSERT_EQUAL((unsigned char *)p2 - (unsigned char *)p1, FXP16_ARENA_ALIGN);
+    MYUNIT_ASSERT_EQUAL(a.used, FXP16_ARENA_SIZE(1) + FXP16_ARENA_SIZE(100));
+
+    /* exhausted, then released back to a mark */
+    mark = fxp16_arena_mark(&a);
+    MYUNIT_ASSERT_EQUAL((fxp16_arena_alloc(&a, fxp16_arena_left(&a) + 1) == NULL), 1);
+    MYUNIT_ASSERT_EQUAL((fxp16_arena_alloc(&a, fxp16_arena_left(&a)) != NULL), 1);
+    MYUNIT_ASSERT_EQUAL(fxp16_arena_left(&a), 0);
+    fxp16_arena_release(&a, mark);
+    MYUNIT_ASSERT_EQUAL((fxp16_arena_alloc(&a, 64) == (unsigned char *)p2 + FXP16_ARENA_SIZE(100)), 1);
+    MYUNIT_ASSERT_EQUAL(a.peak, a.size);
+    fxp16_arena_free(&a);
+
+    /* the _bytes() sum is exactly what the inits take; any less fails the last init */
+    total = fxp16_goertzel_bytes(T, C) + fxp16_sdft_bytes(L) + fxp16_ring_bytes(RING)
+          + fxp16_bfp_bytes(BFP) + fxp16_lut_bytes() + fxp16_pipe_bytes(BLOCK, THREADS);
+    MYUNIT_ASSERT_EQUAL((total <= sizeof(mem)), 1);
+    fxp16_lut_build(ref, fxp16_lut_tanh, &q);
+    for (int i = 0; i < BLOCK; i++) x[i] = (fxp16_t)(i * 251 - 16000);
+
+    for (int short_by = 0; short_by <= 1; short_by++)
+    {
+        size = total - (size_t)short_by;
+
+        /* caller memory where mmap() is not available */
+        if (fxp16_arena_init_mapped(&a, size) != 0)
+        {
+            MYUNIT_ASSERT_EQUAL(fxp16_arena_init(&a, mem, size), 0);
+        }
+        MYUNIT_ASSERT_EQUAL(a.size, (size & ~(size_t)(FXP16_ARENA_ALIGN - 1)));
+
+        MYUNIT_ASSERT_EQUAL(fxp16_goertzel_init_arena(&g, &a, freq, T, C), 0);
+        MYUNIT_ASSERT_EQUAL(fxp16_sdft_init_arena(&sd, &a, L, bins, 2), 0);
+        MYUNIT_ASSERT_EQUAL(fxp16_ring_init_arena(&r, &a, RING), 0);
+        MYUNIT_ASSERT_EQUAL(fxp16_bfp_init_arena(&b, &a, BFP), 0);
+        lut = fxp16_lut_build_arena(&a, fxp16_lut_tanh, &q);
+        MYUNIT_ASSERT_EQUAL((lut != NULL), 1);
+
+        mark = fxp16_arena_mark(&a);
+        if (short_by)
+        {
+            MYUNIT_ASSERT_EQUAL(fxp16_pipe_init_arena(&p, &a, &stage, 1, BLOCK, THREADS), -1);
+            MYUNIT_ASSERT_EQUAL(fxp16_arena_mark(&a), mark);
+        }
+        else
+        {
+            MYUNIT_ASSERT_EQUAL(fxp16_pipe_init_arena(&p, &a, &stage, 1, BLOCK, THREADS), 0);
+            MYUNIT_ASSERT_EQUAL(fxp16_arena_left(&a), 0);
+
+            MYUNIT_ASSERT_EQUAL(fxp16_pipe_run(&p, in, out, NULL, 1, BLOCK), 0);
+            for (int i = 0; i < BLOCK; i++)
+                if (y[i] != fxp16_fp2fp(x[i], FXP16_Q15, FXP16_Q13)) bad++;
+            fxp16_pipe_free(&p);
+
+            MYUNIT_ASSERT_EQUAL(fxp16_ring_write(&r, x, BLOCK), BLOCK);
+            MYUNIT_ASSERT_EQUAL(fxp16_ring_read(&r, y, BLOCK), BLOCK);
+            if (memcmp(x, y, sizeof(x)) != 0) bad++;
+            if (b.m[BFP - 1] != 0 || memcmp(lut, ref, sizeof(ref)) != 0) bad++;
+        }
+
+        fxp16_ring_free(&r);
+        fxp16_arena_free(&a);
+    }
+    MYUNIT_ASSERT_EQUAL(bad, 0);
+}
+
+
+
 
 void myunit_testsuite_setup()
 {
@@ -846,6 +2606,29 @@ MYUNIT_TESTSUITE(selftest)
 
 
    MYUNIT_EXEC_TESTCASE(fxp16_sinh);
+   MYUNIT_EXEC_TESTCASE(fxp16_sinhcosh);
+   MYUNIT_EXEC_TESTCASE(fxp16_tanh_vec);
+   MYUNIT_EXEC_TESTCASE(fxp16_gemm);
+   MYUNIT_EXEC_TESTCASE(fxp16_complex);
+   MYUNIT_EXEC_TESTCASE(fxp16_bfp);
+   MYUNIT_EXEC_TESTCASE(fxp16_flt2fp_vec);
+   MYUNIT_EXEC_TESTCASE(fxp16_fp2fp_vec);
+   MYUNIT_EXEC_TESTCASE(fxp16_status);
+   MYUNIT_EXEC_TESTCASE(fxp16_stats);
+   MYUNIT_EXEC_TESTCASE(fxp16_lut);
+   MYUNIT_EXEC_TESTCASE(fxp16_lut_file);
+   MYUNIT_EXEC_TESTCASE(fxp16_diff);
+   MYUNIT_EXEC_TESTCASE(fxp16_dispatch);
+   MYUNIT_EXEC_TESTCASE(fxp16_wrap);
+   MYUNIT_EXEC_TESTCASE(fxp16_round_vec);
+   MYUNIT_EXEC_TESTCASE(fxp16_round_mode);
+   MYUNIT_EXEC_TESTCASE(fxp16_mat);
+   MYUNIT_EXEC_TESTCASE(fxp16_goertzel);
+   MYUNIT_EXEC_TESTCASE(fxp16_moments);
+   MYUNIT_EXEC_TESTCASE(fxp16_ring);
+   MYUNIT_EXEC_TESTCASE(fxp16_pipe);
+   MYUNIT_EXEC_TESTCASE(fxp16_view);
+   MYUNIT_EXEC_TESTCASE(fxp16_arena);
    fxp16_print_sinhcosh_table_csv();
 
 
@@ -34,14 +34,46 @@
     \details
 */
 
+/* emit the exported definitions of fxp16_inline.h in this translation unit */
+#define FXP16_INLINE_DEF
 #include "fxp16.h"
+#include "fxp16_kernels.h"
+#include "fxp16_wrap.h"
 #include <math.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 
 
+#if FXP16CONF_STATUS_FLAGS
+FXP16_THREAD_LOCAL uint8_t fxp16_status_flags = 0;
+#endif
+
+
+uint8_t fxp16_status_get(void)
+{
+#if FXP16CONF_STATUS_FLAGS
+    return fxp16_status_flags;
+#else
+    return 0;
+#endif
+}
+
+
+uint8_t fxp16_status_get_and_clear(void)
+{
+#if FXP16CONF_STATUS_FLAGS
+    uint8_t flags = fxp16_status_flags;
+    fxp16_status_flags = 0;
+    return flags;
+#else
+    return 0;
+#endif
+}
+
+
 
 /*!
     \brief      Converts a float to a fixed point type
@@ -54,6 +86,7 @@
 */
 fxp16_t fxp16_flt2fp(float var, uint8_t frac)
 {
+    fxp16_stats_call_m(flt2fp);
    /*
 
    To convert from floating-point to fixed-point, we follow this algorithm:
@@ -64,8 +97,10 @@ fxp16_t fxp16_flt2fp(float var, uint8_t frac)
 
    */
 
-    var = round(var * (1 << frac));
+    float scaled = var * (1 << frac);
+    var = round(scaled);
     fxp16_sat_m(var);
+    fxp16_status_underflow_m(scaled != 0.0f, var);
     return (fxp16_t)var;
 }
 
@@ -85,6 +120,23 @@ float fxp16_fp2flt(fxp16_t var, uint8_t frac)
 }
 
 
+fxp16_t fxp16_dbl2fp(double var, uint8_t frac)
+{
+    fxp16_stats_call_m(dbl2fp);
+    double scaled = var * (1 << frac);
+    var = round(scaled);
+    fxp16_sat_m(var);
+    fxp16_status_underflow_m(scaled != 0.0, var);
+    return (fxp16_t)var;
+}
+
+
+double fxp16_fp2dbl(fxp16_t var, uint8_t frac)
+{
+    return ((double)(var)) / (1 << frac);
+}
+
+
 /*!
     \brief      Converts an integer type to fixed point
     \details    Converts an integer variable to a fixed point variable.
@@ -103,22 +155,6 @@ fxp16_t fxp16_int2fp(int16_t intpart, uint8_t frac)
 }
 
 
-#if FXP16CONF_ARSHIFT_W_ROUNDING
-
-fxp16_t fxp16_arshift(fxp16_t fp, uint8_t shift)
-{
-   fpxx_arshift_m(fp,shift);
-   return fp;
-}
-
-fxp32_t fxp32_arshift(fxp32_t var,uint8_t rshift)
-{
-    fpxx_arshift_m(var,rshift);
-    return var;
-}
-
-#endif
-
 /*!
     \brief      Left shifts fixed point number
     \details    Left shifts fixed point number
@@ -153,100 +189,15 @@ fxp16_t fxp16_alshift(fxp16_t fp, uint8_t shift)
 
 fxp16_t fxp16_fp2fp(fxp16_t fp, uint8_t fracold, uint8_t fracnew)
 {
+    fxp16_stats_call_m(fp2fp);
     fxp32_t result = fp;
     fpxx_ashift_m(result, fracold - fracnew);
     fxp16_sat_m(result);
+    fxp16_status_underflow_m(fp != 0, result);
     return (fxp16_t) result;
 }
 
 
-fxp16_t fxp16_sat(fxp32_t fxp32)
-{
-    fxp16_sat_m(fxp32);
-    return (fxp16_t) fxp32;
-}
-
-
-
-/*!
-    \brief      Adds two fixed point numbers
-    \details    Adds two fixed point numbers. Result gets saturated if it exceeds fixed point limits.
-
-                result = a + b
-
-                Be aware of that both fixed point numbers must be of same type (same number of fractional bits)!
-                Otherwise the result may be undefined.
-
-    \param[in]  summand1       First fixed point summand
-    \param[in]  summand2       Second fixed point summand
-
-
-    \returns Sum of first summand and second summand in fixed point format
-*/
-fxp16_t fxp16_add(fxp16_t summand1, fxp16_t summand2)
-{
-    int32_t result;
-    result = summand1+summand2;
-    fxp16_sat_m(result);
-    return(fxp16_t)result;
-}
-
-/*!
-    \brief     Subtracts two fixed point numbers
-    \details    Adds two fixed point number. Result gets saturated if it exceeds fixed point limits.
-
-                result = a - b
-
-                Be aware of that both fixed point numbers must be of same type (same number of fractional bits)!
-                Otherwise the result may be undefined.
-
-    \param[in]  minuend     Minuend
-    \param[in]  subtrahend  Subtrahend
-
-
-    \returns Difference of minuend and subtrahend in fixed point format
-*/
-
-fxp16_t fxp16_sub(fxp16_t minuend, fxp16_t subtrahend)
-{
-   int32_t result;
-   result = minuend-subtrahend;
-   fxp16_sat_m(result);
-   return(fxp16_t)result;
-}
-
-
-
-
-
-/*!
-    \brief      Multiplies two fixed point numbers
-    \details    Multiplies two fixed point numbers. The numbers may be of different fixed point format.
-                The result is in the fixed point format of the multiplicand (1st fixed point parameter).
-                Result gets saturated if it exceeds fixed point limits.
-
-                When performing an integer multiplication the product is 2xWL if both the multiplier and
-                multiplicand are WL long. If the integer multiplication is on fixed-point variables, the number of
-                integer and fractional bits in the product is the sum of the corresponding multiplier and
-                multiplicand Q-points.
-
-                result = a*b
-
-
-    \param[in]  mult1     multiplicator
-    \param[in]  mult2     multiplicant
-
-
-    \returns Product of multiplicator and multiplicant in fixed point format of multiplicator
-*/
-fxp16_t fxp16_mult(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2)
-{
-    fxp32_t result = fxp32_arshift((fxp32_t)mult1*(fxp32_t)mult2,frac2);
-    fxp16_sat_m(result);
-    return (fxp16_t)result;
-}
-
-
 /*!
     \brief      Divides two fixed point numbers
     \details    Divides two fixed point numbers
@@ -258,12 +209,22 @@ fxp16_t fxp16_mult(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2)
     \param      divisor      divisor
 
 
-    \returns divident/divisor with fractional bits of divident
+    \returns divident/divisor with fractional bits of divident,
+             saturated by the sign of divident if divisor is zero
 */
 fxp16_t fxp16_div(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t frac2)
 {
+    fxp16_stats_call_m(div);
+  if (divisor == 0)
+  {
+     fxp16_status_raise_m(FXP16_STATUS_DIVBYZERO);
+     fxp16_stats_early_m();
+     return (divident < 0) ? INT16_MIN : INT16_MAX;
+  }
+
   fxp32_t result = (divident<<frac2)/divisor;
   fxp16_sat_m(result);
+  fxp16_status_underflow_m(divident != 0, result);
   return (fxp16_t)result;
 }
 
@@ -271,6 +232,7 @@ fxp16_t fxp16_div(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t frac
 
 fxp16_t fxp16_ceil(fxp16_t x, uint8_t xfrac)
 {
+    fxp16_stats_call_m(ceil);
 
    fxp32_t result = (fxp32_t)x&~((1<<xfrac)-1);
 
@@ -289,6 +251,7 @@ fxp16_t fxp16_ceil(fxp16_t x, uint8_t xfrac)
 
 fxp16_t fxp16_round(fxp16_t x, uint8_t xfrac)
 {
+    fxp16_stats_call_m(round);
    int32_t result = x;
 
    if (xfrac == 0 )
@@ -317,8 +280,11 @@ fxp16_t fxp16_round(fxp16_t x, uint8_t xfrac)
 
 fxp16_t fxp16_fmod(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac)
 {
+    fxp16_stats_call_m(fmod);
    if ( y == 0 )
    {
+      fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+      fxp16_stats_early_m();
       return 0;
    }
 
@@ -337,6 +303,7 @@ fxp16_t fxp16_fmod(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac)
 
 int fxp16_lround(fxp16_t x, uint8_t xfrac)
 {
+    fxp16_stats_call_m(lround);
    int32_t result = x;
 
    if (xfrac == 0 )
@@ -364,6 +331,80 @@ int fxp16_lround(fxp16_t x, uint8_t xfrac)
 }
 
 
+fxp16_t fxp16_rint(fxp16_t x, uint8_t xfrac)
+{
+    fxp16_stats_call_m(rint);
+
+    if (xfrac == 0)
+    {
+        return x;
+    }
+
+    fxp32_t result = fxp16_round_elem(x, xfrac, FXP16_ROUND_NEAREST_EVEN);
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+
+/*
+    x - n * y, given k = |trunc(num / den)| with num = x in Q(xfrac+yfrac) and
+    den = y in Q(xfrac+yfrac). k is rounded to nearest even on the magnitudes, the
+    sign is applied afterwards; |num|, |den| <= 2^30.
+*/
+static inline fxp16_t fxp16_remquo_elem(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, uint32_t k, int *quo)
+{
+    int32_t  num = (int32_t)x * (1 << yfrac);
+    int32_t  den = (int32_t)y * (1 << xfrac);
+    uint32_t an  = (num < 0) ? -(uint32_t)num : (uint32_t)num;
+    uint32_t ad  = (den < 0) ? -(uint32_t)den : (uint32_t)den;
+    uint32_t r2  = 2 * (an - k * ad);
+
+    if (r2 > ad || (r2 == ad && (k & 1)))
+    {
+        k++;
+    }
+
+    int32_t q = ((num < 0) != (den < 0)) ? -(int32_t)k : (int32_t)k;
+
+    if (quo)
+    {
+        *quo = q;
+    }
+
+    int32_t result = q * den;
+    fpxx_arshift_m(result, yfrac);
+
+    result = x - result;
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+
+fxp16_t fxp16_remquo(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, int *quo)
+{
+    fxp16_stats_call_m(remainder);
+
+    if (y == 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        fxp16_stats_early_m();
+        if (quo) *quo = 0;
+        return 0;
+    }
+
+    uint32_t an = (uint32_t)abs(x) << yfrac;
+    uint32_t ad = (uint32_t)abs(y) << xfrac;
+
+    return fxp16_remquo_elem(x, xfrac, y, yfrac, an / ad, quo);
+}
+
+
+fxp16_t fxp16_remainder(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac)
+{
+    return fxp16_remquo(x, xfrac, y, yfrac, NULL);
+}
+
+
 
 
 /*
@@ -377,8 +418,14 @@ int fxp16_lround(fxp16_t x, uint8_t xfrac)
  */
 fxp16_t fxp16_sqrt(fxp16_t  x, uint8_t frac_bits)
 {
+    fxp16_stats_call_m(sqrt);
     if (frac_bits > 15) frac_bits = 15;     // Safety für 32-Bit-Zwischenwerte
 
+    if (x < 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+    }
+
     // Wir brauchen y_fixed = sqrt(x * 2^n)
     uint32_t a = (uint32_t)x << frac_bits;
 
@@ -408,6 +455,7 @@ fxp16_t fxp16_sqrt(fxp16_t  x, uint8_t frac_bits)
 
 fxp16_t fxp16_cbrt(fxp16_t a, uint8_t afrac)
 {
+    fxp16_stats_call_m(cbrt);
 
     /*
         Newton's method
@@ -514,8 +562,8 @@ void cordic_sin_cos_q15_pi(fxp16_t angle_q15, fxp16_t* sin_q15, fxp16_t* cos_q15
         {
             fxp32_t xn = (int32_t)x - y_shift;
             fxp32_t yn = (int32_t)y + x_shift;
-            fxp16_sat_m(xn);
-            fxp16_sat_m(yn);
+            fpxx_clamp_m(xn, INT16_MIN, INT16_MAX);
+            fpxx_clamp_m(yn, INT16_MIN, INT16_MAX);
             x = (int16_t)xn;
             y = (int16_t)yn;
             z = (z - a);
@@ -524,8 +572,8 @@ void cordic_sin_cos_q15_pi(fxp16_t angle_q15, fxp16_t* sin_q15, fxp16_t* cos_q15
         {
             fxp32_t xn = (int32_t)x + y_shift;
             fxp32_t yn = (int32_t)y - x_shift;
-            fxp16_sat_m(xn);
-            fxp16_sat_m(yn);
+            fpxx_clamp_m(xn, INT16_MIN, INT16_MAX);
+            fpxx_clamp_m(yn, INT16_MIN, INT16_MAX);
             x = (int16_t)xn;
             y = (int16_t)yn;
             z = (z + a);
@@ -539,6 +587,7 @@ void cordic_sin_cos_q15_pi(fxp16_t angle_q15, fxp16_t* sin_q15, fxp16_t* cos_q15
 
 fxp16_t fxp16_sin(fxp16_t rad)
 {
+    fxp16_stats_call_m(sin);
     fxp16_t sin_q15, cos_q15;
     cordic_sin_cos_q15_pi(rad, &sin_q15, &cos_q15);
     return sin_q15;
@@ -546,6 +595,7 @@ fxp16_t fxp16_sin(fxp16_t rad)
 
 fxp16_t fxp16_cos(fxp16_t rad)
 {
+    fxp16_stats_call_m(cos);
     fxp16_t sin_q15,cos_q15;
     cordic_sin_cos_q15_pi(rad , &sin_q15, &cos_q15);
     return cos_q15;
@@ -554,6 +604,7 @@ fxp16_t fxp16_cos(fxp16_t rad)
 
 fxp16_t fxp16_tan(fxp16_t fp, uint8_t frac)
 {
+    fxp16_stats_call_m(tan);
     fxp32_t x;
     fxp16_t sin_q15, cos_q15;
 
@@ -561,9 +612,13 @@ fxp16_t fxp16_tan(fxp16_t fp, uint8_t frac)
     {
         case FXP16_Q15_NORM_MINUS_HALF_PI:
             errno = EDOM;
+            fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+            fxp16_stats_early_m();
             return INT16_MAX;
         case FXP16_Q15_NORM_HALF_PI:
             errno = EDOM;
+            fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+            fxp16_stats_early_m();
             return INT16_MIN;
     }
 
@@ -581,9 +636,11 @@ fxp16_t fxp16_tan(fxp16_t fp, uint8_t frac)
 
 fxp16_t fxp16_atan2(fxp16_t y_in, fxp16_t x_in)
 {
+    fxp16_stats_call_m(atan2);
     // Sonderfälle wie bei double atan2
     if (y_in == 0)
     {
+        fxp16_stats_early_m();
         if (x_in > 0) return (fxp16_t)0;
         if (x_in < 0) return (fxp16_t)FXP16_Q15_NORM_ONE_PI;      // +π
         return (fxp16_t)0;                             // atan2(0,0) -> 0 (Konvention)
@@ -591,6 +648,7 @@ fxp16_t fxp16_atan2(fxp16_t y_in, fxp16_t x_in)
 
     if (x_in == 0)
     {
+        fxp16_stats_early_m();
         fxp16_t half_pi = (fxp16_t)(FXP16_Q15_NORM_ONE_PI >> 1);   // ±π/2
         return (y_in > 0) ? half_pi : (fxp16_t)(-half_pi);
     }
@@ -646,6 +704,7 @@ fxp16_t fxp16_atan2(fxp16_t y_in, fxp16_t x_in)
 
 fxp16_t fxp16_atan(fxp16_t y, uint8_t frac)
 {
+    fxp16_stats_call_m(atan);
     fxp32_t x = FXP32_Q15_ONE;
     fxp32_t Y = y;
 
@@ -667,6 +726,7 @@ fxp16_t fxp16_atan(fxp16_t y, uint8_t frac)
 
 fxp16_t fxp16_asin(fxp16_t x)
 {
+    fxp16_stats_call_m(asin);
 
     int32_t xi = x;
 
@@ -688,6 +748,7 @@ fxp16_t fxp16_asin(fxp16_t x)
 
 fxp16_t fxp16_acos(fxp16_t x)
 {
+    fxp16_stats_call_m(acos);
 
     int32_t xi = (int32_t)x;
 
@@ -946,6 +1007,7 @@ static void fxp32_cordic_cosh_sinh_q15(fxp32_t x, fxp32_t *out_cosh, fxp32_t *ou
 
     /* --- NEU: Frühe Sättigung, bevor 2^±n berechnet wird --- */
     if (n >= 16 || n <= -16) {
+        fxp16_stats_early_m();
         fxp32_saturate_sinh_cosh_by_sign(x, out_cosh, out_sinh);
         return;
     }
@@ -1009,25 +1071,41 @@ static  inline fxp32_t fxp32_div_q15(fxp32_t num, fxp32_t den) {
 
 #define TANH_EARLY_SAT_Q15  ( (fxp32_t)(12 * FXP32_Q15_ONE) )  /* ~|x|>=12 -> ±1 */
 
+/*!
+    \brief      Q15 tanh from an already computed cosh/sinh pair
+    \details    For |x| ≥ TANH_EARLY_SAT_Q15, returns ±(1 − 2^-15); otherwise returns
+                \p s / \p c via fxp32_div_q15. Lets callers that already ran
+                fxp32_cordic_cosh_sinh_q15 derive tanh without a second CORDIC run.
+
+    \param[in]  x    Input in Q15 the pair was computed for.
+    \param[in]  c    cosh(x) in Q15.
+    \param[in]  s    sinh(x) in Q15.
+
+    \returns    \p tanh(x) in Q15, saturated to (-1, 1).
+*/
+static inline fxp32_t fxp32_tanh_from_cosh_sinh_q15(fxp32_t x, fxp32_t c, fxp32_t s) {
+    if (x >= TANH_EARLY_SAT_Q15 || x <= -TANH_EARLY_SAT_Q15) {
+        fxp16_stats_early_m();
+        return (x > 0) ? FXP32_Q15_ONE - 1 : -(FXP32_Q15_ONE - 1);
+    }
+    if (s == 0) return 0;
+    return fxp32_div_q15(s, c);
+}
+
 /*!
     \brief      Q15 tanh via hyperbolic CORDIC with early saturation
-    \details    Computes \p tanh(x) in Q15. For |x| ≥ TANH_EARLY_SAT_Q15, returns
-                ±(1 − 2^-15). Otherwise computes (\p cosh(x), \p sinh(x)) using
-                fxp32_cordic_cosh_sinh_q15, then returns \p sinh(x)/\p cosh(x) via
-                fxp32_div_q15. If \p sinh(x) == 0, returns 0.
+    \details    Computes \p tanh(x) in Q15 from (\p cosh(x), \p sinh(x)) of
+                fxp32_cordic_cosh_sinh_q15 via fxp32_tanh_from_cosh_sinh_q15. For large
+                |x| both saturate early, so no CORDIC iterations run there.
 
     \param[in]  x    Input in Q15.
 
     \returns    \p tanh(x) in Q15, saturated to (-1, 1).
 */
 static fxp32_t fxp32_cordic_tanh_q15(fxp32_t x) {
-    if (x >= TANH_EARLY_SAT_Q15)  return  FXP32_Q15_ONE - 1;
-    if (x <= -TANH_EARLY_SAT_Q15) return -(FXP32_Q15_ONE - 1);
-
     fxp32_t s, c;
     fxp32_cordic_cosh_sinh_q15(x, &c, &s);
-    if (s == 0) return 0;
-    return fxp32_div_q15(s, c);
+    return fxp32_tanh_from_cosh_sinh_q15(x, c, s);
 }
 
 
@@ -1047,6 +1125,7 @@ static fxp32_t fxp32_cordic_tanh_q15(fxp32_t x) {
 */
 fxp16_t fxp16_sinh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 {
+    fxp16_stats_call_m(sinh);
     fxp32_t fxp32_x = x;
     fxp32_t cosh, sinh;
     fpxx_ashift_m(fxp32_x, x_frac  - FXP16_Q15);
@@ -1059,6 +1138,7 @@ fxp16_t fxp16_sinh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 
 fxp16_t fxp16_cosh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 {
+    fxp16_stats_call_m(cosh);
     fxp32_t fxp32_x = x;
     fxp32_t cosh, sinh;
     fpxx_ashift_m(fxp32_x, x_frac  - FXP16_Q15);
@@ -1071,6 +1151,7 @@ fxp16_t fxp16_cosh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 
 fxp16_t fxp16_tanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 {
+    fxp16_stats_call_m(tanh);
     fxp32_t fxp32_x = x;
     fxp32_t tanh;
     fpxx_ashift_m(fxp32_x, x_frac  - FXP16_Q15);
@@ -1081,9 +1162,61 @@ fxp16_t fxp16_tanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
 }
 
 
+void fxp16_sinhcoshtanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac, fxp16_t *s, fxp16_t *c, fxp16_t *t)
+{
+    fxp16_stats_call_m(sinhcoshtanh);
+    fxp32_t fxp32_x = x;
+    fxp32_t cosh, sinh, tanh;
+    fpxx_ashift_m(fxp32_x, x_frac  - FXP16_Q15);
+    fxp32_cordic_cosh_sinh_q15(fxp32_x, &cosh, &sinh);
+
+    if (t)
+    {
+        /* derive tanh from the unscaled Q15 pair before it gets rescaled below */
+        tanh = fxp32_tanh_from_cosh_sinh_q15(fxp32_x, cosh, sinh);
+        fpxx_ashift_m(tanh, FXP16_Q15 - y_frac);
+        fxp16_sat_m(tanh);
+        *t = (fxp16_t)tanh;
+    }
+
+    if (s)
+    {
+        fpxx_ashift_m(sinh, FXP16_Q15 - y_frac);
+        fxp16_sat_m(sinh);
+        *s = (fxp16_t)sinh;
+    }
+
+    if (c)
+    {
+        fpxx_ashift_m(cosh, FXP16_Q15 - y_frac);
+        fxp16_sat_m(cosh);
+        *c = (fxp16_t)cosh;
+    }
+}
+
+
+void fxp16_sinhcosh(uint8_t y_frac, fxp16_t x, uint8_t x_frac, fxp16_t *s, fxp16_t *c)
+{
+    fxp16_sinhcoshtanh(y_frac, x, x_frac, s, c, NULL);
+}
+
+
+void fxp16_sinhcosh_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *s, fxp16_t *c, fxp16_t *t, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_sinhcoshtanh(y_frac, x[i], x_frac,
+                           s ? &s[i] : NULL,
+                           c ? &c[i] : NULL,
+                           t ? &t[i] : NULL);
+    }
+}
+
+
 
 fxp16_t fxp16_copysign(fxp16_t x, fxp16_t y)
 {
+    fxp16_stats_call_m(copysign);
    int32_t result = abs((int32_t)x);
 
    if(fxp16_signbit(y))
@@ -1099,21 +1232,6 @@ fxp16_t fxp16_copysign(fxp16_t x, fxp16_t y)
 
 
 
-/*!
-    \brief      Compute absolute value
-    \details    Returns the absolute value of x: |x|.
-
-
-    \param      x
-    \returns     absolute value of x
-
-*/
-fxp16_t fxp16_fabs (fxp16_t x)
-{
-   int32_t result = (x < 0) ? (-(int32_t)x) : ((int32_t)x);
-   fxp16_sat_m(result);
-   return result;
-}
 
 
 /*!
@@ -1127,6 +1245,7 @@ fxp16_t fxp16_fabs (fxp16_t x)
 */
 fxp16_t fxp16_abs (fxp16_t x, uint8_t frac)
 {
+    fxp16_stats_call_m(abs);
    int32_t result = (x < 0) ? (-(int32_t)x) : ((int32_t)x);
    result&=~((1<<frac)-1);
    fxp16_sat_m(result);
@@ -1137,6 +1256,7 @@ fxp16_t fxp16_abs (fxp16_t x, uint8_t frac)
 
 fxp16_t fxp16_fma (fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, fxp16_t z, uint8_t zfrac)
 {
+    fxp16_stats_call_m(fma);
    int32_t result;
    int8_t relshift = xfrac+yfrac-zfrac;
 
@@ -1147,3 +1267,264 @@ fxp16_t fxp16_fma (fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, fxp16_t z
    return (fxp16_t)result;
 }
 
+
+
+/* tanh(i/64) in Q15 for i = 0..384, saturated to 1-LSB; the last entry pads the pair load */
+const int16_t fxp16_tanh_lut_q15[FXP16_TANH_LUT_SIZE] = {
+        0,   512,  1024,  1535,  2045,  2555,  3063,  3570,  4075,  4578,  5079,  5577,
+     6073,  6566,  7056,  7542,  8025,  8505,  8980,  9452,  9919, 10382, 10840, 11294,
+    11743, 12186, 12625, 13058, 13486, 13909, 14326, 14737, 15143, 15542, 15936, 16324,
+    16706, 17082, 17452, 17816, 18173, 18525, 18870, 19209, 19542, 19869, 20189, 20504,
+    20813, 21115, 21411, 21702, 21986, 22265, 22538, 22804, 23066, 23321, 23571, 23815,
+    24054, 24287, 24516, 24738, 24956, 25168, 25376, 25578, 25776, 25969, 26157, 26340,
+    26519, 26694, 26864, 27029, 27191, 27348, 27502, 27651, 27797, 27938, 28076, 28211,
+    28341, 28469, 28592, 28713, 28830, 28944, 29055, 29163, 29268, 29370, 29470, 29566,
+    29660, 29751, 29840, 29926, 30010, 30091, 30170, 30247, 30322, 30394, 30465, 30533,
+    30600, 30664, 30727, 30788, 30847, 30904, 30960, 31014, 31067, 31118, 31167, 31215,
+    31262, 31307, 31351, 31394, 31435, 31476, 31515, 31553, 31589, 31625, 31659, 31693,
+    31726, 31757, 31788, 31817, 31846, 31874, 31901, 31928, 31953, 31978, 32002, 32025,
+    32048, 32070, 32091, 32112, 32132, 32151, 32170, 32188, 32206, 32223, 32240, 32256,
+    32271, 32287, 32301, 32316, 32329, 32343, 32356, 32368, 32381, 32392, 32404, 32415,
+    32426, 32436, 32447, 32456, 32466, 32475, 32484, 32493, 32501, 32509, 32517, 32525,
+    32532, 32540, 32547, 32553, 32560, 32566, 32573, 32579, 32584, 32590, 32596, 32601,
+    32606, 32611, 32616, 32620, 32625, 32629, 32634, 32638, 32642, 32646, 32649, 32653,
+    32657, 32660, 32663, 32667, 32670, 32673, 32676, 32678, 32681, 32684, 32686, 32689,
+    32691, 32694, 32696, 32698, 32700, 32702, 32704, 32706, 32708, 32710, 32712, 32714,
+    32715, 32717, 32718, 32720, 32721, 32723, 32724, 32726, 32727, 32728, 32729, 32731,
+    32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739, 32740, 32741, 32741, 32742,
+    32743, 32744, 32745, 32745, 32746, 32747, 32747, 32748, 32749, 32749, 32750, 32750,
+    32751, 32751, 32752, 32752, 32753, 32753, 32754, 32754, 32755, 32755, 32755, 32756,
+    32756, 32757, 32757, 32757, 32758, 32758, 32758, 32759, 32759, 32759, 32759, 32760,
+    32760, 32760, 32760, 32761, 32761, 32761, 32761, 32762, 32762, 32762, 32762, 32762,
+    32762, 32763, 32763, 32763, 32763, 32763, 32763, 32764, 32764, 32764, 32764, 32764,
+    32764, 32764, 32764, 32765, 32765, 32765, 32765, 32765, 32765, 32765, 32765, 32765,
+    32765, 32765, 32766, 32766, 32766, 32766, 32766, 32766, 32766, 32766, 32766, 32766,
+    32766, 32766, 32766, 32766, 32766, 32766, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+    32767, 32767
+};
+
+
+void fxp16_tanh_vec_scalar(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = fxp16_tanh_lut(y_frac, x[i], x_frac);
+    }
+}
+
+
+void fxp16_sigmoid_vec_scalar(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = fxp16_sigmoid_lut(y_frac, x[i], x_frac);
+    }
+}
+
+
+void fxp16_tanh_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    fxp16_stats_call_m(tanh_vec);
+    fxp16_kernels()->tanh_vec(y_frac, x, x_frac, y, n);
+}
+
+
+void fxp16_sigmoid_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    fxp16_stats_call_m(sigmoid_vec);
+    fxp16_kernels()->sigmoid_vec(y_frac, x, x_frac, y, n);
+}
+
+
+void fxp16_flt2fp_vec_scalar(const float *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = fxp16_flt2fp_elem(x[i], frac);
+    }
+}
+
+
+void fxp16_dbl2fp_vec_scalar(const double *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = fxp16_dbl2fp_elem(x[i], frac);
+    }
+}
+
+
+void fxp16_fp2flt_vec_scalar(const fxp16_t *x, float *y, size_t n, uint8_t frac)
+{
+    const float recip = 1.0f / (1 << frac);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = (float)x[i] * recip;
+    }
+}
+
+
+void fxp16_fp2dbl_vec_scalar(const fxp16_t *x, double *y, size_t n, uint8_t frac)
+{
+    const double recip = 1.0 / (1 << frac);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = (double)x[i] * recip;
+    }
+}
+
+
+void fxp16_flt2fp_vec(const float *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    fxp16_stats_call_m(flt2fp_vec);
+    fxp16_kernels()->flt2fp_vec(x, y, n, frac);
+}
+
+
+void fxp16_fp2flt_vec(const fxp16_t *x, float *y, size_t n, uint8_t frac)
+{
+    fxp16_kernels()->fp2flt_vec(x, y, n, frac);
+}
+
+
+void fxp16_dbl2fp_vec(const double *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    fxp16_stats_call_m(dbl2fp_vec);
+    fxp16_kernels()->dbl2fp_vec(x, y, n, frac);
+}
+
+
+void fxp16_fp2dbl_vec(const fxp16_t *x, double *y, size_t n, uint8_t frac)
+{
+    fxp16_kernels()->fp2dbl_vec(x, y, n, frac);
+}
+
+
+void fxp16_rshift_vec_scalar(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = (fxp16_t)fxp32_rshift_round_elem(in[i], shift);
+        fxp16_status_underflow_m(in[i] != 0, out[i]);
+    }
+}
+
+
+void fxp16_lshift_sat_vec_scalar(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp32_t v = (fxp32_t)in[i] * (1 << shift);
+        fxp16_sat_m(v);
+        out[i] = (fxp16_t)v;
+    }
+}
+
+
+void fxp16_narrow_vec_scalar(const fxp32_t *in, fxp16_t *out, size_t n, int shift)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i] = fxp16_requant32(in[i], shift);
+    }
+}
+
+
+void fxp16_fp2fp_vec(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t fracold, uint8_t fracnew)
+{
+    fxp16_stats_call_m(fp2fp_vec);
+    if (fracold > fracnew)
+    {
+        fxp16_kernels()->rshift_vec(in, out, n, fracold - fracnew);
+    }
+    else if (fracold < fracnew)
+    {
+        fxp16_kernels()->lshift_sat_vec(in, out, n, fracnew - fracold);
+    }
+    else if (in != out)
+    {
+        memmove(out, in, n * sizeof(*out));
+    }
+}
+
+
+void fxp16_narrow_vec(const fxp32_t *in, fxp16_t *out, size_t n, uint8_t fracold, uint8_t fracnew)
+{
+    fxp16_stats_call_m(narrow_vec);
+    fxp16_kernels()->narrow_vec(in, out, n, (int)fracold - (int)fracnew);
+}
+
+
+/* one loop per mode so that each is branch free and vectorizes */
+#define FXP16_ROUND_LOOP_M(mode)                                        \
+    for (size_t i = 0; i < n; i++)                                      \
+    {                                                                   \
+        fxp32_t r = fxp16_round_elem(x[i], frac, mode) >> shift;        \
+        fxp16_sat_m(r);                                                 \
+        y[i] = (fxp16_t)r;                                              \
+    }                                                                   \
+    break
+
+void fxp16_round_vec_scalar(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode, uint8_t shift)
+{
+    if (frac == 0)
+    {
+        if (x != y) memmove(y, x, n * sizeof(*y));
+        return;
+    }
+
+    switch (mode)
+    {
+        case FXP16_ROUND_NEAREST_EVEN:  FXP16_ROUND_LOOP_M(FXP16_ROUND_NEAREST_EVEN);
+        case FXP16_ROUND_FLOOR:         FXP16_ROUND_LOOP_M(FXP16_ROUND_FLOOR);
+        case FXP16_ROUND_CEIL:          FXP16_ROUND_LOOP_M(FXP16_ROUND_CEIL);
+        case FXP16_ROUND_TRUNC:         FXP16_ROUND_LOOP_M(FXP16_ROUND_TRUNC);
+        case FXP16_ROUND_HALF_UP:       FXP16_ROUND_LOOP_M(FXP16_ROUND_HALF_UP);
+        default:                        FXP16_ROUND_LOOP_M(FXP16_ROUND_NEAREST_AWAY);
+    }
+}
+
+#undef FXP16_ROUND_LOOP_M
+
+
+void fxp16_round_vec(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode)
+{
+    fxp16_stats_call_m(round_vec);
+    fxp16_kernels()->round_vec(x, y, n, frac, mode, 0);
+}
+
+
+void fxp16_lround_vec(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode)
+{
+    fxp16_stats_call_m(round_vec);
+    fxp16_kernels()->round_vec(x, y, n, frac, mode, frac);
+}
+
+
+void fxp16_remquo_vec(const fxp16_t *x, fxp16_t *r, int *quo, size_t n, uint8_t xfrac, fxp16_t y, uint8_t yfrac)
+{
+    fxp16_stats_call_m(remainder_vec);
+    fxp16_fmod_const_t c;
+
+    if (fxp16_fmod_const_init(&c, xfrac, y, yfrac) != 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        fxp16_stats_early_m();
+        memset(r, 0, n * sizeof(*r));
+        if (quo) memset(quo, 0, n * sizeof(*quo));
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t an = (uint32_t)abs(x[i]) << yfrac;
+        uint32_t k  = (uint32_t)(((uint64_t)an * c.magic) >> c.shift);
+
+        r[i] = fxp16_remquo_elem(x[i], xfrac, y, yfrac, k, quo ? &quo[i] : NULL);
+    }
+}
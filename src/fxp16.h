@@ -44,6 +44,8 @@
 #warning "This lib is still in development"
 
 #include <stdint.h>
+#include <stddef.h>
+#include "fxp16_stats.h"
 
 
 
@@ -681,12 +683,116 @@ typedef int16_t fxp16_t;
 typedef int32_t fxp32_t;
 
 
+/*!
+    \brief      Enables sticky status flags
+    \details    1 = saturation, underflow to zero, domain errors and divisions by zero
+                raise FXP16_STATUS_* flags in a thread local status word, which
+                fxp16_status_get_and_clear() reads back for a whole block of work.
+                The batched *_vec entry points then run their scalar kernels so that
+                every element is accounted for.
+                0 = the flag macros compile to nothing (default).
+*/
+#ifndef FXP16CONF_STATUS_FLAGS
+#define FXP16CONF_STATUS_FLAGS      0
+#endif
+
+
+/*!
+    \brief      Header inline fast path for the trivial arithmetic functions
+    \details    1 = fxp16_add(), fxp16_sub(), fxp16_mult(), fxp16_fabs(), fxp16_sat() and
+                fxp16_arshift() are static inline definitions from fxp16_inline.h, so loops
+                built from them can be inlined and vectorized. Semantics, status flags and
+                stats counters are identical to the out-of-line functions, which the library
+                exports in either case.
+                0 = plain out-of-line calls (default).
+*/
+#ifndef FXP16CONF_INLINE
+#define FXP16CONF_INLINE            0
+#endif
+
+/* fxp16.c defines FXP16_INLINE_DEF empty to emit the exported definitions */
+#if FXP16CONF_INLINE || defined(FXP16_INLINE_DEF)
+#define FXP16_INLINE_API            1
+#else
+#define FXP16_INLINE_API            0
+#endif
+
+#define FXP16_STATUS_OVERFLOW       0x01    /*!< \brief A result was saturated */
+#define FXP16_STATUS_UNDERFLOW      0x02    /*!< \brief A nonzero result was rounded to zero */
+#define FXP16_STATUS_DOMAIN         0x04    /*!< \brief Argument outside the function's domain */
+#define FXP16_STATUS_DIVBYZERO      0x08    /*!< \brief Division by zero */
+
+/*! \brief Storage class of per-thread library state (status flags, stats counters) */
+#ifndef FXP16_THREAD_LOCAL
+    #if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+        #define FXP16_THREAD_LOCAL  _Thread_local
+    #elif defined(__GNUC__)
+        #define FXP16_THREAD_LOCAL  __thread
+    #else
+        #define FXP16_THREAD_LOCAL  /* single threaded target */
+    #endif
+#endif
+
+#if FXP16CONF_STATUS_FLAGS
+
+    extern FXP16_THREAD_LOCAL uint8_t fxp16_status_flags;
+
+    #define fxp16_status_raise_m(flags) \
+        do{ fxp16_status_flags |= (uint8_t)(flags); }while(0)
+
+    #define fxp16_status_underflow_m(nonzero,result) \
+        do{ if ((nonzero) && (result) == 0) fxp16_status_raise_m(FXP16_STATUS_UNDERFLOW); }while(0)
+
+#else
+
+    #define fxp16_status_raise_m(flags)                 do{}while(0)
+    #define fxp16_status_underflow_m(nonzero,result)    do{ (void)(nonzero); }while(0)
+
+#endif
+
+/*!
+    \brief      Reads the sticky status flags of the calling thread
+    \returns    OR of the FXP16_STATUS_* flags raised so far, 0 if FXP16CONF_STATUS_FLAGS is 0
+*/
+uint8_t fxp16_status_get(void);
+
+/*!
+    \brief      Reads and clears the sticky status flags of the calling thread
+    \details    Intended to be polled once per block instead of per sample.
+    \returns    OR of the FXP16_STATUS_* flags raised since the last clear
+*/
+uint8_t fxp16_status_get_and_clear(void);
+
+
+/*!
+    \brief      Hook run by fpxx_sat_m whenever it clamps
+    \details    Raises FXP16_STATUS_OVERFLOW (FXP16CONF_STATUS_FLAGS) and counts the
+                saturation (FXP16CONF_STATS).
+*/
+#define fpxx_sat_event_m() \
+    do{ fxp16_status_raise_m(FXP16_STATUS_OVERFLOW); fxp16_stats_sat_m(); }while(0)
+
 /*!
     \brief      Macro that saturates a result to min and max
-    \details    This macro limits a variable to a minimum and maximum value
+    \details    This macro limits a variable to a minimum and maximum value.
+                Clamping runs fpxx_sat_event_m if status flags or stats are enabled.
     \param   var     Variable to be limited. Has to be able to hold minimum or maximum value.
 */
+#if FXP16CONF_STATUS_FLAGS || FXP16CONF_STATS
 #define fpxx_sat_m(var,min,max) \
+    do{ if (var<min) { var=(min); fpxx_sat_event_m(); } \
+        else if (var>max) { var=(max); fpxx_sat_event_m(); } }while(0)
+#else
+#define fpxx_sat_m(var,min,max) \
+    do{var=(var<min)?(min):((var>max)?(max):(var));}while(0)
+#endif
+
+/*!
+    \brief      Macro that limits an intermediate value to min and max
+    \details    Like fpxx_sat_m but never raises a status flag. For internal
+                guard clamps that are not a saturation of the result.
+*/
+#define fpxx_clamp_m(var,min,max) \
     do{var=(var<min)?(min):((var>max)?(max):(var));}while(0)
 
 
@@ -700,7 +806,9 @@ typedef int32_t fxp32_t;
 #define fxp16_sat_m(var) \
         fpxx_sat_m(var,INT16_MIN,INT16_MAX)
 
+#if !FXP16_INLINE_API
 fxp16_t fxp16_sat(fxp32_t fxp32);
+#endif
 
 
 /*!
@@ -751,7 +859,9 @@ fxp16_t fxp16_sat(fxp32_t fxp32);
 
 
 #if FXP16CONF_ARSHIFT_W_ROUNDING
+    #if !FXP16_INLINE_API
     fxp32_t fxp32_arshift(fxp32_t var,uint8_t rshift);
+    #endif
 #else
     #define fxp32_arshift(var,rshift)    ((var)>>rshift)
 #endif
@@ -759,7 +869,9 @@ fxp16_t fxp16_sat(fxp32_t fxp32);
 
 
 #if FXP16CONF_ARSHIFT_W_ROUNDING
+    #if !FXP16_INLINE_API
     fxp16_t fxp16_arshift(fxp16_t fp, uint8_t shift);
+    #endif
 #else
     #define fxp16_arshift(var,rshift)    ((var)>>rshift)
 #endif
@@ -816,8 +928,90 @@ fxp16_t fxp16_sat(fxp32_t fxp32);
 /* fixed point conversions */
 fxp16_t fxp16_flt2fp(float var, uint8_t frac);
 float fxp16_fp2flt(fxp16_t var, uint8_t frac);
+
+/*!
+    \brief      Converts a double to a fixed point type
+    \details    Double precision counterpart of fxp16_flt2fp: scaled by 2^frac, rounded
+                half away from zero and saturated to the fixed point limits.
+    \param[in]  var     Double variable to be converted
+    \param[in]  frac    Number of fracional bits
+
+    \returns    Fixed point interpretation of provided floating point number
+*/
+fxp16_t fxp16_dbl2fp(double var, uint8_t frac);
+
+/*!
+    \brief      Converts a fixed point type to double
+    \param[in]  var     Fixed point variable to be converted
+    \param[in]  frac    Number of fracional bits
+
+    \returns    Double interpretation of provided fixed point number
+*/
+double fxp16_fp2dbl(fxp16_t var, uint8_t frac);
+
+/*!
+    \brief      Converts a float array to fixed point
+    \details    Bit-identical to fxp16_flt2fp per element (round half away from zero,
+                saturation, infinities saturate). NaN converts to 0.
+                Uses SIMD truncate/compare rounding and saturating packs where available.
+    \param[in]  x       Float array
+    \param[out] y       Fixed point array
+    \param[in]  n       Number of elements
+    \param[in]  frac    Number of fracional bits of \p y
+*/
+void fxp16_flt2fp_vec(const float *x, fxp16_t *y, size_t n, uint8_t frac);
+
+/*!
+    \brief      Converts a fixed point array to float
+    \details    Bit-identical to fxp16_fp2flt per element; the division by 2^frac is a
+                multiplication by its exact reciprocal.
+    \param[in]  x       Fixed point array
+    \param[out] y       Float array
+    \param[in]  n       Number of elements
+    \param[in]  frac    Number of fracional bits of \p x
+*/
+void fxp16_fp2flt_vec(const fxp16_t *x, float *y, size_t n, uint8_t frac);
+
+/*!
+    \brief      Converts a double array to fixed point
+    \details    Bit-identical to fxp16_dbl2fp per element, NaN converts to 0.
+*/
+void fxp16_dbl2fp_vec(const double *x, fxp16_t *y, size_t n, uint8_t frac);
+
+/*!
+    \brief      Converts a fixed point array to double
+    \details    Bit-identical to fxp16_fp2dbl per element.
+*/
+void fxp16_fp2dbl_vec(const fxp16_t *x, double *y, size_t n, uint8_t frac);
+
 fxp16_t fxp16_int2fp(int16_t intpart, uint8_t frac);
 fxp16_t fxp16_fp2fp(fxp16_t fp, uint8_t fracold, uint8_t fracnew);
+
+/*!
+    \brief      Converts a fixed point array between number formats (Qx.y)
+    \details    Bit-identical to fxp16_fp2fp per element. The shift direction is
+                resolved once per call; the rounding right shift and the saturating
+                left shift kernels are branch free and vectorized where available.
+    \param[in]  in          Fixed point array
+    \param[out] out         Converted array, may be \p in
+    \param[in]  n           Number of elements
+    \param[in]  fracold     Old number of fracional bits
+    \param[in]  fracnew     New number of fracional bits
+*/
+void fxp16_fp2fp_vec(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t fracold, uint8_t fracnew);
+
+/*!
+    \brief      Narrows 32 bit accumulators to fixed point
+    \details    out[i] = in[i] converted from Q\p fracold to Q\p fracnew, right shifts
+                round like fxp32_arshift, left shifts and the narrowing saturate to the
+                fxp16 range. Typical use is the result of a MAC loop in Q(a_frac + b_frac).
+    \param[in]  in          32 bit array
+    \param[out] out         Fixed point array; may start at the same address as \p in
+    \param[in]  n           Number of elements
+    \param[in]  fracold     Fractional bits of \p in, 0..31
+    \param[in]  fracnew     Fractional bits of \p out, 0..31
+*/
+void fxp16_narrow_vec(const fxp32_t *in, fxp16_t *out, size_t n, uint8_t fracold, uint8_t fracnew);
 fxp16_t fxp16_rshift(fxp16_t fp, uint8_t shift);
 fxp16_t fxp16_lshift(fxp16_t fp, uint8_t shift);
 
@@ -859,9 +1053,11 @@ fxp16_t fxp16_cbrt(fxp16_t s, uint8_t sfrac);
 #define fxp16_fp2int(fp,frac) fxp16_lround(fp,frac)
 
 /* Basic math operations */
+#if !FXP16_INLINE_API
 fxp16_t fxp16_add(fxp16_t summand1, fxp16_t summand2);
 fxp16_t fxp16_sub(fxp16_t minuend, fxp16_t subtrahend);
 fxp16_t fxp16_mult(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2);
+#endif
 fxp16_t fxp16_div(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t frac2);
 
 
@@ -1053,6 +1249,90 @@ fxp16_t fxp16_cosh(uint8_t y_frac, fxp16_t x, uint8_t  x_frac);
 */
 fxp16_t fxp16_tanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac);
 
+/*!
+    \brief      fxp16 sinh, cosh and tanh from a single CORDIC run
+    \details    Computes \p sinh(x), \p cosh(x) and \p tanh(x) for the same \p x with one
+                range reduction and one hyperbolic CORDIC evaluation. tanh is derived from
+                the internal Q15 pair, so every output is bit-identical to the result of
+                fxp16_sinh, fxp16_cosh and fxp16_tanh respectively.
+                Any output pointer may be NULL if that result is not needed.
+
+    \param[in]  y_frac   Fractional-bit count of the result format (fxp16 Qy_frac).
+    \param[in]  x        fxp16 input value.
+    \param[in]  x_frac   Fractional-bit count of the input format (fxp16 Qx_frac).
+    \param[out] s        Destination for \p sinh(x) in Qy_frac, or NULL.
+    \param[out] c        Destination for \p cosh(x) in Qy_frac, or NULL.
+    \param[out] t        Destination for \p tanh(x) in Qy_frac, or NULL.
+*/
+void fxp16_sinhcoshtanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac, fxp16_t *s, fxp16_t *c, fxp16_t *t);
+
+/*!
+    \brief      fxp16 sinh and cosh from a single CORDIC run
+    \details    Same as fxp16_sinhcoshtanh without the tanh output.
+
+    \param[in]  y_frac   Fractional-bit count of the result format (fxp16 Qy_frac).
+    \param[in]  x        fxp16 input value.
+    \param[in]  x_frac   Fractional-bit count of the input format (fxp16 Qx_frac).
+    \param[out] s        Destination for \p sinh(x) in Qy_frac, or NULL.
+    \param[out] c        Destination for \p cosh(x) in Qy_frac, or NULL.
+*/
+void fxp16_sinhcosh(uint8_t y_frac, fxp16_t x, uint8_t x_frac, fxp16_t *s, fxp16_t *c);
+
+/*!
+    \brief      Array form of fxp16_sinhcoshtanh
+    \details    Evaluates fxp16_sinhcoshtanh for \p n elements of \p x. Output arrays
+                may be NULL if that result is not needed.
+
+    \param[in]  y_frac   Fractional-bit count of the result format (fxp16 Qy_frac).
+    \param[in]  x        Array of \p n fxp16 input values.
+    \param[in]  x_frac   Fractional-bit count of the input format (fxp16 Qx_frac).
+    \param[out] s        Array of \p n sinh results, or NULL.
+    \param[out] c        Array of \p n cosh results, or NULL.
+    \param[out] t        Array of \p n tanh results, or NULL.
+    \param[in]  n        Number of elements.
+*/
+void fxp16_sinhcosh_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *s, fxp16_t *c, fxp16_t *t, size_t n);
+
+/*!
+    \brief      Fast array tanh for activation layers
+    \details    Evaluates tanh(x) for \p n elements using a 385-knot Q15 table on [0, 6]
+                with linear interpolation (|x| is read as Q16, so no input bits are lost),
+                odd symmetry and a single rounding to the output format. Uses vector lanes
+                where the target supports them; all variants are bit-identical.
+
+                fxp16_tanh remains the reference path. Measured over the full 16-bit
+                input space for every (x_frac, y_frac) pair the deviation from fxp16_tanh
+                is at most 1 LSB of the output format for y_frac <= 12, 2 LSB for
+                y_frac = 13, 4 LSB for y_frac = 14 and 9 LSB for y_frac = 15. At Q15 most
+                of that is the CORDIC error of the reference itself; against the exact
+                tanh the table path stays within 1.6 LSB.
+
+    \param[in]  y_frac   Fractional-bit count of the result format, 0..15.
+    \param[in]  x        Array of \p n fxp16 input values.
+    \param[in]  x_frac   Fractional-bit count of the input format, 0..15.
+    \param[out] y        Array of \p n results in Qy_frac. May alias \p x.
+    \param[in]  n        Number of elements.
+*/
+void fxp16_tanh_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+
+/*!
+    \brief      Fast array sigmoid for activation layers
+    \details    Evaluates 1 / (1 + e^-x) = (1 + tanh(x/2)) / 2 for \p n elements with the
+                same table as fxp16_tanh_vec. The result is formed in Q16, rounded once
+                and saturated, so sigmoid(x) = 1.0 yields the format maximum.
+
+                Measured against (1 + fxp16_tanh(x/2)) / 2 over the full 16-bit input
+                space the deviation is at most 1 LSB of the output format for
+                y_frac <= 12, 2 LSB for y_frac = 13..14 and 4 LSB for y_frac = 15.
+
+    \param[in]  y_frac   Fractional-bit count of the result format, 0..15.
+    \param[in]  x        Array of \p n fxp16 input values.
+    \param[in]  x_frac   Fractional-bit count of the input format, 0..15.
+    \param[out] y        Array of \p n results in Qy_frac. May alias \p x.
+    \param[in]  n        Number of elements.
+*/
+void fxp16_sigmoid_vec(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+
 /*!
     \defgroup   fxp16_rounding Rounding and remainder functions
     \brief      Fixed-point rounding utilities and remainder computation.
@@ -1068,6 +1348,11 @@ fxp16_t fxp16_tanh(uint8_t y_frac, fxp16_t x, uint8_t x_frac);
             - \ref fxp16_round – round to nearest, halfway cases away from zero.
             - \ref fxp16_fmod  – remainder with truncated quotient (like C \c fmod).
             - \ref fxp16_lround – round to nearest and cast to \c int.
+            - \ref fxp16_rint / \ref fxp16_nearbyint – round to nearest, halfway cases to even.
+            - \ref fxp16_remainder / \ref fxp16_remquo – remainder with the quotient rounded
+              to nearest even (IEC 60559).
+            - \ref fxp16_round_vec / \ref fxp16_lround_vec – branch free array rounding with a
+              selectable \ref fxp16_round_mode_t, plus \ref fxp16_remquo_vec for a fixed divisor.
 
             **Notes**
             - All rounding functions interpret \p xfrac as the number of fractional bits
@@ -1149,6 +1434,166 @@ fxp16_t fxp16_fmod(fxp16_t divident, uint8_t frac1, fxp16_t divisor, uint8_t fra
 */
 int fxp16_lround(fxp16_t fp, uint8_t frac);
 
+/*!
+    \brief      Round to integral value
+    \details    Returns the integral value nearest to x, with halfway cases rounded to even
+                (the IEC 60559 default rounding of C's rint). Saturates like fxp16_ceil().
+
+    \param      x       Value to round.
+    \param      xfrac   Number of fractional bits for x.
+    \return     The value of x rounded to the nearest integral (as a fixed-point value).
+*/
+fxp16_t fxp16_rint(fxp16_t x, uint8_t xfrac);
+/*!
+    \brief      Round to nearby integral value
+    \details    Same as fxp16_rint(); fixed point has no inexact exception to suppress.
+*/
+#define fxp16_nearbyint(x,xfrac) fxp16_rint(x,xfrac)
+/*!
+    \brief      Compute remainder and quotient
+    \details    Returns x - n * y, where n is x/y rounded to the nearest integer with
+                halfway cases to even, so the magnitude of the result does not exceed |y|/2.
+                The product n * y is rounded to the format of x like in fxp16_fmod().
+
+    \param      x       Value of the quotient numerator.
+    \param      xfrac   Number of fractional bits for x.
+    \param      y       Value of the quotient denominator.
+    \param      yfrac   Number of fractional bits for y.
+    \param[out] quo     The full quotient n, may be NULL. (C's remquo only guarantees its
+                        low three bits.)
+    \return     The remainder in the format of x. 0 and a domain error if y is zero.
+*/
+fxp16_t fxp16_remquo(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, int *quo);
+/*!
+    \brief      Compute remainder (IEC 60559)
+    \details    fxp16_remquo() without the quotient.
+*/
+fxp16_t fxp16_remainder(fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac);
+
+
+/*! \brief Rounding mode of the array rounding functions */
+typedef enum {
+    FXP16_ROUND_NEAREST_AWAY,   /*!< \brief halfway cases away from zero, like fxp16_round() */
+    FXP16_ROUND_NEAREST_EVEN,   /*!< \brief halfway cases to even, like fxp16_rint() */
+    FXP16_ROUND_FLOOR,          /*!< \brief toward -inf, like fxp16_floor() */
+    FXP16_ROUND_CEIL,           /*!< \brief toward +inf, like fxp16_ceil() */
+    FXP16_ROUND_TRUNC,          /*!< \brief toward zero, like fxp16_trunc() */
+    FXP16_ROUND_HALF_UP,        /*!< \brief halfway cases toward +inf, like fpxx_arshift_m() on positives */
+    FXP16_ROUND_STOCHASTIC,     /*!< \brief up with probability of the discarded fraction, needs a fxp16_rng_t */
+} fxp16_round_mode_t;
+
+/*!
+    \brief      Rounds an array to integral values
+    \details    y[i] = x[i] rounded to an integral value in the format of x, saturated.
+                Branch free and vectorized. In-place operation (x == y) is allowed.
+
+    \param[in]  x       Values to round.
+    \param[out] y       Rounded values, same format as x.
+    \param[in]  n       Number of elements.
+    \param[in]  frac    Number of fractional bits of x.
+    \param[in]  mode    Rounding mode. FXP16_ROUND_STOCHASTIC needs generator state and is
+                        rounded like FXP16_ROUND_NEAREST_AWAY here.
+*/
+void fxp16_round_vec(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode);
+/*!
+    \brief      Rounds an array and converts it to integers
+    \details    Like fxp16_round_vec(), but y[i] holds the integral value itself (Q0), as
+                fxp16_lround() does for FXP16_ROUND_NEAREST_AWAY.
+*/
+void fxp16_lround_vec(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode);
+/*! \brief Array form of fxp16_rint() */
+#define fxp16_rint_vec(x,y,n,frac)      fxp16_round_vec(x,y,n,frac,FXP16_ROUND_NEAREST_EVEN)
+/*! \brief Array form of fxp16_nearbyint() */
+#define fxp16_nearbyint_vec(x,y,n,frac) fxp16_round_vec(x,y,n,frac,FXP16_ROUND_NEAREST_EVEN)
+/*!
+    \brief      Remainders and quotients of an array by a fixed divisor
+    \details    r[i] = fxp16_remquo(x[i], xfrac, y, yfrac, &quo[i]). The division is
+                replaced by a reciprocal multiplication computed once per call.
+                In-place operation (x == r) is allowed.
+
+    \param[in]  x       Numerators.
+    \param[out] r       Remainders, same format as x.
+    \param[out] quo     Quotients, may be NULL.
+    \param[in]  n       Number of elements.
+    \param[in]  xfrac   Number of fractional bits for x.
+    \param[in]  y       Denominator.
+    \param[in]  yfrac   Number of fractional bits for y.
+*/
+void fxp16_remquo_vec(const fxp16_t *x, fxp16_t *r, int *quo, size_t n, uint8_t xfrac, fxp16_t y, uint8_t yfrac);
+/*! \brief Array form of fxp16_remainder() */
+#define fxp16_remainder_vec(x,r,n,xfrac,y,yfrac) fxp16_remquo_vec(x,r,NULL,n,xfrac,y,yfrac)
+
+/*! @} */
+
+
+/*!
+    \defgroup   fxp16_round_mode Per-call rounding of right shifts
+    \brief      fxp32_arshift(), fxp16_mult() and fxp16_fp2fp() with a rounding mode argument.
+
+    \details    FXP16CONF_ARSHIFT_W_ROUNDING selects one rounding for the whole library:
+                halfway cases up for positive values, floor for negative ones, which biases
+                long accumulations such as IIR filters. The *_mode variants take the
+                rounding per call, so every pipeline stage can use the cheapest mode that
+                is unbiased enough for it:
+
+                - FXP16_ROUND_FLOOR: plain arithmetic shift, cheapest, biased by -1/2 LSB.
+                - FXP16_ROUND_HALF_UP: one add, biased by +1/2^(shift+1) LSB.
+                - FXP16_ROUND_NEAREST_EVEN: unbiased, deterministic.
+                - FXP16_ROUND_STOCHASTIC: unbiased in expectation, also for signals that
+                  sit below one LSB; draws from a caller-owned xorshift32 generator.
+
+                The other fxp16_round_mode_t values are accepted as well. With
+                FXP16CONF_INLINE the variants are inlined, so constant modes fold away.
+@{
+*/
+
+/*! \brief xorshift32 generator state of FXP16_ROUND_STOCHASTIC, one per thread or stream */
+typedef struct {
+    uint32_t state;     /*!< never zero */
+} fxp16_rng_t;
+
+/*!
+    \brief      Seeds a generator
+    \param[out] rng     Generator
+    \param[in]  seed    Any value, 0 selects a fixed nonzero seed
+*/
+static inline void fxp16_rng_seed(fxp16_rng_t *rng, uint32_t seed)
+{
+    rng->state = seed ? seed : 0x9E3779B9u;
+}
+
+/*!
+    \brief      Next 32 random bits (xorshift32, period 2^32 - 1)
+*/
+static inline uint32_t fxp16_rng_next(fxp16_rng_t *rng)
+{
+    uint32_t s = rng->state;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return rng->state = s;
+}
+
+#if !FXP16_INLINE_API
+/*!
+    \brief      Right shift with a rounding mode
+    \param      var     Value to shift
+    \param      rshift  Number of bits, 0..31
+    \param      mode    Rounding mode
+    \param      rng     Generator, only used (and required) by FXP16_ROUND_STOCHASTIC
+    \returns    var / 2^rshift rounded by mode
+*/
+fxp32_t fxp32_arshift_mode(fxp32_t var, uint8_t rshift, fxp16_round_mode_t mode, fxp16_rng_t *rng);
+/*!
+    \brief      fxp16_mult() with a rounding mode for the product
+*/
+fxp16_t fxp16_mult_mode(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2, fxp16_round_mode_t mode, fxp16_rng_t *rng);
+/*!
+    \brief      fxp16_fp2fp() with a rounding mode for conversions to fewer fractional bits
+*/
+fxp16_t fxp16_fp2fp_mode(fxp16_t fp, uint8_t fracold, uint8_t fracnew, fxp16_round_mode_t mode, fxp16_rng_t *rng);
+#endif
+
 /*! @} */
 
 
@@ -1224,7 +1669,9 @@ fxp16_t fxp16_copysign(fxp16_t x, fxp16_t y);
 
 
 /* functions to compute common mathematical operations and transformations */
+#if !FXP16_INLINE_API
 fxp16_t fxp16_fabs (fxp16_t x);
+#endif
 fxp16_t fxp16_abs (fxp16_t x, uint8_t frac);
 
 
@@ -1319,4 +1766,9 @@ fxp16_t fxp16_fma (fxp16_t x, uint8_t xfrac, fxp16_t y, uint8_t yfrac, fxp16_t z
 */
 #define fxp16_signbit(x) (x<0)
 
+
+#if FXP16_INLINE_API
+#include "fxp16_inline.h"
+#endif
+
 #endif /* _FXP16_H_ */
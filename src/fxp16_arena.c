@@ -0,0 +1,143 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_arena.c
+
+    \brief  Bump allocator for the buffers of fxp16 objects
+*/
+
+#if defined(__APPLE__) && !defined(_DARWIN_C_SOURCE)
+    #define _DARWIN_C_SOURCE    /* MAP_ANON */
+#elif !defined(_DEFAULT_SOURCE)
+    #define _DEFAULT_SOURCE     /* MAP_ANONYMOUS */
+#endif
+
+#include "fxp16_arena.h"
+#include <stdint.h>
+#include <string.h>
+
+#if FXP16CONF_ARENA_MMAP
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+
+int fxp16_arena_init(fxp16_arena_t *a, void *mem, size_t size)
+{
+    uintptr_t p = (uintptr_t)mem;
+    size_t skip = (size_t)(FXP16_ARENA_SIZE(p) - p);
+
+    memset(a, 0, sizeof(*a));
+
+    if (mem == NULL)
+    {
+        return -1;
+    }
+
+    /* whole allocation units only, so the last bytes left can always be taken */
+    a->base = (unsigned char *)mem + ((skip < size) ? skip : size);
+    a->size = ((skip < size) ? size - skip : 0) & ~(size_t)(FXP16_ARENA_ALIGN - 1);
+    return 0;
+}
+
+
+int fxp16_arena_init_mapped(fxp16_arena_t *a, size_t size)
+{
+#if FXP16CONF_ARENA_MMAP
+    long   page  = sysconf(_SC_PAGESIZE);
+    size_t bytes = (page > 0) ? (size + (size_t)page - 1) / (size_t)page * (size_t)page : size;
+    int    flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void  *map;
+
+#if defined(MAP_POPULATE)
+    flags |= MAP_POPULATE;
+#endif
+
+    memset(a, 0, sizeof(*a));
+
+    if (bytes == 0)
+    {
+        return -1;
+    }
+
+    map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (map == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    /* MAP_POPULATE is a hint and not everywhere; writing makes sure */
+    for (size_t off = 0; page > 0 && off < bytes; off += (size_t)page)
+    {
+        ((volatile unsigned char *)map)[off] = 0;
+    }
+
+    a->base     = (unsigned char *)map;
+    a->size     = size & ~(size_t)(FXP16_ARENA_ALIGN - 1);
+    a->map      = map;
+    a->map_size = bytes;
+    return 0;
+#else
+    (void)size;
+    memset(a, 0, sizeof(*a));
+    return -1;
+#endif
+}
+
+
+void fxp16_arena_free(fxp16_arena_t *a)
+{
+#if FXP16CONF_ARENA_MMAP
+    if (a->map)
+    {
+        munmap(a->map, a->map_size);
+    }
+#endif
+    memset(a, 0, sizeof(*a));
+}
+
+
+void *fxp16_arena_alloc(fxp16_arena_t *a, size_t bytes)
+{
+    size_t need = FXP16_ARENA_SIZE(bytes);
+    void *p;
+
+    if (need < bytes || need > a->size - a->used)
+    {
+        return NULL;
+    }
+
+    p = a->base + a->used;
+    a->used += need;
+    if (a->used > a->peak)
+    {
+        a->peak = a->used;
+    }
+    return p;
+}
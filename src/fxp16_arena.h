@@ -0,0 +1,140 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_arena.h
+
+    \brief  Bump allocator for the buffers of fxp16 objects
+
+    \details Objects with buffers (Goertzel banks, sliding DFTs, rings, block floating
+             point arrays, lookup tables, pipelines) can take them from an arena
+             instead of from malloc(). An arena hands out FXP16_ARENA_ALIGN aligned
+             pieces of one region by advancing an offset. Memory comes back only as
+             a whole, with fxp16_arena_release(), so nothing in a real-time path
+             allocates or frees.
+
+             Every object with an _init_arena() function also has a _bytes()
+             function. It returns exactly what the init takes from the arena, so the
+             sum of the _bytes() of all objects is the arena size to reserve.
+
+             The region is supplied by the caller or, with fxp16_arena_init_mapped(),
+             mapped anonymously with all pages touched up front.
+*/
+
+#ifndef _FXP16_ARENA_H_
+#define _FXP16_ARENA_H_
+
+#include <stddef.h>
+
+
+/*! \brief Alignment of every arena allocation, a cache line */
+#define FXP16_ARENA_ALIGN           64
+
+/*! \brief Builds fxp16_arena_init_mapped(), needs mmap() */
+#ifndef FXP16CONF_ARENA_MMAP
+    #if defined(__unix__) || defined(__APPLE__)
+        #define FXP16CONF_ARENA_MMAP    1
+    #else
+        #define FXP16CONF_ARENA_MMAP    0
+    #endif
+#endif
+
+/*! \brief Arena bytes taken by an allocation of \p bytes */
+#define FXP16_ARENA_SIZE(bytes)     (((size_t)(bytes) + FXP16_ARENA_ALIGN - 1) & ~(size_t)(FXP16_ARENA_ALIGN - 1))
+
+
+/*! \brief Arena */
+typedef struct {
+    unsigned char *base;    /*!< FXP16_ARENA_ALIGN aligned */
+    size_t         size;
+    size_t         used;
+    size_t         peak;    /*!< largest used so far */
+    void          *map;     /*!< mapping of fxp16_arena_init_mapped(), else NULL */
+    size_t         map_size;
+} fxp16_arena_t;
+
+
+/*!
+    \brief      Sets up an arena on caller memory
+    \details    The start is rounded up and the usable size down to FXP16_ARENA_ALIGN;
+                an aligned region of FXP16_ARENA_SIZE(n) bytes yields all of them.
+    \param[out] a       Arena
+    \param[in]  mem     Region, owned by the caller
+    \param[in]  size    Bytes in \p mem
+    \returns    0 on success, -1 if \p mem is NULL
+*/
+int fxp16_arena_init(fxp16_arena_t *a, void *mem, size_t size);
+
+/*!
+    \brief      Sets up an arena on an anonymous mapping
+    \details    All pages are touched before returning, so first use does not fault.
+                Release the mapping with fxp16_arena_free().
+    \param[out] a       Arena
+    \param[in]  size    Usable bytes, rounded down to FXP16_ARENA_ALIGN
+    \returns    0 on success, -1 on a failed mapping or without FXP16CONF_ARENA_MMAP
+*/
+int fxp16_arena_init_mapped(fxp16_arena_t *a, size_t size);
+
+/*!
+    \brief      Unmaps the region of fxp16_arena_init_mapped(), no-op for caller memory
+*/
+void fxp16_arena_free(fxp16_arena_t *a);
+
+/*!
+    \brief      Takes FXP16_ARENA_SIZE(bytes) bytes
+    \details    The memory is not cleared.
+    \returns    FXP16_ARENA_ALIGN aligned memory, NULL if the arena is too small
+*/
+void *fxp16_arena_alloc(fxp16_arena_t *a, size_t bytes);
+
+/*! \brief Current fill level, to be passed to fxp16_arena_release() */
+static inline size_t fxp16_arena_mark(const fxp16_arena_t *a)
+{
+    return a->used;
+}
+
+/*!
+    \brief      Gives back everything allocated after \p mark
+    \details    Objects initialized from that memory must no longer be used.
+*/
+static inline void fxp16_arena_release(fxp16_arena_t *a, size_t mark)
+{
+    if (mark < a->used)
+    {
+        a->used = mark;
+    }
+}
+
+/*! \brief Bytes still available */
+static inline size_t fxp16_arena_left(const fxp16_arena_t *a)
+{
+    return a->size - a->used;
+}
+
+
+#endif /* _FXP16_ARENA_H_ */
@@ -0,0 +1,859 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_avx2.c
+
+    \brief  AVX2 variants of the batched fxp16 kernels
+
+    \details Compiled to nothing unless the translation unit is built with AVX2
+             enabled. Every kernel matches its *_scalar counterpart bit for bit;
+             remainders that do not fill a vector are handed to the scalar helpers.
+*/
+
+#include "fxp16_kernels.h"
+
+#if FXP16_KERNELS_AVX2
+
+/* AVX2 for the functions of this file only, they run after a cpuid check */
+#if !defined(__AVX2__)
+    #if defined(__clang__)
+        #pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+        #define FXP16_AVX2_PRAGMA_POP
+    #else
+        #pragma GCC target("avx2")
+    #endif
+#endif
+
+#include <immintrin.h>
+#include <string.h>
+
+
+/* 8 lanes of fxp16_tanh_lut_eval, v = |x| in Q16 (unsigned, up to 2^31) */
+static inline __m256i fxp16_tanh_lut_eval_avx2(__m256i v)
+{
+    v = _mm256_min_epu32(v, _mm256_set1_epi32(FXP16_TANH_LUT_XMAX));
+
+    __m256i i  = _mm256_srli_epi32(v, FXP16_TANH_LUT_STEP_BITS);
+    __m256i f  = _mm256_and_si256(v, _mm256_set1_epi32(FXP16_TANH_LUT_STEP_MASK));
+
+    /* one 32 bit gather at int16 granularity fetches the knot pair (t[i], t[i+1]) */
+    __m256i e  = _mm256_i32gather_epi32((const int *)fxp16_tanh_lut_q15, i, 2);
+    __m256i t0 = _mm256_srai_epi32(_mm256_slli_epi32(e, 16), 16);
+    __m256i t1 = _mm256_srai_epi32(e, 16);
+
+    __m256i d  = _mm256_mullo_epi32(_mm256_sub_epi32(t1, t0), f);
+    d = _mm256_add_epi32(d, _mm256_set1_epi32(1 << (FXP16_TANH_LUT_STEP_BITS - 1)));
+    d = _mm256_srai_epi32(d, FXP16_TANH_LUT_STEP_BITS);
+
+    return _mm256_add_epi32(t0, d);
+}
+
+
+static inline __m256i fxp16_tanh8_avx2(__m256i x, __m128i lshift, __m128i rshift, __m256i round)
+{
+    __m256i t = fxp16_tanh_lut_eval_avx2(_mm256_sll_epi32(_mm256_abs_epi32(x), lshift));
+    t = _mm256_srl_epi32(_mm256_add_epi32(t, round), rshift);
+    return _mm256_sign_epi32(t, x);
+}
+
+
+static inline __m256i fxp16_sigmoid8_avx2(__m256i x, __m128i lshift, __m128i rshift, __m256i round)
+{
+    __m256i t = fxp16_tanh_lut_eval_avx2(_mm256_sll_epi32(_mm256_abs_epi32(x), lshift));
+    __m256i q = _mm256_add_epi32(_mm256_set1_epi32(1 << 15), _mm256_sign_epi32(t, x));
+    return _mm256_srl_epi32(_mm256_add_epi32(q, round), rshift);
+}
+
+
+void fxp16_tanh_vec_avx2(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    const __m128i lshift = _mm_cvtsi32_si128(FXP16_TANH_LUT_FRAC - x_frac);
+    const __m128i rshift = _mm_cvtsi32_si128(FXP16_Q15 - y_frac);
+    const __m256i round  = _mm256_set1_epi32((1 << (FXP16_Q15 - y_frac)) >> 1);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i xv = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i r0 = fxp16_tanh8_avx2(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(xv)), lshift, rshift, round);
+        __m256i r1 = fxp16_tanh8_avx2(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(xv, 1)), lshift, rshift, round);
+        __m256i r  = _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), 0xD8);
+        _mm256_storeu_si256((__m256i *)(y + i), r);
+    }
+
+    for (; i < n; i++)
+    {
+        y[i] = fxp16_tanh_lut(y_frac, x[i], x_frac);
+    }
+}
+
+
+void fxp16_sigmoid_vec_avx2(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n)
+{
+    const __m128i lshift = _mm_cvtsi32_si128(FXP16_TANH_LUT_FRAC - x_frac - 1);
+    const __m128i rshift = _mm_cvtsi32_si128(16 - y_frac);
+    const __m256i round  = _mm256_set1_epi32((1 << (16 - y_frac)) >> 1);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i xv = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i r0 = fxp16_sigmoid8_avx2(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(xv)), lshift, rshift, round);
+        __m256i r1 = fxp16_sigmoid8_avx2(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(xv, 1)), lshift, rshift, round);
+        /* packs saturates 1.0 to 32767 exactly like fxp16_sat_m in the scalar path */
+        __m256i r  = _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), 0xD8);
+        _mm256_storeu_si256((__m256i *)(y + i), r);
+    }
+
+    for (; i < n; i++)
+    {
+        y[i] = fxp16_sigmoid_lut(y_frac, x[i], x_frac);
+    }
+}
+
+static inline __m256i fxp16_load_pair_avx2(const fxp16_t *p)
+{
+    int32_t pair;
+    memcpy(&pair, p, sizeof(pair));
+    return _mm256_set1_epi32(pair);
+}
+
+
+void fxp16_gemm_kernel_avx2(size_t kc, const fxp16_t *const a[FXP16_GEMM_MR], const fxp16_t *bp, fxp32_t *acc, size_t ldacc)
+{
+    __m256i c[FXP16_GEMM_MR][2];
+    size_t pairs = kc / 2;
+
+    for (int r = 0; r < FXP16_GEMM_MR; r++)
+    {
+        c[r][0] = _mm256_loadu_si256((const __m256i *)(acc + r*ldacc));
+        c[r][1] = _mm256_loadu_si256((const __m256i *)(acc + r*ldacc + 8));
+    }
+
+    for (size_t p = 0; p < pairs; p++, bp += 2 * FXP16_GEMM_NR)
+    {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)(bp));
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(bp + 16));
+
+        for (int r = 0; r < FXP16_GEMM_MR; r++)
+        {
+            __m256i av = fxp16_load_pair_avx2(a[r] + 2*p);
+            c[r][0] = _mm256_add_epi32(c[r][0], _mm256_madd_epi16(av, b0));
+            c[r][1] = _mm256_add_epi32(c[r][1], _mm256_madd_epi16(av, b1));
+        }
+    }
+
+    if (kc & 1)
+    {
+        /* odd depth: the last column pairs with zero, the packed B pair is zero padded too */
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)(bp));
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(bp + 16));
+
+        for (int r = 0; r < FXP16_GEMM_MR; r++)
+        {
+            __m256i av = _mm256_set1_epi32((uint16_t)a[r][kc - 1]);
+            c[r][0] = _mm256_add_epi32(c[r][0], _mm256_madd_epi16(av, b0));
+            c[r][1] = _mm256_add_epi32(c[r][1], _mm256_madd_epi16(av, b1));
+        }
+    }
+
+    for (int r = 0; r < FXP16_GEMM_MR; r++)
+    {
+        _mm256_storeu_si256((__m256i *)(acc + r*ldacc), c[r][0]);
+        _mm256_storeu_si256((__m256i *)(acc + r*ldacc + 8), c[r][1]);
+    }
+}
+
+
+fxp32_t fxp16_dot32_avx2(const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(va, vb));
+    }
+
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return (fxp32_t)((uint32_t)_mm_cvtsi128_si32(s) + (uint32_t)fxp16_dot32_scalar(a + i, b + i, n - i));
+}
+
+/* ---- float <-> fixed conversion ----------------------------------------- */
+
+/*
+    round() semantics without libm: t = trunc(v), then one step away from zero if
+    |v - t| >= 0.5 (the difference is exact). Values above 32767 are clamped before
+    the conversion, values below -32768 convert to INT32_MIN, which the saturating
+    pack turns into -32768. NaN lanes are cleared to 0 before converting.
+*/
+static inline __m256i fxp16_flt2fp8_avx2(__m256 x, __m256 scale)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    __m256 v    = _mm256_mul_ps(x, scale);
+    __m256 t    = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256 frac = _mm256_andnot_ps(sign, _mm256_sub_ps(v, t));
+    __m256 step = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(v, sign));
+    __m256 r    = _mm256_add_ps(t, _mm256_and_ps(_mm256_cmp_ps(frac, _mm256_set1_ps(0.5f), _CMP_GE_OQ), step));
+
+    r = _mm256_and_ps(r, _mm256_cmp_ps(x, x, _CMP_ORD_Q));
+    r = _mm256_min_ps(r, _mm256_set1_ps((float)INT16_MAX));
+
+    return _mm256_cvttps_epi32(r);
+}
+
+void fxp16_flt2fp_vec_avx2(const float *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    const __m256 scale = _mm256_set1_ps((float)(1 << frac));
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i lo = fxp16_flt2fp8_avx2(_mm256_loadu_ps(x + i), scale);
+        __m256i hi = fxp16_flt2fp8_avx2(_mm256_loadu_ps(x + i + 8), scale);
+
+        _mm256_storeu_si256((__m256i *)(y + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8));
+    }
+
+    fxp16_flt2fp_vec_scalar(x + i, y + i, n - i, frac);
+}
+
+
+void fxp16_fp2flt_vec_avx2(const fxp16_t *x, float *y, size_t n, uint8_t frac)
+{
+    const __m256 recip = _mm256_set1_ps(1.0f / (1 << frac));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + i)));
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), recip));
+    }
+
+    fxp16_fp2flt_vec_scalar(x + i, y + i, n - i, frac);
+}
+
+
+static inline __m128i fxp16_dbl2fp4_avx2(__m256d x, __m256d scale)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    __m256d v    = _mm256_mul_pd(x, scale);
+    __m256d t    = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d frac = _mm256_andnot_pd(sign, _mm256_sub_pd(v, t));
+    __m256d step = _mm256_or_pd(_mm256_set1_pd(1.0), _mm256_and_pd(v, sign));
+    __m256d r    = _mm256_add_pd(t, _mm256_and_pd(_mm256_cmp_pd(frac, _mm256_set1_pd(0.5), _CMP_GE_OQ), step));
+
+    r = _mm256_and_pd(r, _mm256_cmp_pd(x, x, _CMP_ORD_Q));
+    r = _mm256_min_pd(r, _mm256_set1_pd((double)INT16_MAX));
+
+    return _mm256_cvttpd_epi32(r);
+}
+
+void fxp16_dbl2fp_vec_avx2(const double *x, fxp16_t *y, size_t n, uint8_t frac)
+{
+    const __m256d scale = _mm256_set1_pd((double)(1 << frac));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i lo = fxp16_dbl2fp4_avx2(_mm256_loadu_pd(x + i), scale);
+        __m128i hi = fxp16_dbl2fp4_avx2(_mm256_loadu_pd(x + i + 4), scale);
+
+        _mm_storeu_si128((__m128i *)(y + i), _mm_packs_epi32(lo, hi));
+    }
+
+    fxp16_dbl2fp_vec_scalar(x + i, y + i, n - i, frac);
+}
+
+
+void fxp16_fp2dbl_vec_avx2(const fxp16_t *x, double *y, size_t n, uint8_t frac)
+{
+    const __m256d recip = _mm256_set1_pd(1.0 / (1 << frac));
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(x + i)));
+
+        _mm256_storeu_pd(y + i,     _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), recip));
+        _mm256_storeu_pd(y + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), recip));
+    }
+
+    fxp16_fp2dbl_vec_scalar(x + i, y + i, n - i, frac);
+}
+
+
+/* ---- requantization ---------------------------------------------------- */
+
+void fxp16_rshift_vec_avx2(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift)
+{
+    const __m128i cnt = _mm_cvtsi32_si128(shift - 1);
+    const __m256i one = _mm256_set1_epi16(1);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i t  = _mm256_sra_epi16(_mm256_loadu_si256((const __m256i *)(in + i)), cnt);
+        __m256i up = _mm256_andnot_si256(_mm256_srai_epi16(t, 15), _mm256_and_si256(t, one));
+
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi16(_mm256_srai_epi16(t, 1), up));
+    }
+
+    fxp16_rshift_vec_scalar(in + i, out + i, n - i, shift);
+}
+
+
+/* lanes whose shift does not round trip overflowed and take the saturation value of their sign */
+void fxp16_lshift_sat_vec_avx2(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift)
+{
+    const __m128i cnt = _mm_cvtsi32_si128(shift);
+    const __m256i max = _mm256_set1_epi16(INT16_MAX);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v   = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i r   = _mm256_sll_epi16(v, cnt);
+        __m256i ok  = _mm256_cmpeq_epi16(_mm256_sra_epi16(r, cnt), v);
+        __m256i sat = _mm256_xor_si256(_mm256_srai_epi16(v, 15), max);
+
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_blendv_epi8(sat, r, ok));
+    }
+
+    fxp16_lshift_sat_vec_scalar(in + i, out + i, n - i, shift);
+}
+
+
+static inline __m256i fxp16_narrow8_avx2(__m256i v, int shift, __m128i cnt, __m256i lo, __m256i hi)
+{
+    if (shift > 0)
+    {
+        __m256i t = _mm256_sra_epi32(v, cnt);
+        return _mm256_add_epi32(_mm256_srai_epi32(t, 1),
+                                _mm256_andnot_si256(_mm256_srai_epi32(t, 31), _mm256_and_si256(t, _mm256_set1_epi32(1))));
+    }
+
+    /* clamped far enough that the shifted value still saturates in packssdw */
+    return _mm256_sll_epi32(_mm256_max_epi32(_mm256_min_epi32(v, hi), lo), cnt);
+}
+
+void fxp16_narrow_vec_avx2(const fxp32_t *in, fxp16_t *out, size_t n, int shift)
+{
+    int s = (shift > 0) ? shift - 1 : ((-shift < 16) ? -shift : 16);
+    const __m128i cnt = _mm_cvtsi32_si128(s);
+    const __m256i hi  = _mm256_set1_epi32(1 << (16 - (shift > 0 ? 0 : s)));
+    const __m256i lo  = _mm256_sub_epi32(_mm256_setzero_si256(), hi);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i r0 = fxp16_narrow8_avx2(_mm256_loadu_si256((const __m256i *)(in + i)), shift, cnt, lo, hi);
+        __m256i r1 = fxp16_narrow8_avx2(_mm256_loadu_si256((const __m256i *)(in + i + 8)), shift, cnt, lo, hi);
+
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), 0xD8));
+    }
+
+    fxp16_narrow_vec_scalar(in + i, out + i, n - i, shift);
+}
+
+
+/* ---- complex ------------------------------------------------------------ */
+
+/* fpxx_arshift_m rounding on 8 int32 lanes */
+static inline __m256i fxp16_rshift_round_avx2(__m256i v, uint8_t frac)
+{
+    if (frac == 0)
+    {
+        return v;
+    }
+
+    __m256i t  = _mm256_sra_epi32(v, _mm_cvtsi32_si128(frac - 1));
+    __m256i up = _mm256_andnot_si256(_mm256_srai_epi32(t, 31), _mm256_and_si256(t, _mm256_set1_epi32(1)));
+    return _mm256_add_epi32(_mm256_srai_epi32(t, 1), up);
+}
+
+/*
+    8 interleaved complex products per vector, one {re, im} pair per 32 bit lane.
+    re = madd({ar, ~ai}, {br, bi}) + bi = ar*br - ai*bi, which never leaves int32.
+    im = madd({ar, ai}, {bi, br}) only overflows for ar = ai = br = bi = -32768, where
+    the exact +2^31 wraps to INT32_MIN; those lanes saturate to 32767 (frac <= 15).
+*/
+void fxp16_cmul_vec_avx2(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac)
+{
+    const __m256i not_im  = _mm256_set1_epi32((int)0xFFFF0000);
+    const __m256i swap    = _mm256_setr_epi8(2,3,0,1, 6,7,4,5, 10,11,8,9, 14,15,12,13,
+                                             2,3,0,1, 6,7,4,5, 10,11,8,9, 14,15,12,13);
+    const __m256i hi      = _mm256_set1_epi32(INT16_MAX);
+    const __m256i lo      = _mm256_set1_epi32(INT16_MIN);
+    const __m256i wrapped = _mm256_set1_epi32(INT32_MIN);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+
+        __m256i re = _mm256_add_epi32(_mm256_madd_epi16(_mm256_xor_si256(va, not_im), vb), _mm256_srai_epi32(vb, 16));
+        __m256i im = _mm256_madd_epi16(va, _mm256_shuffle_epi8(vb, swap));
+        __m256i ovf = _mm256_cmpeq_epi32(im, wrapped);
+
+        re = _mm256_max_epi32(_mm256_min_epi32(fxp16_rshift_round_avx2(re, frac), hi), lo);
+        im = _mm256_max_epi32(_mm256_min_epi32(fxp16_rshift_round_avx2(im, frac), hi), lo);
+        im = _mm256_blendv_epi8(im, hi, ovf);
+
+        _mm256_storeu_si256((__m256i *)(y + i), _mm256_blend_epi16(re, _mm256_slli_epi32(im, 16), 0xAA));
+    }
+
+    fxp16_cmul_vec_scalar(a + i, b + i, y + i, n - i, frac);
+}
+
+
+static inline int64_t fxp16_hsum_epi64_avx2(__m256i v)
+{
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+void fxp16_cmac_avx2(int64_t *re, int64_t *im, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n)
+{
+    const __m256i not_im = _mm256_set1_epi32((int)0xFFFF0000);
+    const __m256i swap   = _mm256_setr_epi8(2,3,0,1, 6,7,4,5, 10,11,8,9, 14,15,12,13,
+                                            2,3,0,1, 6,7,4,5, 10,11,8,9, 14,15,12,13);
+    const __m256i one    = _mm256_set1_epi32(1);
+    __m256i sr0 = _mm256_setzero_si256(), sr1 = _mm256_setzero_si256();
+    __m256i si0 = _mm256_setzero_si256(), si1 = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+
+        __m256i vr = _mm256_add_epi32(_mm256_madd_epi16(_mm256_xor_si256(va, not_im), vb), _mm256_srai_epi32(vb, 16));
+        /* im - 1 is in int32 range even for the wrapped +2^31; the 1 is added back below */
+        __m256i vi = _mm256_sub_epi32(_mm256_madd_epi16(va, _mm256_shuffle_epi8(vb, swap)), one);
+
+        sr0 = _mm256_add_epi64(sr0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(vr)));
+        sr1 = _mm256_add_epi64(sr1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(vr, 1)));
+        si0 = _mm256_add_epi64(si0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(vi)));
+        si1 = _mm256_add_epi64(si1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(vi, 1)));
+    }
+
+    fxp16_cmac_scalar(re, im, a + i, b + i, n - i);
+
+    *re += fxp16_hsum_epi64_avx2(_mm256_add_epi64(sr0, sr1));
+    *im += fxp16_hsum_epi64_avx2(_mm256_add_epi64(si0, si1)) + (int64_t)i;
+}
+
+
+/* fxp16_cmag_elem on 8 interleaved complex numbers, result in the 8 int32 lanes */
+static inline __m256i fxp16_cmag8_avx2(__m256i v)
+{
+    const __m256i k   = _mm256_set1_epi32((int)FXP16_CMAG_K_Q31);
+    const __m256i rnd = _mm256_set1_epi64x(1LL << (30 + FXP16_CMAG_GUARD_BITS));
+
+    __m256i x = _mm256_slli_epi32(_mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16), FXP16_CMAG_GUARD_BITS);
+    __m256i y = _mm256_slli_epi32(_mm256_srai_epi32(v, 16), FXP16_CMAG_GUARD_BITS);
+    __m256i m = _mm256_srai_epi32(x, 31);
+
+    x = _mm256_sub_epi32(_mm256_xor_si256(x, m), m);
+    y = _mm256_sub_epi32(_mm256_xor_si256(y, m), m);
+
+    for (int i = 0; i < FXP16_CMAG_ITERATIONS; i++)
+    {
+        __m128i cnt = _mm_cvtsi32_si128(i);
+        __m256i xs  = _mm256_sra_epi32(x, cnt);
+        __m256i ys  = _mm256_sra_epi32(y, cnt);
+
+        m = _mm256_srai_epi32(y, 31);
+        x = _mm256_add_epi32(x, _mm256_sub_epi32(_mm256_xor_si256(ys, m), m));
+        y = _mm256_sub_epi32(y, _mm256_sub_epi32(_mm256_xor_si256(xs, m), m));
+    }
+
+    /* gain correction in 64 bits, even and odd lanes separately */
+    __m256i even = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epu32(x, k), rnd), 31 + FXP16_CMAG_GUARD_BITS);
+    __m256i odd  = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), k), rnd), 31 + FXP16_CMAG_GUARD_BITS);
+
+    return _mm256_min_epi32(_mm256_or_si256(even, _mm256_slli_epi64(odd, 32)), _mm256_set1_epi32(INT16_MAX));
+}
+
+void fxp16_cmag_vec_avx2(const fxp16_complex_t *z, fxp16_t *mag, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i m0 = fxp16_cmag8_avx2(_mm256_loadu_si256((const __m256i *)(z + i)));
+        __m256i m1 = fxp16_cmag8_avx2(_mm256_loadu_si256((const __m256i *)(z + i + 8)));
+        __m256i p  = _mm256_permute4x64_epi64(_mm256_packs_epi32(m0, m1), 0xD8);
+
+        _mm256_storeu_si256((__m256i *)(mag + i), p);
+    }
+
+    fxp16_cmag_vec_scalar(z + i, mag + i, n - i);
+}
+
+/* ---- block floating point ---------------------------------------------- */
+
+uint16_t fxp16_signmag_or_avx2(const fxp16_t *x, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(x + i));
+        acc = _mm256_or_si256(acc, _mm256_xor_si256(v, _mm256_srai_epi16(v, 15)));
+    }
+
+    __m128i s = _mm_or_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_or_si128(s, _mm_srli_si128(s, 8));
+    s = _mm_or_si128(s, _mm_srli_si128(s, 4));
+    s = _mm_or_si128(s, _mm_srli_si128(s, 2));
+
+    return (uint16_t)(_mm_cvtsi128_si32(s) | fxp16_signmag_or_scalar(x + i, n - i));
+}
+
+
+/* ---- full-domain lookup tables ----------------------------------------- */
+
+/* gathers 32 bits at lut + x and keeps the low half; x = -1 (index 65535) reads the pad entry */
+static inline __m256i fxp16_lut_gather8_avx2(const fxp16_t *lut, __m128i x)
+{
+    __m256i idx = _mm256_cvtepu16_epi32(x);
+    __m256i v   = _mm256_i32gather_epi32((const int *)lut, idx, 2);
+    return _mm256_and_si256(v, _mm256_set1_epi32(0xFFFF));
+}
+
+void fxp16_lut_gather_avx2(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v  = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i lo = fxp16_lut_gather8_avx2(lut, _mm256_castsi256_si128(v));
+        __m256i hi = fxp16_lut_gather8_avx2(lut, _mm256_extracti128_si256(v, 1));
+        __m256i r  = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i *)(y + i), r);
+    }
+
+    fxp16_lut_gather_scalar(lut, x + i, y + i, n - i);
+}
+
+
+/* ---- rounding to integral values --------------------------------------- */
+
+/*
+    Stays in 16 bit lanes: x = q * 2^frac + r with q = x >> frac and 0 <= r < 2^frac,
+    the mode only decides whether q is incremented. Incremented q that no longer fit
+    the format after the shift back saturate.
+*/
+void fxp16_round_vec_avx2(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode, uint8_t shift)
+{
+    if (frac == 0 || (unsigned)mode > FXP16_ROUND_HALF_UP)
+    {
+        fxp16_round_vec_scalar(x, y, n, frac, mode, shift);
+        return;
+    }
+
+    const __m128i cnt  = _mm_cvtsi32_si128(frac);
+    const __m256i m    = _mm256_set1_epi16((1 << frac) - 1);
+    const __m256i h    = _mm256_set1_epi16(1 << (frac - 1));
+    const __m256i one  = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qmax = _mm256_set1_epi16(INT16_MAX >> frac);
+    const __m256i max  = _mm256_set1_epi16(INT16_MAX);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v   = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i q   = _mm256_sra_epi16(v, cnt);
+        __m256i r   = _mm256_and_si256(v, m);
+        __m256i neg = _mm256_srai_epi16(v, 15);
+        __m256i tie = _mm256_cmpeq_epi16(r, h);
+        __m256i up;
+
+        switch (mode)
+        {
+            case FXP16_ROUND_NEAREST_EVEN:
+                up = _mm256_and_si256(tie, _mm256_cmpeq_epi16(_mm256_and_si256(q, one), one));
+                up = _mm256_or_si256(up, _mm256_cmpgt_epi16(r, h));
+                break;
+            case FXP16_ROUND_FLOOR:
+                up = zero;
+                break;
+            case FXP16_ROUND_CEIL:
+                up = _mm256_xor_si256(_mm256_cmpeq_epi16(r, zero), _mm256_cmpeq_epi16(zero, zero));
+                break;
+            case FXP16_ROUND_TRUNC:
+                up = _mm256_andnot_si256(_mm256_cmpeq_epi16(r, zero), neg);
+                break;
+            case FXP16_ROUND_HALF_UP:
+                up = _mm256_or_si256(tie, _mm256_cmpgt_epi16(r, h));
+                break;
+            default:
+                up = _mm256_or_si256(_mm256_andnot_si256(neg, tie), _mm256_cmpgt_epi16(r, h));
+                break;
+        }
+
+        q = _mm256_sub_epi16(q, up);
+
+        if (shift == 0)
+        {
+            q = _mm256_blendv_epi8(_mm256_sll_epi16(q, cnt), max, _mm256_cmpgt_epi16(q, qmax));
+        }
+
+        _mm256_storeu_si256((__m256i *)(y + i), q);
+    }
+
+    fxp16_round_vec_scalar(x + i, y + i, n - i, frac, mode, shift);
+}
+
+void fxp16_goertzel_block_avx2(fxp32_t *s1, fxp32_t *s2, fxp32_t coef, const fxp16_t *x, size_t n, size_t lanes, size_t stride)
+{
+    const __m256i c    = _mm256_set1_epi64x(coef);
+    const __m256i half = _mm256_set1_epi64x(1 << 13);
+    size_t l = 0;
+
+    /* 8 filters per register; the low 32 bits of a logical 64 bit shift equal the arithmetic one */
+    for (; l + 8 <= lanes; l += 8)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(s1 + l));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(s2 + l));
+        const fxp16_t *xp = x + l;
+
+        for (size_t i = 0; i < n; i++, xp += stride)
+        {
+            __m256i xi   = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)xp));
+            __m256i even = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epi32(a, c), half), 14);
+            __m256i odd  = _mm256_srli_epi64(_mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), c), half), 14);
+            __m256i p    = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+            __m256i s0   = _mm256_sub_epi32(_mm256_add_epi32(xi, p), b);
+
+            b = a;
+            a = s0;
+        }
+
+        _mm256_storeu_si256((__m256i *)(s1 + l), a);
+        _mm256_storeu_si256((__m256i *)(s2 + l), b);
+    }
+
+    fxp16_goertzel_block_scalar(s1 + l, s2 + l, coef, x + l, n, lanes - l, stride);
+}
+
+void fxp16_sumsq_avx2(const fxp16_t *x, size_t n, int64_t *sum, uint64_t *sumsq)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i s = _mm256_setzero_si256(), q = _mm256_setzero_si256();
+    int64_t  ls[4], ts;
+    uint64_t lq[4], tq;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v  = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i ps = _mm256_madd_epi16(v, ones);
+        __m256i pq = _mm256_madd_epi16(v, v);     /* pairs of squares reach 2^31, read them unsigned */
+
+        s = _mm256_add_epi64(s, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(ps)));
+        s = _mm256_add_epi64(s, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(ps, 1)));
+        q = _mm256_add_epi64(q, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(pq)));
+        q = _mm256_add_epi64(q, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(pq, 1)));
+    }
+
+    _mm256_storeu_si256((__m256i *)ls, s);
+    _mm256_storeu_si256((__m256i *)lq, q);
+    fxp16_sumsq_scalar(x + i, n - i, &ts, &tq);
+
+    *sum   = ls[0] + ls[1] + ls[2] + ls[3] + ts;
+    *sumsq = lq[0] + lq[1] + lq[2] + lq[3] + tq;
+}
+
+void fxp16_minmax_avx2(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max)
+{
+    __m256i lo = _mm256_set1_epi16(*min), hi = _mm256_set1_epi16(*max);
+    fxp16_t l[16], h[16], none_lo = INT16_MAX, none_hi = INT16_MIN;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(x + i));
+        lo = _mm256_min_epi16(lo, v);
+        hi = _mm256_max_epi16(hi, v);
+    }
+
+    _mm256_storeu_si256((__m256i *)l, lo);
+    _mm256_storeu_si256((__m256i *)h, hi);
+    fxp16_minmax_scalar(l, 16, min, &none_hi);
+    fxp16_minmax_scalar(h, 16, &none_lo, max);
+    fxp16_minmax_scalar(x + i, n - i, min, max);
+}
+
+/* 16 frames per iteration; other channel counts and the tail go to the scalar kernel */
+void fxp16_deinterleave_avx2(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames)
+{
+    /* per 128 bit lane: even then odd 16 bit elements */
+    const __m256i split = _mm256_setr_epi8(0,1,4,5,8,9,12,13, 2,3,6,7,10,11,14,15,
+                                           0,1,4,5,8,9,12,13, 2,3,6,7,10,11,14,15);
+    /* per 128 bit lane: the two frames of each of 4 channels next to each other */
+    const __m256i pairs = _mm256_setr_epi8(0,1,8,9, 2,3,10,11, 4,5,12,13, 6,7,14,15,
+                                           0,1,8,9, 2,3,10,11, 4,5,12,13, 6,7,14,15);
+    const __m256i quads = _mm256_setr_epi32(0,4,1,5,2,6,3,7);
+    fxp16_t *tail[4];
+    size_t f = 0;
+
+    if (channels == 2)
+    {
+        for (; f + 16 <= frames; f += 16)
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i *)(x + 2 * f));
+            __m256i b = _mm256_loadu_si256((const __m256i *)(x + 2 * f + 16));
+
+            a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, split), 0xD8);
+            b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, split), 0xD8);
+
+            _mm256_storeu_si256((__m256i *)(planes[0] + f), _mm256_permute2x128_si256(a, b, 0x20));
+            _mm256_storeu_si256((__m256i *)(planes[1] + f), _mm256_permute2x128_si256(a, b, 0x31));
+        }
+    }
+    else if (channels == 4)
+    {
+        for (; f + 16 <= frames; f += 16)
+        {
+            __m256i v[4], t0, t1, t2, t3;
+
+            /* 64 bit element k of v[j]: channel k of frames 4j .. 4j+3 */
+            for (int j = 0; j < 4; j++)
+            {
+                v[j] = _mm256_loadu_si256((const __m256i *)(x + 4 * f + 16 * j));
+                v[j] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v[j], pairs), quads);
+            }
+
+            /* 4x4 transpose of 64 bit elements */
+            t0 = _mm256_unpacklo_epi64(v[0], v[1]);
+            t1 = _mm256_unpackhi_epi64(v[0], v[1]);
+            t2 = _mm256_unpacklo_epi64(v[2], v[3]);
+            t3 = _mm256_unpackhi_epi64(v[2], v[3]);
+
+            _mm256_storeu_si256((__m256i *)(planes[0] + f), _mm256_permute2x128_si256(t0, t2, 0x20));
+            _mm256_storeu_si256((__m256i *)(planes[1] + f), _mm256_permute2x128_si256(t1, t3, 0x20));
+            _mm256_storeu_si256((__m256i *)(planes[2] + f), _mm256_permute2x128_si256(t0, t2, 0x31));
+            _mm256_storeu_si256((__m256i *)(planes[3] + f), _mm256_permute2x128_si256(t1, t3, 0x31));
+        }
+    }
+
+    if (f == 0)
+    {
+        fxp16_deinterleave_scalar(x, planes, channels, frames);
+        return;
+    }
+
+    for (size_t c = 0; c < channels; c++)
+    {
+        tail[c] = planes[c] + f;
+    }
+    fxp16_deinterleave_scalar(x + channels * f, tail, channels, frames - f);
+}
+
+/* inverse of fxp16_deinterleave_avx2, the same steps backwards */
+void fxp16_interleave_avx2(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames)
+{
+    const __m256i merge = _mm256_setr_epi8(0,1,4,5,8,9,12,13, 2,3,6,7,10,11,14,15,
+                                           0,1,4,5,8,9,12,13, 2,3,6,7,10,11,14,15);
+    const __m256i quads = _mm256_setr_epi32(0,2,4,6,1,3,5,7);
+    const fxp16_t *tail[4];
+    size_t f = 0;
+
+    if (channels == 2)
+    {
+        for (; f + 16 <= frames; f += 16)
+        {
+            __m256i a  = _mm256_loadu_si256((const __m256i *)(planes[0] + f));
+            __m256i b  = _mm256_loadu_si256((const __m256i *)(planes[1] + f));
+            __m256i lo = _mm256_unpacklo_epi16(a, b);
+            __m256i hi = _mm256_unpackhi_epi16(a, b);
+
+            _mm256_storeu_si256((__m256i *)(y + 2 * f), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i *)(y + 2 * f + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+    else if (channels == 4)
+    {
+        for (; f + 16 <= frames; f += 16)
+        {
+            __m256i c0 = _mm256_loadu_si256((const __m256i *)(planes[0] + f));
+            __m256i c1 = _mm256_loadu_si256((const __m256i *)(planes[1] + f));
+            __m256i c2 = _mm256_loadu_si256((const __m256i *)(planes[2] + f));
+            __m256i c3 = _mm256_loadu_si256((const __m256i *)(planes[3] + f));
+            __m256i t0 = _mm256_unpacklo_epi64(c0, c1);
+            __m256i t1 = _mm256_unpackhi_epi64(c0, c1);
+            __m256i t2 = _mm256_unpacklo_epi64(c2, c3);
+            __m256i t3 = _mm256_unpackhi_epi64(c2, c3);
+            __m256i v[4];
+
+            v[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+            v[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+            v[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+            v[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+
+            for (int j = 0; j < 4; j++)
+            {
+                v[j] = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v[j], quads), merge);
+                _mm256_storeu_si256((__m256i *)(y + 4 * f + 16 * j), v[j]);
+            }
+        }
+    }
+
+    if (f == 0)
+    {
+        fxp16_interleave_scalar(planes, y, channels, frames);
+        return;
+    }
+
+    for (size_t c = 0; c < channels; c++)
+    {
+        tail[c] = planes[c] + f;
+    }
+    fxp16_interleave_scalar(tail, y + channels * f, channels, frames - f);
+}
+
+#if defined(FXP16_AVX2_PRAGMA_POP)
+    #pragma clang attribute pop
+#endif
+
+#endif /* FXP16_KERNELS_AVX2 */
@@ -0,0 +1,262 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_bfp.c
+
+    \brief  Block floating point buffers with a shared exponent
+*/
+
+#include "fxp16_bfp.h"
+#include "fxp16_kernels.h"
+#include <string.h>
+
+
+#define fxp16_signmag_or    (fxp16_kernels()->signmag_or)
+
+#define FXP16_BFP_ADD_GUARD_BITS    14      /* |a| + |b| < 2^31 after alignment */
+
+
+/* number of significant bits of v, 0 for v = 0 */
+static int fxp16_bit_length(uint64_t v)
+{
+    int bits = 0;
+
+    if (v >> 32) { v >>= 32; bits += 32; }
+    if (v >> 16) { v >>= 16; bits += 16; }
+    if (v >> 8)  { v >>= 8;  bits += 8;  }
+    if (v >> 4)  { v >>= 4;  bits += 4;  }
+    if (v >> 2)  { v >>= 2;  bits += 2;  }
+    if (v >> 1)  { v >>= 1;  bits += 1;  }
+
+    return bits + (int)v;
+}
+
+
+/* right shift that brings values of OR-ed magnitude acc into 16 bit mantissas; a
+   largest value max that rounds up to 2^15 takes one bit more instead of saturating */
+static int fxp16_bfp_norm_shift(uint64_t acc, int64_t max)
+{
+    int shift = acc ? fxp16_bit_length(acc) - 15 : 0;
+
+    if (shift > 0)
+    {
+        fpxx_arshift_m(max, shift);
+        if (max > INT16_MAX) shift++;
+    }
+
+    return shift;
+}
+
+
+/* rescale by 2^-shift for any shift; very large right shifts end at 0 or -1 like an arithmetic shift */
+static inline fxp16_t fxp16_bfp_requant(fxp32_t v, int shift)
+{
+    if (shift > 31) shift = 31;
+    if (shift < -31) shift = -31;
+    return fxp16_requant32(v, shift);
+}
+
+
+uint16_t fxp16_signmag_or_scalar(const fxp16_t *x, size_t n)
+{
+    uint16_t acc = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        acc |= (uint16_t)(x[i] ^ (x[i] >> 15));
+    }
+
+    return acc;
+}
+
+
+void fxp16_bfp_init(fxp16_bfp_t *b, fxp16_t *m, size_t n)
+{
+    b->m = m;
+    b->n = n;
+    b->exp = 0;
+}
+
+
+size_t fxp16_bfp_bytes(size_t n)
+{
+    return FXP16_ARENA_SIZE(n * sizeof(fxp16_t));
+}
+
+
+int fxp16_bfp_init_arena(fxp16_bfp_t *b, fxp16_arena_t *a, size_t n)
+{
+    fxp16_t *m = fxp16_arena_alloc(a, n * sizeof(fxp16_t));
+
+    if (m == NULL)
+    {
+        return -1;
+    }
+
+    memset(m, 0, n * sizeof(fxp16_t));
+    fxp16_bfp_init(b, m, n);
+    return 0;
+}
+
+
+uint8_t fxp16_headroom_vec(const fxp16_t *x, size_t n)
+{
+    return (uint8_t)(15 - fxp16_bit_length(fxp16_signmag_or(x, n)));
+}
+
+
+void fxp16_bfp_normalize(fxp16_bfp_t *b)
+{
+    uint16_t acc = fxp16_signmag_or(b->m, b->n);
+    int h = 15 - fxp16_bit_length(acc);
+
+    /* all zero: no scale to find, the exponent would only drift */
+    if (h == 0 || acc == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < b->n; i++)
+    {
+        b->m[i] = (fxp16_t)(b->m[i] * (1 << h));
+    }
+
+    b->exp -= h;
+}
+
+
+void fxp16_bfp_from_fxp(fxp16_bfp_t *b, const fxp16_t *x, uint8_t frac)
+{
+    uint16_t acc = fxp16_signmag_or(x, b->n);
+    int h = acc ? 15 - fxp16_bit_length(acc) : 0;
+
+    for (size_t i = 0; i < b->n; i++)
+    {
+        b->m[i] = (fxp16_t)(x[i] * (1 << h));
+    }
+
+    b->exp = -(int)frac - h;
+}
+
+
+void fxp16_bfp_denormalize(const fxp16_bfp_t *b, fxp16_t *y, uint8_t frac)
+{
+    int shift = -(b->exp + (int)frac);
+
+    for (size_t i = 0; i < b->n; i++)
+    {
+        y[i] = fxp16_bfp_requant(b->m[i], shift);
+    }
+}
+
+
+/* mantissa of a block scaled to exponent e0, e - e0 <= guard bits */
+static inline fxp32_t fxp16_bfp_align(fxp16_t m, int e, int e0)
+{
+    int sh = e - e0;
+    return (sh >= 0) ? (fxp32_t)m * (1 << sh) : fxp16_bfp_requant(m, -sh);
+}
+
+
+void fxp16_bfp_add(const fxp16_bfp_t *a, const fxp16_bfp_t *b, fxp16_bfp_t *y)
+{
+    fxp16_stats_call_m(bfp_add);
+    int e0 = ((a->exp > b->exp) ? a->exp : b->exp) - FXP16_BFP_ADD_GUARD_BITS;
+    uint32_t acc = 0;
+    fxp32_t max = 0;
+
+    /* first pass only finds the bit length and maximum of the exact sums, second pass writes */
+    for (size_t i = 0; i < a->n; i++)
+    {
+        fxp32_t s = fxp16_bfp_align(a->m[i], a->exp, e0) + fxp16_bfp_align(b->m[i], b->exp, e0);
+        acc |= (uint32_t)(s ^ (s >> 31));
+        if (s > max) max = s;
+    }
+
+    int shift = fxp16_bfp_norm_shift(acc, max);
+
+    for (size_t i = 0; i < a->n; i++)
+    {
+        fxp32_t s = fxp16_bfp_align(a->m[i], a->exp, e0) + fxp16_bfp_align(b->m[i], b->exp, e0);
+        y->m[i] = fxp16_bfp_requant(s, shift);
+    }
+
+    y->exp = e0 + shift;
+}
+
+
+void fxp16_bfp_mult(const fxp16_bfp_t *a, const fxp16_bfp_t *b, fxp16_bfp_t *y)
+{
+    fxp16_stats_call_m(bfp_mult);
+    uint32_t acc = 0;
+    fxp32_t max = 0;
+
+    for (size_t i = 0; i < a->n; i++)
+    {
+        fxp32_t p = (fxp32_t)a->m[i] * b->m[i];
+        acc |= (uint32_t)(p ^ (p >> 31));
+        if (p > max) max = p;
+    }
+
+    int shift = fxp16_bfp_norm_shift(acc, max);
+
+    for (size_t i = 0; i < a->n; i++)
+    {
+        y->m[i] = fxp16_bfp_requant((fxp32_t)a->m[i] * b->m[i], shift);
+    }
+
+    y->exp = a->exp + b->exp + shift;
+}
+
+
+fxp16_t fxp16_bfp_dot(const fxp16_bfp_t *a, const fxp16_bfp_t *b, int *exp)
+{
+    fxp16_stats_call_m(bfp_dot);
+    int64_t sum = 0;
+
+    for (size_t i = 0; i < a->n; i++)
+    {
+        sum += (int64_t)a->m[i] * b->m[i];
+    }
+
+    int shift = fxp16_bfp_norm_shift((uint64_t)(sum ^ (sum >> 63)), sum);
+
+    if (shift > 0)
+    {
+        fpxx_arshift_m(sum, shift);
+        fxp16_sat_m(sum);
+    }
+    else
+    {
+        sum *= (int64_t)1 << -shift;
+    }
+
+    *exp = a->exp + b->exp + shift;
+    return (fxp16_t)sum;
+}
@@ -0,0 +1,151 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_bfp.h
+
+    \brief  Block floating point buffers with a shared exponent
+
+    \details A block holds n int16 mantissas and one exponent, value[i] = m[i] * 2^exp.
+             Normalizing moves the block to full 16 bit precision with a single
+             max-abs pass, so FFT stages and filters do not need per-sample Q format
+             changes. Mantissa storage is owned by the caller.
+*/
+
+#ifndef _FXP16_BFP_H_
+#define _FXP16_BFP_H_
+
+#include "fxp16.h"
+#include "fxp16_arena.h"
+
+
+/*!
+    \brief      Block floating point buffer
+    \details    value[i] = m[i] * 2^exp. A Q15 array is a block with exp = -15.
+*/
+typedef struct {
+    fxp16_t *m;     /*!< mantissas, caller owned */
+    size_t   n;     /*!< number of mantissas */
+    int      exp;   /*!< shared exponent */
+} fxp16_bfp_t;
+
+
+/*!
+    \brief      Attaches mantissa storage to a block
+    \details    The exponent starts at 0, i.e. the mantissas are read as integers.
+    \param[out] b   Block
+    \param[in]  m   Mantissa storage of n elements
+    \param[in]  n   Number of elements
+*/
+void fxp16_bfp_init(fxp16_bfp_t *b, fxp16_t *m, size_t n);
+
+/*! \brief Arena bytes fxp16_bfp_init_arena() takes */
+size_t fxp16_bfp_bytes(size_t n);
+
+/*!
+    \brief      fxp16_bfp_init() with zeroed mantissas taken from an arena
+    \returns    0 on success, -1 if the arena is too small
+*/
+int fxp16_bfp_init_arena(fxp16_bfp_t *b, fxp16_arena_t *a, size_t n);
+
+/*!
+    \brief      Common headroom of an fxp16 array
+    \details    Number of bits all elements can be shifted left without overflow,
+                0..15 (15 for an all-zero array). Single OR pass over x ^ (x >> 15).
+    \param[in]  x   Array
+    \param[in]  n   Number of elements
+    \returns    Headroom in bits
+*/
+uint8_t fxp16_headroom_vec(const fxp16_t *x, size_t n);
+
+/*!
+    \brief      Normalizes a block in place
+    \details    Shifts all mantissas left by their common headroom and lowers the
+                exponent accordingly. The represented values do not change. An
+                all-zero block is left as it is.
+    \param[in,out] b   Block
+*/
+void fxp16_bfp_normalize(fxp16_bfp_t *b);
+
+/*!
+    \brief      Converts a fixed point array into a normalized block
+    \details    An all-zero array keeps the exponent -frac.
+    \param[out] b       Block with storage for n mantissas, b->n elements are converted
+    \param[in]  x       Fixed point array, may be b->m
+    \param[in]  frac    Fractional bits of \p x
+*/
+void fxp16_bfp_from_fxp(fxp16_bfp_t *b, const fxp16_t *x, uint8_t frac);
+
+/*!
+    \brief      Converts a block back to a fixed point array
+    \details    Right shifts round like fxp32_arshift, the result saturates to the
+                fxp16 range.
+    \param[in]  b       Block
+    \param[out] y       Fixed point array of b->n elements, may be b->m
+    \param[in]  frac    Fractional bits of \p y
+*/
+void fxp16_bfp_denormalize(const fxp16_bfp_t *b, fxp16_t *y, uint8_t frac);
+
+/*!
+    \brief      Element wise sum of two blocks
+    \details    Aligns both blocks to the larger exponent with 14 guard bits, adds in
+                32 bits and normalizes the result with one rounding per element.
+                Exponent gaps of more than 14 bits already round the smaller block
+                while aligning, so those sums round twice. A maximum that rounds up
+                to 2^15 renormalizes by one more bit instead of saturating.
+                All blocks have a->n elements; \p y may alias \p a or \p b.
+    \param[in]  a   First summand
+    \param[in]  b   Second summand
+    \param[out] y   Normalized sum
+*/
+void fxp16_bfp_add(const fxp16_bfp_t *a, const fxp16_bfp_t *b, fxp16_bfp_t *y);
+
+/*!
+    \brief      Element wise product of two blocks
+    \details    Exact 32 bit products, normalized to 16 bit mantissas with one
+                rounding per element; a maximum that rounds up to 2^15 renormalizes
+                by one more bit instead of saturating. All blocks have a->n elements; \p y may alias
+                \p a or \p b.
+    \param[in]  a   Multiplicator
+    \param[in]  b   Multiplicand
+    \param[out] y   Normalized product
+*/
+void fxp16_bfp_mult(const fxp16_bfp_t *a, const fxp16_bfp_t *b, fxp16_bfp_t *y);
+
+/*!
+    \brief      Dot product of two blocks
+    \details    The sum of products is exact in 64 bits and rounded once to a
+                normalized 16 bit mantissa.
+    \param[in]  a       First operand
+    \param[in]  b       Second operand, a->n elements
+    \param[out] exp     Exponent of the result
+    \returns    Mantissa of a . b, the value is mantissa * 2^(*exp)
+*/
+fxp16_t fxp16_bfp_dot(const fxp16_bfp_t *a, const fxp16_bfp_t *b, int *exp);
+
+#endif /* _FXP16_BFP_H_ */
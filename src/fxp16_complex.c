@@ -0,0 +1,195 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_complex.c
+
+    \brief  Complex fxp16 arithmetic for IQ processing
+*/
+
+#include "fxp16_complex.h"
+#include "fxp16_kernels.h"
+
+
+#define fxp16_cmul_vec_impl     (fxp16_kernels()->cmul_vec)
+#define fxp16_cmac_impl         (fxp16_kernels()->cmac)
+#define fxp16_cmag_vec_impl     (fxp16_kernels()->cmag_vec)
+
+
+fxp16_complex_t fxp16_cmul(fxp16_complex_t a, fxp16_complex_t b, uint8_t frac)
+{
+    fxp16_complex_t y;
+    fxp16_cmul_elem(a.re, a.im, b.re, b.im, frac, &y.re, &y.im);
+    return y;
+}
+
+
+fxp16_complex_t fxp16_conj(fxp16_complex_t z)
+{
+    fxp32_t im = -(fxp32_t)z.im;
+    fxp16_sat_m(im);
+    z.im = (fxp16_t)im;
+    return z;
+}
+
+
+fxp16_t fxp16_cmag(fxp16_complex_t z)
+{
+    return fxp16_cmag_elem(z.re, z.im);
+}
+
+
+fxp16_t fxp16_carg(fxp16_complex_t z)
+{
+    return fxp16_atan2(z.im, z.re);
+}
+
+
+void fxp16_cmul_vec_scalar(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_cmul_elem(a[i].re, a[i].im, b[i].re, b[i].im, frac, &y[i].re, &y[i].im);
+    }
+}
+
+
+void fxp16_cmul_vec(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac)
+{
+    fxp16_stats_call_m(cmul_vec);
+    fxp16_cmul_vec_impl(a, b, y, n, frac);
+}
+
+
+void fxp16_cmul_soa(const fxp16_t *a_re, const fxp16_t *a_im, const fxp16_t *b_re, const fxp16_t *b_im,
+                    fxp16_t *y_re, fxp16_t *y_im, size_t n, uint8_t frac)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_cmul_elem(a_re[i], a_im[i], b_re[i], b_im[i], frac, &y_re[i], &y_im[i]);
+    }
+}
+
+
+/* exact sums of the products, Q(frac_a + frac_b) */
+void fxp16_cmac_scalar(int64_t *re, int64_t *im, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n)
+{
+    int64_t sr = 0, si = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        sr += (int64_t)a[i].re * b[i].re - (int64_t)a[i].im * b[i].im;
+        si += (int64_t)a[i].re * b[i].im + (int64_t)a[i].im * b[i].re;
+    }
+
+    *re = sr;
+    *im = si;
+}
+
+
+static fxp16_complex_t fxp16_cmac_finish(fxp16_complex_t acc, int64_t re, int64_t im, uint8_t frac)
+{
+    re += (int64_t)acc.re * ((int64_t)1 << frac);
+    im += (int64_t)acc.im * ((int64_t)1 << frac);
+
+    fpxx_arshift_m(re, frac);
+    fpxx_arshift_m(im, frac);
+    fxp16_sat_m(re);
+    fxp16_sat_m(im);
+
+    acc.re = (fxp16_t)re;
+    acc.im = (fxp16_t)im;
+    return acc;
+}
+
+
+fxp16_complex_t fxp16_cmac(fxp16_complex_t acc, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n, uint8_t frac)
+{
+    fxp16_stats_call_m(cmac);
+    int64_t re, im;
+    fxp16_cmac_impl(&re, &im, a, b, n);
+    return fxp16_cmac_finish(acc, re, im, frac);
+}
+
+
+fxp16_complex_t fxp16_cmac_soa(fxp16_complex_t acc, const fxp16_t *a_re, const fxp16_t *a_im,
+                               const fxp16_t *b_re, const fxp16_t *b_im, size_t n, uint8_t frac)
+{
+    int64_t re = 0, im = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        re += (int64_t)a_re[i] * b_re[i] - (int64_t)a_im[i] * b_im[i];
+        im += (int64_t)a_re[i] * b_im[i] + (int64_t)a_im[i] * b_re[i];
+    }
+
+    return fxp16_cmac_finish(acc, re, im, frac);
+}
+
+
+void fxp16_cmag_vec_scalar(const fxp16_complex_t *z, fxp16_t *mag, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        mag[i] = fxp16_cmag_elem(z[i].re, z[i].im);
+    }
+}
+
+
+void fxp16_cmag_vec(const fxp16_complex_t *z, fxp16_t *mag, size_t n)
+{
+    fxp16_stats_call_m(cmag_vec);
+    fxp16_cmag_vec_impl(z, mag, n);
+}
+
+
+void fxp16_cmag_soa(const fxp16_t *re, const fxp16_t *im, fxp16_t *mag, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        mag[i] = fxp16_cmag_elem(re[i], im[i]);
+    }
+}
+
+
+void fxp16_carg_vec(const fxp16_complex_t *z, fxp16_t *arg, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        arg[i] = fxp16_atan2(z[i].im, z[i].re);
+    }
+}
+
+
+void fxp16_carg_soa(const fxp16_t *re, const fxp16_t *im, fxp16_t *arg, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        arg[i] = fxp16_atan2(im[i], re[i]);
+    }
+}
@@ -0,0 +1,169 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_complex.h
+
+    \brief  Complex fxp16 arithmetic for IQ processing
+
+    \details fxp16_complex_t is a plain {re, im} pair, so an array of it is the
+             usual interleaved IQ buffer. Each function also comes in a
+             deinterleaved form (*_soa) that takes separate re/im arrays.
+             A complex product is rounded and saturated once per component,
+             not once per partial product.
+*/
+
+#ifndef _FXP16_COMPLEX_H_
+#define _FXP16_COMPLEX_H_
+
+#include "fxp16.h"
+
+
+/*!
+    \brief      Complex fixed point number, interleaved {re, im}
+    \details    Both parts share one fixed point format. Arrays of fxp16_complex_t
+                have the memory layout re0, im0, re1, im1, ...
+*/
+typedef struct {
+    fxp16_t re;     /*!< real part */
+    fxp16_t im;     /*!< imaginary part */
+} fxp16_complex_t;
+
+
+/*!
+    \brief      Complex multiplication
+    \details    y = a * b, result in the fixed point format of \p a.
+
+                    re = (a.re*b.re - a.im*b.im) >> frac
+                    im = (a.re*b.im + a.im*b.re) >> frac
+
+                Each component is computed exactly, rounded once like fxp32_arshift
+                and saturated to the fxp16 range.
+
+    \param[in]  a       Multiplicator
+    \param[in]  b       Multiplicand
+    \param[in]  frac    Fractional bits of \p b (0..15), e.g. FXP16_Q15 for Q15 twiddles
+
+    \returns a * b in the fixed point format of \p a
+*/
+fxp16_complex_t fxp16_cmul(fxp16_complex_t a, fxp16_complex_t b, uint8_t frac);
+
+/*!
+    \brief      Complex conjugate
+    \details    Negates the imaginary part; -32768 saturates to 32767.
+    \param[in]  z   Complex number
+    \returns    conj(z)
+*/
+fxp16_complex_t fxp16_conj(fxp16_complex_t z);
+
+/*!
+    \brief      Complex magnitude via CORDIC vectoring
+    \details    |z| = sqrt(re^2 + im^2) in the format of \p z, saturated to 32767.
+                15 vectoring iterations on 14 guard bits with a single rounding after
+                the gain correction, within 1 LSB of the exact magnitude.
+    \param[in]  z   Complex number
+    \returns    |z|
+*/
+fxp16_t fxp16_cmag(fxp16_complex_t z);
+
+/*!
+    \brief      Complex argument
+    \details    fxp16_atan2(z.im, z.re), Q15 normalized to pi: [-1.0, 1.0) -> [-pi, pi)
+    \param[in]  z   Complex number
+    \returns    arg(z)
+*/
+fxp16_t fxp16_carg(fxp16_complex_t z);
+
+
+/*!
+    \brief      Element wise complex multiplication of interleaved buffers
+    \details    y[i] = fxp16_cmul(a[i], b[i], frac). \p y may alias \p a or \p b.
+    \param[in]  a       Multiplicators
+    \param[in]  b       Multiplicands
+    \param[out] y       Products in the format of \p a
+    \param[in]  n       Number of elements
+    \param[in]  frac    Fractional bits of \p b (0..15)
+*/
+void fxp16_cmul_vec(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac);
+
+/*!
+    \brief      Element wise complex multiplication of deinterleaved buffers
+    \details    SoA form of fxp16_cmul_vec. Outputs may alias the inputs.
+*/
+void fxp16_cmul_soa(const fxp16_t *a_re, const fxp16_t *a_im, const fxp16_t *b_re, const fxp16_t *b_im,
+                    fxp16_t *y_re, fxp16_t *y_im, size_t n, uint8_t frac);
+
+/*!
+    \brief      Complex multiply-accumulate
+    \details    Returns acc + sum(a[i] * b[i]) in the format of \p acc and \p a.
+                The sum is kept exact in 64 bits and rounded and saturated once at
+                the end, which makes it the building block for FIR filters and
+                correlators on IQ data.
+
+    \param[in]  acc     Start value
+    \param[in]  a       First operand array
+    \param[in]  b       Second operand array
+    \param[in]  n       Number of products
+    \param[in]  frac    Fractional bits of \p b (0..15)
+
+    \returns acc + a . b
+*/
+fxp16_complex_t fxp16_cmac(fxp16_complex_t acc, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n, uint8_t frac);
+
+/*!
+    \brief      Complex multiply-accumulate on deinterleaved buffers
+    \details    SoA form of fxp16_cmac.
+*/
+fxp16_complex_t fxp16_cmac_soa(fxp16_complex_t acc, const fxp16_t *a_re, const fxp16_t *a_im,
+                               const fxp16_t *b_re, const fxp16_t *b_im, size_t n, uint8_t frac);
+
+/*!
+    \brief      Magnitudes of an interleaved buffer
+    \details    mag[i] = fxp16_cmag(z[i])
+*/
+void fxp16_cmag_vec(const fxp16_complex_t *z, fxp16_t *mag, size_t n);
+
+/*!
+    \brief      Magnitudes of a deinterleaved buffer
+    \details    mag[i] = fxp16_cmag({re[i], im[i]})
+*/
+void fxp16_cmag_soa(const fxp16_t *re, const fxp16_t *im, fxp16_t *mag, size_t n);
+
+/*!
+    \brief      Arguments of an interleaved buffer
+    \details    arg[i] = fxp16_carg(z[i])
+*/
+void fxp16_carg_vec(const fxp16_complex_t *z, fxp16_t *arg, size_t n);
+
+/*!
+    \brief      Arguments of a deinterleaved buffer
+    \details    arg[i] = fxp16_atan2(im[i], re[i])
+*/
+void fxp16_carg_soa(const fxp16_t *re, const fxp16_t *im, fxp16_t *arg, size_t n);
+
+#endif /* _FXP16_COMPLEX_H_ */
@@ -0,0 +1,215 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_dispatch.c
+
+    \brief  Runtime selection of the batched kernels
+*/
+
+#include "fxp16_dispatch.h"
+#include "fxp16_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && (defined(__aarch64__) || defined(__arm__))
+    #include <sys/auxv.h>
+    #include <asm/hwcap.h>
+#endif
+
+
+static const fxp16_kernel_table_t fxp16_kernels_scalar = {
+    FXP16_ISA_SCALAR,
+    fxp16_flt2fp_vec_scalar,
+    fxp16_fp2flt_vec_scalar,
+    fxp16_dbl2fp_vec_scalar,
+    fxp16_fp2dbl_vec_scalar,
+    fxp16_rshift_vec_scalar,
+    fxp16_lshift_sat_vec_scalar,
+    fxp16_narrow_vec_scalar,
+    fxp16_gemm_kernel_scalar,
+    fxp16_dot32_scalar,
+    fxp16_cmul_vec_scalar,
+    fxp16_cmac_scalar,
+    fxp16_cmag_vec_scalar,
+    fxp16_signmag_or_scalar,
+    fxp16_lut_gather_scalar,
+    fxp16_tanh_vec_scalar,
+    fxp16_sigmoid_vec_scalar,
+    fxp16_round_vec_scalar,
+    fxp16_goertzel_block_scalar,
+    fxp16_sumsq_scalar,
+    fxp16_minmax_scalar,
+    fxp16_deinterleave_scalar,
+    fxp16_interleave_scalar,
+};
+
+/*
+    Implementations that may be selected. With status flags or stats only the scalar
+    kernels report per element, so they are the only choice.
+*/
+#define FXP16_DISPATCH_AVX2     (FXP16_KERNELS_AVX2 && !FXP16CONF_STATUS_FLAGS && !FXP16CONF_STATS)
+
+
+#if FXP16_DISPATCH_AVX2
+static const fxp16_kernel_table_t fxp16_kernels_avx2 = {
+    FXP16_ISA_AVX2,
+    fxp16_flt2fp_vec_avx2,
+    fxp16_fp2flt_vec_avx2,
+    fxp16_dbl2fp_vec_avx2,
+    fxp16_fp2dbl_vec_avx2,
+    fxp16_rshift_vec_avx2,
+    fxp16_lshift_sat_vec_avx2,
+    fxp16_narrow_vec_avx2,
+    fxp16_gemm_kernel_avx2,
+    fxp16_dot32_avx2,
+    fxp16_cmul_vec_avx2,
+    fxp16_cmac_avx2,
+    fxp16_cmag_vec_avx2,
+    fxp16_signmag_or_avx2,
+    fxp16_lut_gather_avx2,
+    fxp16_tanh_vec_avx2,
+    fxp16_sigmoid_vec_avx2,
+    fxp16_round_vec_avx2,
+    fxp16_goertzel_block_avx2,
+    fxp16_sumsq_avx2,
+    fxp16_minmax_avx2,
+    fxp16_deinterleave_avx2,
+    fxp16_interleave_avx2,
+};
+#endif
+
+/* selectable implementations, ascending */
+static const fxp16_kernel_table_t *const fxp16_kernel_tables[] = {
+    &fxp16_kernels_scalar,
+#if FXP16_DISPATCH_AVX2
+    &fxp16_kernels_avx2,
+#endif
+};
+
+#define FXP16_KERNEL_TABLES     (sizeof(fxp16_kernel_tables) / sizeof(fxp16_kernel_tables[0]))
+
+static const char *const fxp16_isa_names[FXP16_ISA_COUNT] = {
+    "scalar", "sse4.1", "avx2", "avx512", "neon"
+};
+
+_Atomic(const fxp16_kernel_table_t *) fxp16_kernels_active = NULL;
+
+
+fxp16_isa_t fxp16_dispatch_cpu(void)
+{
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return FXP16_ISA_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return FXP16_ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return FXP16_ISA_SSE41;
+#elif defined(__aarch64__)
+    #if defined(__linux__)
+        if (getauxval(AT_HWCAP) & HWCAP_ASIMD)
+            return FXP16_ISA_NEON;
+    #else
+        return FXP16_ISA_NEON;
+    #endif
+#elif defined(__arm__) && defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_NEON)
+        return FXP16_ISA_NEON;
+#endif
+
+    return FXP16_ISA_SCALAR;
+}
+
+
+const char *fxp16_isa_name(fxp16_isa_t isa)
+{
+    return ((unsigned)isa < FXP16_ISA_COUNT) ? fxp16_isa_names[isa] : "?";
+}
+
+
+/* level cap from FXP16_ISA, FXP16_ISA_COUNT if unset or unknown */
+static fxp16_isa_t fxp16_dispatch_env(void)
+{
+    const char *env = getenv(FXP16_DISPATCH_ENV);
+
+    for (int isa = 0; env && isa < FXP16_ISA_COUNT; isa++)
+    {
+        if (strcmp(env, fxp16_isa_names[isa]) == 0) return (fxp16_isa_t)isa;
+    }
+
+    return FXP16_ISA_COUNT;
+}
+
+
+const fxp16_kernel_table_t *fxp16_kernels_resolve(void)
+{
+    fxp16_isa_t cpu = fxp16_dispatch_cpu();
+    fxp16_isa_t cap = fxp16_dispatch_env();
+    const fxp16_kernel_table_t *k = &fxp16_kernels_scalar;
+
+    if (cap < cpu) cpu = cap;
+
+    for (size_t i = 0; i < FXP16_KERNEL_TABLES; i++)
+    {
+        if (fxp16_kernel_tables[i]->isa <= cpu) k = fxp16_kernel_tables[i];
+    }
+
+    atomic_store_explicit(&fxp16_kernels_active, k, memory_order_relaxed);
+    return k;
+}
+
+
+fxp16_isa_t fxp16_dispatch_selected(void)
+{
+    return fxp16_kernels()->isa;
+}
+
+
+int fxp16_dispatch_force(fxp16_isa_t isa)
+{
+    fxp16_isa_t cpu = fxp16_dispatch_cpu();
+
+    for (size_t i = 0; i < FXP16_KERNEL_TABLES; i++)
+    {
+        if (fxp16_kernel_tables[i]->isa == isa && isa <= cpu)
+        {
+            atomic_store_explicit(&fxp16_kernels_active, fxp16_kernel_tables[i], memory_order_relaxed);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+
+void fxp16_dispatch_reset(void)
+{
+    atomic_store_explicit(&fxp16_kernels_active, NULL, memory_order_relaxed);
+}
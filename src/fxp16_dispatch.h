@@ -0,0 +1,103 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_dispatch.h
+
+    \brief  Runtime selection of the batched kernels
+
+    \details The batched entry points (*_vec, gemm, complex, bfp, lut gather) run
+             one of several kernel implementations. The best one the CPU supports
+             is selected on first use; the environment variable FXP16_ISA
+             ("scalar", "sse4.1", "avx2", "avx512", "neon") caps the level, and
+             fxp16_dispatch_force() selects an implementation explicitly.
+             Every implementation produces bit-identical results.
+*/
+
+#ifndef _FXP16_DISPATCH_H_
+#define _FXP16_DISPATCH_H_
+
+#include "fxp16.h"
+
+
+#define FXP16_DISPATCH_ENV  "FXP16_ISA"
+
+
+/*! \brief Instruction set levels, ordered within one architecture */
+typedef enum {
+    FXP16_ISA_SCALAR = 0,   /*!< portable C */
+    FXP16_ISA_SSE41,        /*!< x86 SSE4.1 */
+    FXP16_ISA_AVX2,         /*!< x86 AVX2 */
+    FXP16_ISA_AVX512,       /*!< x86 AVX-512 F/BW */
+    FXP16_ISA_NEON,         /*!< ARM Advanced SIMD */
+    FXP16_ISA_COUNT
+} fxp16_isa_t;
+
+
+/*!
+    \brief      Highest level the CPU supports
+    \details    cpuid on x86 (including OS support of the AVX state), getauxval
+                on ARM Linux.
+    \returns    Instruction set level
+*/
+fxp16_isa_t fxp16_dispatch_cpu(void);
+
+/*!
+    \brief      Implementation of the batched kernels in use
+    \details    Resolves the selection if no kernel ran yet. Levels without own
+                kernels run the next lower implementation, e.g. AVX-512 CPUs run
+                the AVX2 kernels.
+    \returns    Instruction set of the selected implementation
+*/
+fxp16_isa_t fxp16_dispatch_selected(void);
+
+/*!
+    \brief      Selects an implementation
+    \details    Meant for tests and diagnostics. Fails if the implementation is
+                not compiled in or not supported by the CPU. Builds with
+                FXP16CONF_STATUS_FLAGS or FXP16CONF_STATS only have the scalar
+                kernels, since only they report per element.
+    \param[in]  isa     Implementation
+    \returns    0 on success, -1 if not available (selection unchanged)
+*/
+int fxp16_dispatch_force(fxp16_isa_t isa);
+
+/*!
+    \brief      Drops a forced selection
+    \details    The next batched call selects again from the CPU and FXP16_ISA.
+*/
+void fxp16_dispatch_reset(void);
+
+/*!
+    \brief      Name of an instruction set level
+    \param[in]  isa     Level
+    \returns    Name as accepted by FXP16_ISA, "?" for unknown levels
+*/
+const char *fxp16_isa_name(fxp16_isa_t isa);
+
+#endif /* _FXP16_DISPATCH_H_ */
@@ -0,0 +1,301 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_gemm.c
+
+    \brief  Quantized fxp16 matrix-matrix and matrix-vector products
+
+    \details Blocked GotoBLAS style driver: B is packed into pmaddwd ready strips
+             per KC x NC block, a 4 x 16 register tile accumulates in 32 bits and
+             the MC x NC accumulator tile is requantized once at the end.
+*/
+
+#include "fxp16_gemm.h"
+#include "fxp16_kernels.h"
+#include <string.h>
+
+#if FXP16CONF_GEMM_THREADS > 1
+#include <pthread.h>
+#endif
+
+#if (FXP16CONF_GEMM_MC % FXP16_GEMM_MR) || (FXP16CONF_GEMM_NC % FXP16_GEMM_NR)
+#error "FXP16CONF_GEMM_MC must be a multiple of 4 and FXP16CONF_GEMM_NC a multiple of 16"
+#endif
+
+
+#define fxp16_gemm_kernel   (fxp16_kernels()->gemm_kernel)
+#define fxp16_dot32         (fxp16_kernels()->dot32)
+
+
+typedef struct {
+    size_t m, n, k;
+    const fxp16_t *a;  size_t lda;  uint8_t a_frac;
+    const fxp16_t *b;  size_t ldb;  uint8_t b_frac;
+    fxp16_t *c;        size_t ldc;  uint8_t c_frac;
+    const uint8_t *c_frac_rows;
+} fxp16_gemm_args_t;
+
+
+void fxp16_gemm_kernel_scalar(size_t kc, const fxp16_t *const a[FXP16_GEMM_MR], const fxp16_t *bp, fxp32_t *acc, size_t ldacc)
+{
+    size_t pairs = (kc + 1) / 2;
+
+    for (int r = 0; r < FXP16_GEMM_MR; r++)
+    {
+        uint32_t sum[FXP16_GEMM_NR];
+
+        for (int j = 0; j < FXP16_GEMM_NR; j++)
+        {
+            sum[j] = (uint32_t)acc[r*ldacc + j];
+        }
+
+        for (size_t p = 0; p < pairs; p++)
+        {
+            const fxp16_t *bpp = bp + p * 2 * FXP16_GEMM_NR;
+            fxp32_t a0 = a[r][2*p];
+            fxp32_t a1 = (2*p + 1 < kc) ? a[r][2*p + 1] : 0;
+
+            for (int j = 0; j < FXP16_GEMM_NR; j++)
+            {
+                sum[j] += (uint32_t)(a0 * bpp[2*j]) + (uint32_t)(a1 * bpp[2*j + 1]);
+            }
+        }
+
+        for (int j = 0; j < FXP16_GEMM_NR; j++)
+        {
+            acc[r*ldacc + j] = (fxp32_t)sum[j];
+        }
+    }
+}
+
+
+fxp32_t fxp16_dot32_scalar(const fxp16_t *a, const fxp16_t *b, size_t n)
+{
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += (uint32_t)((fxp32_t)a[i] * (fxp32_t)b[i]);
+    }
+
+    return (fxp32_t)sum;
+}
+
+
+/* pack rows [0,kc) x columns [0,nc) of b into NR wide pmaddwd strips */
+static void fxp16_gemm_pack_b(size_t kc, size_t nc, const fxp16_t *b, size_t ldb, fxp16_t *bp)
+{
+    size_t pairs = (kc + 1) / 2;
+
+    for (size_t jr = 0; jr < nc; jr += FXP16_GEMM_NR)
+    {
+        for (size_t p = 0; p < pairs; p++)
+        {
+            const fxp16_t *b0 = b + (2*p) * ldb + jr;
+            const fxp16_t *b1 = b0 + ldb;
+            int has_b1 = (2*p + 1 < kc);
+
+            for (size_t j = 0; j < FXP16_GEMM_NR; j++)
+            {
+                int has_col = (jr + j < nc);
+                *bp++ = has_col ? b0[j] : 0;
+                *bp++ = (has_col && has_b1) ? b1[j] : 0;
+            }
+        }
+    }
+}
+
+
+/* single threaded driver for rows [row0, row1) */
+static void fxp16_gemm_rows(const fxp16_gemm_args_t *g, size_t row0, size_t row1)
+{
+    fxp16_t bpack[((FXP16CONF_GEMM_KC + 1) / 2) * 2 * FXP16CONF_GEMM_NC];
+    fxp32_t acc[FXP16CONF_GEMM_MC * FXP16CONF_GEMM_NC];
+    int single_kblock = (g->k <= FXP16CONF_GEMM_KC);
+
+    for (size_t jc = 0; jc < g->n; jc += FXP16CONF_GEMM_NC)
+    {
+        size_t nc = (g->n - jc < FXP16CONF_GEMM_NC) ? (g->n - jc) : FXP16CONF_GEMM_NC;
+
+        for (size_t ic = row0; ic < row1; ic += FXP16CONF_GEMM_MC)
+        {
+            size_t mc = (row1 - ic < FXP16CONF_GEMM_MC) ? (row1 - ic) : FXP16CONF_GEMM_MC;
+
+            memset(acc, 0, sizeof(acc));
+
+            for (size_t pc = 0; pc < g->k; pc += FXP16CONF_GEMM_KC)
+            {
+                size_t kc = (g->k - pc < FXP16CONF_GEMM_KC) ? (g->k - pc) : FXP16CONF_GEMM_KC;
+                size_t strip = ((kc + 1) / 2) * 2 * FXP16_GEMM_NR;
+
+                /* with a single depth block the panel is reused by every row block */
+                if (!single_kblock || ic == row0)
+                {
+                    fxp16_gemm_pack_b(kc, nc, g->b + pc * g->ldb + jc, g->ldb, bpack);
+                }
+
+                for (size_t ir = 0; ir < mc; ir += FXP16_GEMM_MR)
+                {
+                    const fxp16_t *arow[FXP16_GEMM_MR];
+
+                    /* rows past the end repeat the last valid row; their results are dropped */
+                    for (size_t r = 0; r < FXP16_GEMM_MR; r++)
+                    {
+                        size_t row = ic + ir + ((ir + r < mc) ? r : (mc - 1 - ir));
+                        arow[r] = g->a + row * g->lda + pc;
+                    }
+
+                    for (size_t jr = 0; jr < nc; jr += FXP16_GEMM_NR)
+                    {
+                        fxp16_gemm_kernel(kc, arow, bpack + (jr / FXP16_GEMM_NR) * strip,
+                                          acc + ir * FXP16CONF_GEMM_NC + jr, FXP16CONF_GEMM_NC);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < mc; i++)
+            {
+                uint8_t c_frac = g->c_frac_rows ? g->c_frac_rows[ic + i] : g->c_frac;
+                int shift = (int)g->a_frac + (int)g->b_frac - (int)c_frac;
+                fxp16_t *crow = g->c + (ic + i) * g->ldc + jc;
+
+                for (size_t j = 0; j < nc; j++)
+                {
+                    crow[j] = fxp16_requant32(acc[i * FXP16CONF_GEMM_NC + j], shift);
+                }
+            }
+        }
+    }
+}
+
+
+#if FXP16CONF_GEMM_THREADS > 1
+
+typedef struct {
+    const fxp16_gemm_args_t *g;
+    size_t row0, row1;
+} fxp16_gemm_job_t;
+
+static void *fxp16_gemm_worker(void *arg)
+{
+    fxp16_gemm_job_t *job = (fxp16_gemm_job_t *)arg;
+    fxp16_gemm_rows(job->g, job->row0, job->row1);
+    return NULL;
+}
+
+/* split the rows in MR aligned chunks, one per thread */
+static void fxp16_gemm_threaded(const fxp16_gemm_args_t *g)
+{
+    pthread_t tid[FXP16CONF_GEMM_THREADS];
+    fxp16_gemm_job_t job[FXP16CONF_GEMM_THREADS];
+    size_t chunk = (g->m + FXP16CONF_GEMM_THREADS - 1) / FXP16CONF_GEMM_THREADS;
+    int started = 0;
+
+    chunk = (chunk + FXP16_GEMM_MR - 1) / FXP16_GEMM_MR * FXP16_GEMM_MR;
+
+    for (int t = 0; t < FXP16CONF_GEMM_THREADS; t++)
+    {
+        job[t].g = g;
+        job[t].row0 = (size_t)t * chunk;
+        job[t].row1 = (job[t].row0 + chunk < g->m) ? (job[t].row0 + chunk) : g->m;
+    }
+
+    /* thread 0 is the caller; if a thread cannot be created its rows run here */
+    for (int t = 1; t < FXP16CONF_GEMM_THREADS && job[t].row0 < g->m; t++)
+    {
+        if (pthread_create(&tid[t], NULL, fxp16_gemm_worker, &job[t]) != 0)
+        {
+            break;
+        }
+        started = t;
+    }
+
+    fxp16_gemm_rows(g, job[0].row0, job[0].row1);
+
+    for (int t = started + 1; t < FXP16CONF_GEMM_THREADS && job[t].row0 < g->m; t++)
+    {
+        fxp16_gemm_rows(g, job[t].row0, job[t].row1);
+    }
+
+    for (int t = 1; t <= started; t++)
+    {
+        pthread_join(tid[t], NULL);
+    }
+}
+
+#endif /* FXP16CONF_GEMM_THREADS > 1 */
+
+
+void fxp16_gemm(size_t m, size_t n, size_t k,
+                const fxp16_t *a, size_t lda, uint8_t a_frac,
+                const fxp16_t *b, size_t ldb, uint8_t b_frac,
+                fxp16_t *c, size_t ldc, uint8_t c_frac,
+                const uint8_t *c_frac_rows)
+{
+    fxp16_stats_call_m(gemm);
+    fxp16_gemm_args_t g = {
+        m, n, k,
+        a, lda, a_frac,
+        b, ldb, b_frac,
+        c, ldc, c_frac,
+        c_frac_rows
+    };
+
+    if (m == 0 || n == 0)
+    {
+        return;
+    }
+
+#if FXP16CONF_GEMM_THREADS > 1
+    if ((unsigned long)m * n * k >= FXP16CONF_GEMM_MT_MIN_MACS &&
+        m >= 2 * FXP16_GEMM_MR * FXP16CONF_GEMM_THREADS)
+    {
+        fxp16_gemm_threaded(&g);
+        return;
+    }
+#endif
+
+    fxp16_gemm_rows(&g, 0, m);
+}
+
+
+void fxp16_gemv(size_t m, size_t k,
+                const fxp16_t *a, size_t lda, uint8_t a_frac,
+                const fxp16_t *x, uint8_t x_frac,
+                fxp16_t *y, uint8_t y_frac,
+                const uint8_t *y_frac_rows)
+{
+    fxp16_stats_call_m(gemv);
+    for (size_t i = 0; i < m; i++)
+    {
+        uint8_t frac = y_frac_rows ? y_frac_rows[i] : y_frac;
+        fxp32_t acc = fxp16_dot32(a + i * lda, x, k);
+        y[i] = fxp16_requant32(acc, (int)a_frac + (int)x_frac - (int)frac);
+    }
+}
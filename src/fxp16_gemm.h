@@ -0,0 +1,132 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_gemm.h
+
+    \brief  Quantized fxp16 matrix-matrix and matrix-vector products
+
+    \details Dense row-major products for small layers and state-space filters.
+             A, B and the result each carry their own Q format, products are
+             accumulated in 32 bits and requantized once per output element.
+*/
+
+#ifndef _FXP16_GEMM_H_
+#define _FXP16_GEMM_H_
+
+#include "fxp16.h"
+
+
+/*!
+    \brief      Number of threads used by fxp16_gemm for large products
+    \details    1 keeps fxp16_gemm single threaded and free of any pthread dependency.
+                Values > 1 split the rows of large products over that many POSIX threads.
+*/
+#ifndef FXP16CONF_GEMM_THREADS
+#define FXP16CONF_GEMM_THREADS      1
+#endif
+
+/*! \brief Minimum m*n*k before fxp16_gemm starts additional threads */
+#ifndef FXP16CONF_GEMM_MT_MIN_MACS
+#define FXP16CONF_GEMM_MT_MIN_MACS  (1UL << 21)
+#endif
+
+/*!
+    \brief      Cache blocking of fxp16_gemm
+    \details    Row block (MC), column block (NC) and depth block (KC). A packed KC x NC
+                panel of B (int16) and an MC x NC int32 accumulator tile live on the stack.
+                MC must be a multiple of 4 and NC a multiple of 16.
+*/
+#ifndef FXP16CONF_GEMM_MC
+#define FXP16CONF_GEMM_MC           32
+#endif
+#ifndef FXP16CONF_GEMM_NC
+#define FXP16CONF_GEMM_NC           64
+#endif
+#ifndef FXP16CONF_GEMM_KC
+#define FXP16CONF_GEMM_KC           128
+#endif
+
+
+/*!
+    \brief      Quantized matrix-matrix product C = A * B
+    \details    A is m x k in Qa_frac, B is k x n in Qb_frac, C is m x n, all row major
+                with the given leading dimensions (elements per row).
+                Every element of C is the 32 bit sum of its k products (Q(a_frac+b_frac)),
+                rescaled once to the output format with the rounding of fxp32_arshift
+                and saturated to the fxp16 range.
+
+                The accumulator wraps modulo 2^32 like a plain int32 register; keep
+                |sum| < 2^31 (e.g. k * max|a| * max|b| < 2^31) to get meaningful results.
+                All kernel variants and the threaded path are bit-identical.
+
+    \param[in]  m            Rows of A and C.
+    \param[in]  n            Columns of B and C.
+    \param[in]  k            Columns of A, rows of B.
+    \param[in]  a            Matrix A.
+    \param[in]  lda          Leading dimension of A, >= k.
+    \param[in]  a_frac       Fractional bits of A.
+    \param[in]  b            Matrix B.
+    \param[in]  ldb          Leading dimension of B, >= n.
+    \param[in]  b_frac       Fractional bits of B.
+    \param[out] c            Matrix C. Must not overlap A or B.
+    \param[in]  ldc          Leading dimension of C, >= n.
+    \param[in]  c_frac       Fractional bits of C.
+    \param[in]  c_frac_rows  Optional array of m per-row (per output channel) fractional
+                             bit counts overriding \p c_frac, or NULL.
+*/
+void fxp16_gemm(size_t m, size_t n, size_t k,
+                const fxp16_t *a, size_t lda, uint8_t a_frac,
+                const fxp16_t *b, size_t ldb, uint8_t b_frac,
+                fxp16_t *c, size_t ldc, uint8_t c_frac,
+                const uint8_t *c_frac_rows);
+
+/*!
+    \brief      Quantized matrix-vector product y = A * x
+    \details    A is m x k in Qa_frac (row major, leading dimension \p lda), x has k
+                elements in Qx_frac. Accumulation, rounding and saturation follow fxp16_gemm.
+
+    \param[in]  m            Rows of A, elements of y.
+    \param[in]  k            Columns of A, elements of x.
+    \param[in]  a            Matrix A.
+    \param[in]  lda          Leading dimension of A, >= k.
+    \param[in]  a_frac       Fractional bits of A.
+    \param[in]  x            Vector x.
+    \param[in]  x_frac       Fractional bits of x.
+    \param[out] y            Vector y. Must not overlap A or x.
+    \param[in]  y_frac       Fractional bits of y.
+    \param[in]  y_frac_rows  Optional array of m per-row fractional bit counts
+                             overriding \p y_frac, or NULL.
+*/
+void fxp16_gemv(size_t m, size_t k,
+                const fxp16_t *a, size_t lda, uint8_t a_frac,
+                const fxp16_t *x, uint8_t x_frac,
+                fxp16_t *y, uint8_t y_frac,
+                const uint8_t *y_frac_rows);
+
+#endif /* _FXP16_GEMM_H_ */
@@ -0,0 +1,347 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_goertzel.c
+
+    \brief  Goertzel tone detector bank and sliding DFT
+*/
+
+#include "fxp16_goertzel.h"
+#include "fxp16_kernels.h"
+
+
+#define fxp16_goertzel_block_impl   (fxp16_kernels()->goertzel_block)
+
+/* bins per fxp16_cmag_vec call of the magnitude readout */
+#define FXP16_GOERTZEL_CHUNK        64
+
+
+static inline fxp16_t fxp16_goertzel_round(int64_t v, uint8_t shift)
+{
+    fpxx_arshift_m(v, shift);
+    fxp16_sat_m(v);
+    return (fxp16_t)v;
+}
+
+
+int fxp16_goertzel_init(fxp16_goertzel_t *g, const fxp16_t *freq, size_t tones, size_t channels, fxp32_t *state)
+{
+    if (tones == 0 || tones > FXP16CONF_GOERTZEL_MAX_TONES)
+    {
+        return -1;
+    }
+
+    g->tones    = tones;
+    g->channels = channels;
+    g->state    = state;
+
+    for (size_t t = 0; t < tones; t++)
+    {
+        g->cos[t]  = fxp16_cos(freq[t]);
+        g->sin[t]  = fxp16_sin(freq[t]);
+        g->coef[t] = g->cos[t];     /* cos(w) in Q15 is 2 cos(w) in Q14 */
+    }
+
+    fxp16_goertzel_reset(g);
+    return 0;
+}
+
+
+size_t fxp16_goertzel_bytes(size_t tones, size_t channels)
+{
+    return FXP16_ARENA_SIZE(FXP16_GOERTZEL_STATE(tones, channels) * sizeof(fxp32_t));
+}
+
+
+int fxp16_goertzel_init_arena(fxp16_goertzel_t *g, fxp16_arena_t *a, const fxp16_t *freq, size_t tones, size_t channels)
+{
+    size_t mark = fxp16_arena_mark(a);
+    fxp32_t *state = fxp16_arena_alloc(a, FXP16_GOERTZEL_STATE(tones, channels) * sizeof(fxp32_t));
+
+    if (state == NULL || fxp16_goertzel_init(g, freq, tones, channels, state) != 0)
+    {
+        fxp16_arena_release(a, mark);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void fxp16_goertzel_reset(fxp16_goertzel_t *g)
+{
+    for (size_t i = 0; i < FXP16_GOERTZEL_STATE(g->tones, g->channels); i++)
+    {
+        g->state[i] = 0;
+    }
+}
+
+
+void fxp16_goertzel_block_scalar(fxp32_t *s1, fxp32_t *s2, fxp32_t coef, const fxp16_t *x, size_t n, size_t lanes, size_t stride)
+{
+    for (size_t i = 0; i < n; i++, x += stride)
+    {
+        for (size_t l = 0; l < lanes; l++)
+        {
+            uint32_t p = (uint32_t)(((int64_t)coef * s1[l] + (1 << 13)) >> 14);
+            uint32_t s = (uint32_t)(fxp32_t)x[l] + p - (uint32_t)s2[l];
+
+            s2[l] = s1[l];
+            s1[l] = (fxp32_t)s;
+        }
+    }
+}
+
+
+void fxp16_goertzel_block(fxp16_goertzel_t *g, const fxp16_t *x, size_t n)
+{
+    fxp16_stats_call_m(goertzel_block);
+
+    for (size_t t = 0; t < g->tones; t++)
+    {
+        fxp32_t *s1 = g->state + 2 * t * g->channels;
+        fxp16_goertzel_block_impl(s1, s1 + g->channels, g->coef[t], x, n, g->channels, g->channels);
+    }
+}
+
+
+/* bins of tone t, channels c .. c + m - 1 */
+static void fxp16_goertzel_dft_part(const fxp16_goertzel_t *g, size_t t, size_t c, size_t m, fxp16_complex_t *y, uint8_t shift)
+{
+    const fxp32_t *s1 = g->state + 2 * t * g->channels + c;
+    const fxp32_t *s2 = s1 + g->channels;
+
+    for (size_t i = 0; i < m; i++)
+    {
+        y[i].re = fxp16_goertzel_round((int64_t)s1[i] * (1 << FXP16_Q15) - (int64_t)g->cos[t] * s2[i], FXP16_Q15 + shift);
+        y[i].im = fxp16_goertzel_round((int64_t)g->sin[t] * s2[i], FXP16_Q15 + shift);
+    }
+}
+
+
+void fxp16_goertzel_dft(const fxp16_goertzel_t *g, fxp16_complex_t *y, uint8_t shift)
+{
+    for (size_t t = 0; t < g->tones; t++)
+    {
+        fxp16_goertzel_dft_part(g, t, 0, g->channels, y + t * g->channels, shift);
+    }
+}
+
+
+void fxp16_goertzel_mag(const fxp16_goertzel_t *g, fxp16_t *mag, uint8_t shift)
+{
+    fxp16_complex_t y[FXP16_GOERTZEL_CHUNK];
+
+    for (size_t t = 0; t < g->tones; t++)
+    {
+        for (size_t c = 0; c < g->channels; c += FXP16_GOERTZEL_CHUNK)
+        {
+            size_t m = g->channels - c < FXP16_GOERTZEL_CHUNK ? g->channels - c : FXP16_GOERTZEL_CHUNK;
+
+            fxp16_goertzel_dft_part(g, t, c, m, y, shift);
+            fxp16_cmag_vec(y, mag + t * g->channels + c, m);
+        }
+    }
+}
+
+
+void fxp16_goertzel_power(const fxp16_goertzel_t *g, fxp32_t *pow, uint8_t shift)
+{
+    fxp16_complex_t y[FXP16_GOERTZEL_CHUNK];
+    fxp16_t mag[FXP16_GOERTZEL_CHUNK];
+
+    for (size_t t = 0; t < g->tones; t++)
+    {
+        for (size_t c = 0; c < g->channels; c += FXP16_GOERTZEL_CHUNK)
+        {
+            size_t m = g->channels - c < FXP16_GOERTZEL_CHUNK ? g->channels - c : FXP16_GOERTZEL_CHUNK;
+
+            fxp16_goertzel_dft_part(g, t, c, m, y, shift);
+            fxp16_cmag_vec(y, mag, m);
+
+            for (size_t i = 0; i < m; i++)
+            {
+                pow[t * g->channels + c + i] = (fxp32_t)mag[i] * mag[i];
+            }
+        }
+    }
+}
+
+
+/* (c + jd)^n in Q30 by square and multiply, c and d in Q15 */
+static void fxp16_sdft_cpow(fxp32_t c, fxp32_t d, size_t n, fxp32_t *pr, fxp32_t *pi)
+{
+    int64_t br = c * (1 << FXP16_Q15), bi = d * (1 << FXP16_Q15);
+    int64_t yr = (int64_t)1 << 30, yi = 0;
+
+    for (; n; n >>= 1)
+    {
+        if (n & 1)
+        {
+            int64_t tr = yr * br - yi * bi;
+            int64_t ti = yr * bi + yi * br;
+            fpxx_arshift_m(tr, 30);
+            fpxx_arshift_m(ti, 30);
+            yr = tr;
+            yi = ti;
+        }
+
+        int64_t sr = br * br - bi * bi;
+        int64_t si = 2 * br * bi;
+        fpxx_arshift_m(sr, 30);
+        fpxx_arshift_m(si, 30);
+        br = sr;
+        bi = si;
+    }
+
+    *pr = (fxp32_t)yr;
+    *pi = (fxp32_t)yi;
+}
+
+
+int fxp16_sdft_init(fxp16_sdft_t *s, size_t len, const size_t *k, size_t bins, fxp16_t *delay)
+{
+    if (len == 0 || len > 32768 || bins == 0 || bins > FXP16CONF_SDFT_MAX_BINS)
+    {
+        return -1;
+    }
+
+    s->len   = len;
+    s->pos   = 0;
+    s->bins  = bins;
+    s->delay = delay;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        delay[i] = 0;
+    }
+
+    for (size_t b = 0; b < bins; b++)
+    {
+        /* 2 k / len, π-normalized Q15, wraps like an angle */
+        fxp16_t w = (fxp16_t)(uint16_t)((((uint64_t)k[b] << 17) + len) / (2 * len));
+        fxp32_t c = fxp16_cos(w);
+        fxp32_t d = fxp16_sin(w);
+
+        /* trim the larger component until |twiddle| < 1 */
+        while (c * c + d * d >= (1 << 30))
+        {
+            if ((c < 0 ? -c : c) >= (d < 0 ? -d : d)) c -= (c > 0) - (c < 0);
+            else                                      d -= (d > 0) - (d < 0);
+        }
+
+        s->cos[b] = (fxp16_t)c;
+        s->sin[b] = (fxp16_t)d;
+        fxp16_sdft_cpow(c, d, len, &s->comb_re[b], &s->comb_im[b]);
+        s->re[b]  = 0;
+        s->im[b]  = 0;
+    }
+
+    return 0;
+}
+
+
+size_t fxp16_sdft_bytes(size_t len)
+{
+    return FXP16_ARENA_SIZE(len * sizeof(fxp16_t));
+}
+
+
+int fxp16_sdft_init_arena(fxp16_sdft_t *s, fxp16_arena_t *a, size_t len, const size_t *k, size_t bins)
+{
+    size_t mark = fxp16_arena_mark(a);
+    fxp16_t *delay = fxp16_arena_alloc(a, len * sizeof(fxp16_t));
+
+    if (delay == NULL || fxp16_sdft_init(s, len, k, bins, delay) != 0)
+    {
+        fxp16_arena_release(a, mark);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void fxp16_sdft_update(fxp16_sdft_t *s, fxp16_t x)
+{
+    fxp16_stats_call_m(sdft_update);
+
+    int64_t in  = (int64_t)x * ((int64_t)1 << FXP16_SDFT_GUARD_BITS);
+    fxp32_t out = s->delay[s->pos];
+
+    s->delay[s->pos] = x;
+    if (++s->pos == s->len) s->pos = 0;
+
+    for (size_t b = 0; b < s->bins; b++)
+    {
+        int64_t cr = (int64_t)out * s->comb_re[b];
+        int64_t ci = (int64_t)out * s->comb_im[b];
+
+        fpxx_arshift_m(cr, 30 - FXP16_SDFT_GUARD_BITS);
+        fpxx_arshift_m(ci, 30 - FXP16_SDFT_GUARD_BITS);
+
+        int64_t re = s->re[b] + in - cr;
+        int64_t im = s->im[b] - ci;
+        int64_t yr = re * s->cos[b] - im * s->sin[b];
+        int64_t yi = re * s->sin[b] + im * s->cos[b];
+
+        fpxx_arshift_m(yr, FXP16_Q15);
+        fpxx_arshift_m(yi, FXP16_Q15);
+        s->re[b] = yr;
+        s->im[b] = yi;
+    }
+}
+
+
+void fxp16_sdft_block(fxp16_sdft_t *s, const fxp16_t *x, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp16_sdft_update(s, x[i]);
+    }
+}
+
+
+void fxp16_sdft_dft(const fxp16_sdft_t *s, fxp16_complex_t *y, uint8_t shift)
+{
+    for (size_t b = 0; b < s->bins; b++)
+    {
+        y[b].re = fxp16_goertzel_round(s->re[b], FXP16_SDFT_GUARD_BITS + shift);
+        y[b].im = fxp16_goertzel_round(s->im[b], FXP16_SDFT_GUARD_BITS + shift);
+    }
+}
+
+
+void fxp16_sdft_mag(const fxp16_sdft_t *s, fxp16_t *mag, uint8_t shift)
+{
+    fxp16_complex_t y[FXP16CONF_SDFT_MAX_BINS];
+
+    fxp16_sdft_dft(s, y, shift);
+    fxp16_cmag_vec(y, mag, s->bins);
+}
@@ -0,0 +1,227 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_goertzel.h
+
+    \brief  Goertzel tone detector bank and sliding DFT
+
+    \details Both evaluate single DFT bins instead of a full FFT, which is cheaper
+             as long as only a handful of tones is of interest.
+
+             fxp16_goertzel_t runs a set of tones over many parallel channels in
+             blocks. Samples are interleaved by channel, x[i * channels + c], and the
+             recurrence of one tone runs across the channels in SIMD lanes.
+
+             fxp16_sdft_t updates a few bins of a single channel with every sample,
+             for detectors that need a decision per sample instead of per block.
+
+             Frequencies are π-normalized Q15 like all angles of the library, i.e.
+             f / (fs / 2): 16384 is fs / 4. Bin values are read out with a right
+             shift chosen by the caller and their magnitude comes from the CORDIC
+             vectoring of fxp16_cmag_vec().
+*/
+
+#ifndef _FXP16_GOERTZEL_H_
+#define _FXP16_GOERTZEL_H_
+
+#include "fxp16.h"
+#include "fxp16_arena.h"
+#include "fxp16_complex.h"
+
+
+/*! \brief Maximum number of tones of a fxp16_goertzel_t bank */
+#ifndef FXP16CONF_GOERTZEL_MAX_TONES
+#define FXP16CONF_GOERTZEL_MAX_TONES    8
+#endif
+
+/*! \brief Maximum number of bins of a fxp16_sdft_t */
+#ifndef FXP16CONF_SDFT_MAX_BINS
+#define FXP16CONF_SDFT_MAX_BINS         8
+#endif
+
+/*! \brief Number of fxp32_t state words a bank of \p tones x \p channels needs */
+#define FXP16_GOERTZEL_STATE(tones, channels)   (2 * (tones) * (channels))
+
+
+/*!
+    \brief      Goertzel filter bank
+    \details    Per tone and channel the recurrence
+
+                    s[n] = x[n] + 2 cos(w) s[n-1] - s[n-2]
+
+                runs in 32 bit, with 2 cos(w) in Q14 taken from fxp16_cos() at init.
+                The state grows with the block length, by up to n / (2 sin(w)) times
+                the input amplitude for a tone on the bin. It wraps instead of
+                saturating, so blocks must be short enough for that to stay below 2^16
+                at full scale input, or the input must be pre-scaled.
+*/
+typedef struct {
+    size_t   tones;
+    size_t   channels;
+    fxp32_t  coef[FXP16CONF_GOERTZEL_MAX_TONES];   /*!< 2 cos(w), Q14 */
+    fxp16_t  cos[FXP16CONF_GOERTZEL_MAX_TONES];    /*!< cos(w), Q15 */
+    fxp16_t  sin[FXP16CONF_GOERTZEL_MAX_TONES];    /*!< sin(w), Q15 */
+    fxp32_t *state;     /*!< s[n-1] and s[n-2] of each tone, channels each, caller storage */
+} fxp16_goertzel_t;
+
+/*! \brief Fractional guard bits of the fxp16_sdft_t bin state */
+#define FXP16_SDFT_GUARD_BITS   16
+
+/*!
+    \brief      Sliding DFT
+    \details    Per bin k of a window of len samples, with the twiddle w = e^(j 2 pi k / len)
+
+                    S[n] = w (S[n-1] + x[n] - w^len x[n-len])
+
+                The bins hold the window sum, up to len times the input amplitude, with
+                FXP16_SDFT_GUARD_BITS extra fractional bits in 64 bit so that the rounding
+                of the rotations does not add up. The Q15 twiddles are trimmed to a
+                magnitude just below 1, which damps the remaining rounding errors instead
+                of letting them grow, at the price of a gain loss of a few 0.1 %. The leaving sample is weighted with w^len as
+                computed from the rounded twiddle, so that it cancels exactly what the
+                recurrence made of it len samples ago.
+*/
+typedef struct {
+    size_t   len;
+    size_t   pos;
+    size_t   bins;
+    fxp16_t  cos[FXP16CONF_SDFT_MAX_BINS];         /*!< twiddle, Q15 */
+    fxp16_t  sin[FXP16CONF_SDFT_MAX_BINS];         /*!< twiddle, Q15 */
+    int64_t  re[FXP16CONF_SDFT_MAX_BINS];
+    int64_t  im[FXP16CONF_SDFT_MAX_BINS];
+    fxp32_t  comb_re[FXP16CONF_SDFT_MAX_BINS];     /*!< twiddle^len, Q30 */
+    fxp32_t  comb_im[FXP16CONF_SDFT_MAX_BINS];     /*!< twiddle^len, Q30 */
+    fxp16_t *delay;     /*!< the last len samples, caller storage */
+} fxp16_sdft_t;
+
+
+/*!
+    \brief      Sets up a Goertzel bank and clears its state
+    \param[out] g           Bank
+    \param[in]  freq        Tone frequencies, π-normalized Q15
+    \param[in]  tones       Number of tones (1..FXP16CONF_GOERTZEL_MAX_TONES)
+    \param[in]  channels    Number of channels
+    \param[in]  state       FXP16_GOERTZEL_STATE(tones, channels) words
+    \returns    0 on success, -1 if \p tones is out of range
+*/
+int fxp16_goertzel_init(fxp16_goertzel_t *g, const fxp16_t *freq, size_t tones, size_t channels, fxp32_t *state);
+
+/*! \brief Arena bytes fxp16_goertzel_init_arena() takes */
+size_t fxp16_goertzel_bytes(size_t tones, size_t channels);
+
+/*!
+    \brief      fxp16_goertzel_init() with the state taken from an arena
+    \returns    0 on success, -1 if \p tones is out of range or the arena is too
+                small; the arena is unchanged then
+*/
+int fxp16_goertzel_init_arena(fxp16_goertzel_t *g, fxp16_arena_t *a, const fxp16_t *freq, size_t tones, size_t channels);
+
+/*!
+    \brief      Clears the state for a new block
+*/
+void fxp16_goertzel_reset(fxp16_goertzel_t *g);
+
+/*!
+    \brief      Feeds samples into every tone of every channel
+    \details    May be called several times per block.
+    \param[in]  g       Bank
+    \param[in]  x       n samples per channel, interleaved x[i * channels + c]
+    \param[in]  n       Number of samples per channel
+*/
+void fxp16_goertzel_block(fxp16_goertzel_t *g, const fxp16_t *x, size_t n);
+
+/*!
+    \brief      DFT bins of the current block
+    \details    y = s[n-1] - e^(-jw) s[n-2], which is the DFT at the tone frequency up
+                to a phase rotation, divided by 2^shift, rounded and saturated.
+                A tone of amplitude A on the bin of an n sample block gives
+                |y| = A n / 2^(shift + 1).
+    \param[in]  g       Bank
+    \param[out] y       Bins, y[tone * channels + c]
+    \param[in]  shift   Right shift of the bins
+*/
+void fxp16_goertzel_dft(const fxp16_goertzel_t *g, fxp16_complex_t *y, uint8_t shift);
+
+/*!
+    \brief      Magnitudes of fxp16_goertzel_dft()
+    \param[out] mag     Magnitudes, mag[tone * channels + c]
+*/
+void fxp16_goertzel_mag(const fxp16_goertzel_t *g, fxp16_t *mag, uint8_t shift);
+
+/*!
+    \brief      Power of fxp16_goertzel_dft(), the squared magnitude
+    \param[out] pow     Power, pow[tone * channels + c]
+*/
+void fxp16_goertzel_power(const fxp16_goertzel_t *g, fxp32_t *pow, uint8_t shift);
+
+
+/*!
+    \brief      Sets up a sliding DFT with an all zero window
+    \param[out] s       Sliding DFT
+    \param[in]  len     Window length in samples (1..32768)
+    \param[in]  k       Bin indices, k / len is the frequency in cycles per sample
+    \param[in]  bins    Number of bins (1..FXP16CONF_SDFT_MAX_BINS)
+    \param[in]  delay   len samples
+    \returns    0 on success, -1 if \p len or \p bins is out of range
+*/
+int fxp16_sdft_init(fxp16_sdft_t *s, size_t len, const size_t *k, size_t bins, fxp16_t *delay);
+
+/*! \brief Arena bytes fxp16_sdft_init_arena() takes */
+size_t fxp16_sdft_bytes(size_t len);
+
+/*!
+    \brief      fxp16_sdft_init() with the delay line taken from an arena
+    \returns    0 on success, -1 if \p len or \p bins is out of range or the arena is
+                too small; the arena is unchanged then
+*/
+int fxp16_sdft_init_arena(fxp16_sdft_t *s, fxp16_arena_t *a, size_t len, const size_t *k, size_t bins);
+
+/*!
+    \brief      Slides the window by one sample
+*/
+void fxp16_sdft_update(fxp16_sdft_t *s, fxp16_t x);
+
+/*!
+    \brief      Slides the window by n samples
+*/
+void fxp16_sdft_block(fxp16_sdft_t *s, const fxp16_t *x, size_t n);
+
+/*!
+    \brief      Bins of the current window divided by 2^shift, rounded and saturated
+    \details    A tone of amplitude A on bin k gives |y| = A len / 2^(shift + 1).
+    \param[out] y   Bins
+*/
+void fxp16_sdft_dft(const fxp16_sdft_t *s, fxp16_complex_t *y, uint8_t shift);
+
+/*!
+    \brief      Magnitudes of fxp16_sdft_dft()
+*/
+void fxp16_sdft_mag(const fxp16_sdft_t *s, fxp16_t *mag, uint8_t shift);
+
+#endif /* _FXP16_GOERTZEL_H_ */
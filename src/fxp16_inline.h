@@ -0,0 +1,248 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_inline.h
+
+    \brief  Definitions of the trivial arithmetic functions
+
+    \details Holds the one and only definition of fxp16_add(), fxp16_sub(), fxp16_mult(),
+             fxp16_fabs(), fxp16_sat(), fxp16_arshift() and fxp32_arshift(), and of the
+             per-call rounding variants fxp32_arshift_mode(), fxp16_mult_mode() and
+             fxp16_fp2fp_mode().
+
+             With FXP16CONF_INLINE = 1 fxp16.h includes this file so every translation
+             unit gets static inline copies, which lets the compiler inline and vectorize
+             loops built from the scalar API. fxp16.c always includes it with an empty
+             FXP16_INLINE_DEF to emit the exported definitions, so the library keeps the
+             same symbols whatever the callers select.
+
+             Not guarded against multiple inclusion on purpose; include fxp16.h instead.
+*/
+
+#ifndef FXP16_INLINE_DEF
+#define FXP16_INLINE_DEF static inline
+#endif
+
+
+#if FXP16CONF_ARSHIFT_W_ROUNDING
+
+FXP16_INLINE_DEF fxp16_t fxp16_arshift(fxp16_t fp, uint8_t shift)
+{
+   fpxx_arshift_m(fp,shift);
+   return fp;
+}
+
+FXP16_INLINE_DEF fxp32_t fxp32_arshift(fxp32_t var,uint8_t rshift)
+{
+    fpxx_arshift_m(var,rshift);
+    return var;
+}
+
+#endif
+
+
+/*!
+    \brief      Saturates a 32 bit intermediate result to fixed point 16 bits limits
+    \param      fxp32   int32_t result to be saturated
+    \returns    Saturated fixed point number
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_sat(fxp32_t fxp32)
+{
+    fxp16_sat_m(fxp32);
+    return (fxp16_t) fxp32;
+}
+
+
+
+/*!
+    \brief      Adds two fixed point numbers
+    \details    Adds two fixed point numbers. Result gets saturated if it exceeds fixed point limits.
+
+                result = a + b
+
+                Be aware of that both fixed point numbers must be of same type (same number of fractional bits)!
+                Otherwise the result may be undefined.
+
+    \param[in]  summand1       First fixed point summand
+    \param[in]  summand2       Second fixed point summand
+
+
+    \returns Sum of first summand and second summand in fixed point format
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_add(fxp16_t summand1, fxp16_t summand2)
+{
+    fxp16_stats_call_m(add);
+    int32_t result;
+    result = summand1+summand2;
+    fxp16_sat_m(result);
+    return(fxp16_t)result;
+}
+
+/*!
+    \brief     Subtracts two fixed point numbers
+    \details    Adds two fixed point number. Result gets saturated if it exceeds fixed point limits.
+
+                result = a - b
+
+                Be aware of that both fixed point numbers must be of same type (same number of fractional bits)!
+                Otherwise the result may be undefined.
+
+    \param[in]  minuend     Minuend
+    \param[in]  subtrahend  Subtrahend
+
+
+    \returns Difference of minuend and subtrahend in fixed point format
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_sub(fxp16_t minuend, fxp16_t subtrahend)
+{
+    fxp16_stats_call_m(sub);
+   int32_t result;
+   result = minuend-subtrahend;
+   fxp16_sat_m(result);
+   return(fxp16_t)result;
+}
+
+
+/*!
+    \brief      Multiplies two fixed point numbers
+    \details    Multiplies two fixed point numbers. The numbers may be of different fixed point format.
+                The result is in the fixed point format of the multiplicand (1st fixed point parameter).
+                Result gets saturated if it exceeds fixed point limits.
+
+                When performing an integer multiplication the product is 2xWL if both the multiplier and
+                multiplicand are WL long. If the integer multiplication is on fixed-point variables, the number of
+                integer and fractional bits in the product is the sum of the corresponding multiplier and
+                multiplicand Q-points.
+
+                result = a*b
+
+
+    \param[in]  mult1     multiplicator
+    \param[in]  mult2     multiplicant
+
+
+    \returns Product of multiplicator and multiplicant in fixed point format of multiplicator
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_mult(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2)
+{
+    fxp16_stats_call_m(mult);
+    (void)frac1;
+    fxp32_t result = (fxp32_t)mult1*(fxp32_t)mult2;
+    fpxx_arshift_m(result,frac2);
+    fxp16_sat_m(result);
+    fxp16_status_underflow_m(mult1 != 0 && mult2 != 0, result);
+    return (fxp16_t)result;
+}
+
+
+/*!
+    \brief      Right shift with a rounding mode
+    \details    Evaluated in 64 bits, so the rounding offsets cannot overflow.
+    \param      var     Value to shift
+    \param      rshift  Number of bits, 0..31
+    \param      mode    Rounding mode
+    \param      rng     Generator, only used (and required) by FXP16_ROUND_STOCHASTIC
+    \returns    var / 2^rshift rounded by mode
+*/
+FXP16_INLINE_DEF fxp32_t fxp32_arshift_mode(fxp32_t var, uint8_t rshift, fxp16_round_mode_t mode, fxp16_rng_t *rng)
+{
+    int64_t v = var;
+    int64_t m = ((int64_t)1 << rshift) - 1;
+    int64_t h = ((int64_t)1 << rshift) >> 1;
+
+    if (rshift == 0)
+    {
+        return var;
+    }
+
+    switch (mode)
+    {
+        case FXP16_ROUND_FLOOR:         break;
+        case FXP16_ROUND_CEIL:          v += m; break;
+        case FXP16_ROUND_TRUNC:         v += (v < 0) ? m : 0; break;
+        case FXP16_ROUND_HALF_UP:       v += h; break;
+        case FXP16_ROUND_NEAREST_EVEN:  v += h - 1 + ((v >> rshift) & 1); break;
+        case FXP16_ROUND_STOCHASTIC:    v += fxp16_rng_next(rng) & m; break;
+        default:                        v += (v < 0) ? h - 1 : h; break;    /* nearest, away */
+    }
+
+    return (fxp32_t)(v >> rshift);
+}
+
+
+/*!
+    \brief      fxp16_mult() with a rounding mode for the product
+    \details    Same as fxp16_mult() except that the product is shifted by
+                fxp32_arshift_mode() instead of fxp32_arshift().
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_mult_mode(fxp16_t mult1, uint8_t frac1, fxp16_t mult2, uint8_t frac2, fxp16_round_mode_t mode, fxp16_rng_t *rng)
+{
+    fxp16_stats_call_m(mult);
+    (void)frac1;
+    fxp32_t result = fxp32_arshift_mode((fxp32_t)mult1*(fxp32_t)mult2, frac2, mode, rng);
+    fxp16_sat_m(result);
+    fxp16_status_underflow_m(mult1 != 0 && mult2 != 0, result);
+    return (fxp16_t)result;
+}
+
+
+/*!
+    \brief      fxp16_fp2fp() with a rounding mode for conversions to fewer fractional bits
+    \details    Conversions to more fractional bits are exact and saturate like fxp16_fp2fp().
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_fp2fp_mode(fxp16_t fp, uint8_t fracold, uint8_t fracnew, fxp16_round_mode_t mode, fxp16_rng_t *rng)
+{
+    if (fracold <= fracnew)
+    {
+        return fxp16_fp2fp(fp, fracold, fracnew);
+    }
+
+    fxp16_stats_call_m(fp2fp);
+    fxp32_t result = fxp32_arshift_mode(fp, fracold - fracnew, mode, rng);
+    fxp16_status_underflow_m(fp != 0, result);
+    return (fxp16_t)result;
+}
+
+
+/*!
+    \brief      Compute absolute value
+    \details    Returns the absolute value of x: |x|.
+
+
+    \param      x
+    \returns     absolute value of x
+
+*/
+FXP16_INLINE_DEF fxp16_t fxp16_fabs (fxp16_t x)
+{
+    fxp16_stats_call_m(fabs);
+   int32_t result = (x < 0) ? (-(int32_t)x) : ((int32_t)x);
+   fxp16_sat_m(result);
+   return result;
+}
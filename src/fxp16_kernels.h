@@ -0,0 +1,438 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_kernels.h
+
+    \brief  Internal declarations shared by the batched fxp16 kernels
+
+    \details Not part of the public API. Holds the per-ISA kernel variants behind
+             the public *_vec entry points and the small element helpers their
+             scalar tails share, so every variant produces bit-identical results.
+*/
+
+#ifndef _FXP16_KERNELS_H_
+#define _FXP16_KERNELS_H_
+
+#include "fxp16.h"
+#include "fxp16_complex.h"
+#include "fxp16_dispatch.h"
+#include <stdatomic.h>
+
+
+/*
+    Kernel variants compiled into this build. fxp16_avx2.c enables AVX2 for its own
+    functions, so the AVX2 kernels exist on every x86 GCC/Clang build and are picked
+    at runtime by the dispatcher (fxp16_dispatch.c).
+*/
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define FXP16_KERNELS_AVX2  1
+#else
+    #define FXP16_KERNELS_AVX2  0
+#endif
+
+
+/* ---- tanh / sigmoid lookup table --------------------------------------- */
+
+#define FXP16_TANH_LUT_FRAC         16                              /* table input format: |x| in Q16 */
+#define FXP16_TANH_LUT_STEP_BITS    10                              /* knot spacing 2^-6 in Q16 */
+#define FXP16_TANH_LUT_STEP_MASK    ((1 << FXP16_TANH_LUT_STEP_BITS) - 1)
+#define FXP16_TANH_LUT_XMAX         (6 << FXP16_TANH_LUT_FRAC)      /* tanh(6) rounds to 1-LSB in Q15 */
+#define FXP16_TANH_LUT_SIZE         386                             /* 385 knots on [0,6] + 1 pad for the pair load */
+
+extern const int16_t fxp16_tanh_lut_q15[FXP16_TANH_LUT_SIZE];
+
+
+/*!
+    \brief      Linear interpolation in the tanh table
+    \param[in]  v   |x| in Q16, up to 2^31 (|INT16_MIN| read as Q0)
+    \returns    tanh(v) in Q15, in [0, 32767]
+*/
+static inline fxp32_t fxp16_tanh_lut_eval(uint32_t v)
+{
+    if (v > FXP16_TANH_LUT_XMAX) v = FXP16_TANH_LUT_XMAX;
+
+    fxp32_t i  = v >> FXP16_TANH_LUT_STEP_BITS;
+    fxp32_t f  = v & FXP16_TANH_LUT_STEP_MASK;
+    fxp32_t t0 = fxp16_tanh_lut_q15[i];
+    fxp32_t t1 = fxp16_tanh_lut_q15[i+1];
+
+    return t0 + (((t1 - t0) * f + (1 << (FXP16_TANH_LUT_STEP_BITS - 1))) >> FXP16_TANH_LUT_STEP_BITS);
+}
+
+/*!
+    \brief      Table based tanh of one element
+    \details    Rounds the magnitude, so the result is exactly odd symmetric.
+*/
+static inline fxp16_t fxp16_tanh_lut(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
+{
+    uint8_t shift = FXP16_Q15 - y_frac;
+    uint32_t v = (x < 0) ? -(fxp32_t)x : (fxp32_t)x;
+    fxp32_t t = fxp16_tanh_lut_eval(v << (FXP16_TANH_LUT_FRAC - x_frac));
+
+    t = (t + ((1 << shift) >> 1)) >> shift;
+    return (fxp16_t)((x < 0) ? -t : t);
+}
+
+/*!
+    \brief      Table based sigmoid of one element
+    \details    sigmoid(x) = (1 + tanh(x/2)) / 2, evaluated in Q16 and rounded once
+                to the output format. x/2 is obtained for free by reading x as Q(x_frac+1).
+*/
+static inline fxp16_t fxp16_sigmoid_lut(uint8_t y_frac, fxp16_t x, uint8_t x_frac)
+{
+    uint8_t shift = 16 - y_frac;
+    uint32_t v = (x < 0) ? -(fxp32_t)x : (fxp32_t)x;
+    fxp32_t t = fxp16_tanh_lut_eval(v << (FXP16_TANH_LUT_FRAC - x_frac - 1));
+    fxp32_t q = (1 << 15) + ((x < 0) ? -t : t);
+
+    q = (q + ((1 << shift) >> 1)) >> shift;
+    fxp16_sat_m(q);
+    return (fxp16_t)q;
+}
+
+/* ---- float <-> fixed conversion ----------------------------------------- */
+
+/* fxp16_flt2fp / fxp16_dbl2fp with a defined result for NaN, as produced by the vector lanes */
+static inline fxp16_t fxp16_flt2fp_elem(float x, uint8_t frac)
+{
+    if (x != x)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_flt2fp(x, frac);
+}
+
+static inline fxp16_t fxp16_dbl2fp_elem(double x, uint8_t frac)
+{
+    if (x != x)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_dbl2fp(x, frac);
+}
+
+void fxp16_flt2fp_vec_scalar(const float *x, fxp16_t *y, size_t n, uint8_t frac);
+void fxp16_fp2flt_vec_scalar(const fxp16_t *x, float *y, size_t n, uint8_t frac);
+void fxp16_dbl2fp_vec_scalar(const double *x, fxp16_t *y, size_t n, uint8_t frac);
+void fxp16_fp2dbl_vec_scalar(const fxp16_t *x, double *y, size_t n, uint8_t frac);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_flt2fp_vec_avx2(const float *x, fxp16_t *y, size_t n, uint8_t frac);
+void fxp16_fp2flt_vec_avx2(const fxp16_t *x, float *y, size_t n, uint8_t frac);
+void fxp16_dbl2fp_vec_avx2(const double *x, fxp16_t *y, size_t n, uint8_t frac);
+void fxp16_fp2dbl_vec_avx2(const fxp16_t *x, double *y, size_t n, uint8_t frac);
+#endif
+
+
+/* ---- requantization of 32 bit accumulators ----------------------------- */
+
+/*!
+    \brief      Branch free fpxx_arshift_m for shift > 0
+*/
+static inline fxp32_t fxp32_rshift_round_elem(fxp32_t v, int shift)
+{
+    fxp32_t t = v >> (shift - 1);
+    return (t >> 1) + (t & 1 & ~(t >> 31));
+}
+
+/*!
+    \brief      Rescale a 32 bit accumulator to fxp16
+    \details    Right shifts round like fxp32_arshift, left shifts and the final
+                narrowing saturate to the fxp16 range.
+    \param[in]  acc     32 bit accumulator
+    \param[in]  shift   Number of bits to shift (+ = rshift, - = lshift), -31..31
+*/
+static inline fxp16_t fxp16_requant32(fxp32_t acc, int shift)
+{
+    if (shift > 0)
+    {
+        fxp32_t in = acc;
+        fpxx_arshift_m(acc, shift);
+        fxp16_sat_m(acc);
+        fxp16_status_underflow_m(in != 0, acc);
+        return (fxp16_t)acc;
+    }
+
+    int64_t wide = (int64_t)acc * ((int64_t)1 << -shift);
+    fxp16_sat_m(wide);
+    return (fxp16_t)wide;
+}
+
+
+/* shift > 0 rounds right, shift < 0 saturates left, narrow: shift = fracold - fracnew, -31..31 */
+void fxp16_rshift_vec_scalar(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+void fxp16_lshift_sat_vec_scalar(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+void fxp16_narrow_vec_scalar(const fxp32_t *in, fxp16_t *out, size_t n, int shift);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_rshift_vec_avx2(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+void fxp16_lshift_sat_vec_avx2(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+void fxp16_narrow_vec_avx2(const fxp32_t *in, fxp16_t *out, size_t n, int shift);
+#endif
+
+
+/* ---- rounding to integral values --------------------------------------- */
+
+/*!
+    \brief      Branch free rounding of one element to a multiple of 2^frac
+    \param[in]  v       Value
+    \param[in]  frac    Number of fractional bits, 1..15
+    \param[in]  mode    Rounding mode, FXP16_ROUND_STOCHASTIC and unknown modes round
+                        like FXP16_ROUND_NEAREST_AWAY
+    \returns    Rounded value before saturation, in [-32768, 65535]
+*/
+static inline fxp32_t fxp16_round_elem(fxp32_t v, uint8_t frac, fxp16_round_mode_t mode)
+{
+    fxp32_t m = (1 << frac) - 1;
+    fxp32_t h = 1 << (frac - 1);
+    fxp32_t s = v >> 31;
+
+    switch (mode)
+    {
+        case FXP16_ROUND_NEAREST_EVEN:  return (v + h - 1 + ((v >> frac) & 1)) & ~m;
+        case FXP16_ROUND_FLOOR:         return v & ~m;
+        case FXP16_ROUND_CEIL:          return (v + m) & ~m;
+        case FXP16_ROUND_TRUNC:         return (v + (m & s)) & ~m;
+        case FXP16_ROUND_HALF_UP:       return (v + h) & ~m;
+        default:                        return ((((v ^ s) - s + h) & ~m) ^ s) - s;
+    }
+}
+
+/* y = sat(round(x) >> shift), shift is 0 (same format) or frac (integral value) */
+void fxp16_round_vec_scalar(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode, uint8_t shift);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_round_vec_avx2(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode, uint8_t shift);
+#endif
+
+
+/* ---- gemm / gemv -------------------------------------------------------- */
+
+#define FXP16_GEMM_MR   4       /* rows of the register tile */
+#define FXP16_GEMM_NR   16      /* columns of the register tile / width of a packed B strip */
+
+/*
+    Packed B strip: for every pair of rows (2p, 2p+1) of a KC block, NR interleaved
+    column pairs {b[2p][j], b[2p+1][j]}, j = 0..NR-1. Odd depths and missing columns
+    are zero padded. This is the operand layout of pmaddwd.
+
+    The micro kernel adds the MR x NR products of one KC block to acc (row stride
+    ldacc). Sums wrap modulo 2^32, which keeps every variant bit-identical.
+*/
+void fxp16_gemm_kernel_scalar(size_t kc, const fxp16_t *const a[FXP16_GEMM_MR], const fxp16_t *bp, fxp32_t *acc, size_t ldacc);
+fxp32_t fxp16_dot32_scalar(const fxp16_t *a, const fxp16_t *b, size_t n);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_gemm_kernel_avx2(size_t kc, const fxp16_t *const a[FXP16_GEMM_MR], const fxp16_t *bp, fxp32_t *acc, size_t ldacc);
+fxp32_t fxp16_dot32_avx2(const fxp16_t *a, const fxp16_t *b, size_t n);
+#endif
+
+
+/* ---- complex ------------------------------------------------------------ */
+
+#define FXP16_CMAG_GUARD_BITS   14              /* extra fractional bits of the vectoring state */
+#define FXP16_CMAG_ITERATIONS   15
+#define FXP16_CMAG_K_Q31        1304065749u     /* prod 1/sqrt(1 + 2^-2i), i = 0..14, in Q31 */
+
+/* exact products, one fxp32_arshift style rounding and saturation per component */
+static inline void fxp16_cmul_elem(fxp32_t ar, fxp32_t ai, fxp32_t br, fxp32_t bi, uint8_t frac,
+                                   fxp16_t *yr, fxp16_t *yi)
+{
+    int64_t re = (int64_t)ar * br - (int64_t)ai * bi;
+    int64_t im = (int64_t)ar * bi + (int64_t)ai * br;
+
+    fpxx_arshift_m(re, frac);
+    fpxx_arshift_m(im, frac);
+    fxp16_sat_m(re);
+    fxp16_sat_m(im);
+
+    *yr = (fxp16_t)re;
+    *yi = (fxp16_t)im;
+}
+
+/* branch free CORDIC vectoring, the vector lanes run the identical sequence */
+static inline fxp16_t fxp16_cmag_elem(fxp32_t re, fxp32_t im)
+{
+    fxp32_t x = re * (1 << FXP16_CMAG_GUARD_BITS);
+    fxp32_t y = im * (1 << FXP16_CMAG_GUARD_BITS);
+    fxp32_t m = x >> 31;
+
+    /* mirror into the right half plane */
+    x = (x ^ m) - m;
+    y = (y ^ m) - m;
+
+    for (int i = 0; i < FXP16_CMAG_ITERATIONS; i++)
+    {
+        fxp32_t xs = x >> i;
+        fxp32_t ys = y >> i;
+
+        m = y >> 31;            /* rotate towards y = 0 */
+        x += (ys ^ m) - m;
+        y -= (xs ^ m) - m;
+    }
+
+    uint64_t mag = ((uint64_t)(uint32_t)x * FXP16_CMAG_K_Q31 + (1ULL << (30 + FXP16_CMAG_GUARD_BITS)))
+                   >> (31 + FXP16_CMAG_GUARD_BITS);
+
+    if (mag > INT16_MAX)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_OVERFLOW);
+        return INT16_MAX;
+    }
+
+    return (fxp16_t)mag;
+}
+
+void fxp16_cmul_vec_scalar(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac);
+void fxp16_cmac_scalar(int64_t *re, int64_t *im, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n);
+void fxp16_cmag_vec_scalar(const fxp16_complex_t *z, fxp16_t *mag, size_t n);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_cmul_vec_avx2(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac);
+void fxp16_cmac_avx2(int64_t *re, int64_t *im, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n);
+void fxp16_cmag_vec_avx2(const fxp16_complex_t *z, fxp16_t *mag, size_t n);
+#endif
+
+
+/* ---- block floating point ---------------------------------------------- */
+
+/* OR over x ^ (x >> 15): its bit length is the largest significant bit count of x */
+uint16_t fxp16_signmag_or_scalar(const fxp16_t *x, size_t n);
+
+#if FXP16_KERNELS_AVX2
+uint16_t fxp16_signmag_or_avx2(const fxp16_t *x, size_t n);
+#endif
+
+
+/* ---- full-domain lookup tables ----------------------------------------- */
+
+/* y[i] = lut[(uint16_t)x[i]]; the AVX2 variant loads 32 bits per entry and relies on the pad entry */
+void fxp16_lut_gather_scalar(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_lut_gather_avx2(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n);
+#endif
+
+
+/* ---- tanh / sigmoid ----------------------------------------------------- */
+
+void fxp16_tanh_vec_scalar(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+void fxp16_sigmoid_vec_scalar(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_tanh_vec_avx2(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+void fxp16_sigmoid_vec_avx2(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+#endif
+
+
+/* ---- goertzel ----------------------------------------------------------- */
+
+/*
+    n steps of s0 = x + round(coef * s1 / 2^14) - s2 on each of lanes independent filters,
+    x[i * stride + lane]. Half up rounding, 32 bit wraparound.
+*/
+void fxp16_goertzel_block_scalar(fxp32_t *s1, fxp32_t *s2, fxp32_t coef, const fxp16_t *x, size_t n, size_t lanes, size_t stride);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_goertzel_block_avx2(fxp32_t *s1, fxp32_t *s2, fxp32_t coef, const fxp16_t *x, size_t n, size_t lanes, size_t stride);
+#endif
+
+
+/* ---- moments ------------------------------------------------------------ */
+
+/* sum of x and of x^2 over n <= 2^34 samples; min/max are updated in place */
+void fxp16_sumsq_scalar(const fxp16_t *x, size_t n, int64_t *sum, uint64_t *sumsq);
+void fxp16_minmax_scalar(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_sumsq_avx2(const fxp16_t *x, size_t n, int64_t *sum, uint64_t *sumsq);
+void fxp16_minmax_avx2(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max);
+#endif
+
+
+/* ---- interleave --------------------------------------------------------- */
+
+/* planes[c][f] <-> x[f * channels + c]; the AVX2 versions vectorize 2 and 4 channels */
+void fxp16_deinterleave_scalar(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames);
+void fxp16_interleave_scalar(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames);
+
+#if FXP16_KERNELS_AVX2
+void fxp16_deinterleave_avx2(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames);
+void fxp16_interleave_avx2(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames);
+#endif
+
+
+/* ---- runtime dispatch --------------------------------------------------- */
+
+/* One implementation of every batched kernel, selected as a whole */
+typedef struct {
+    fxp16_isa_t isa;
+    void     (*flt2fp_vec)(const float *x, fxp16_t *y, size_t n, uint8_t frac);
+    void     (*fp2flt_vec)(const fxp16_t *x, float *y, size_t n, uint8_t frac);
+    void     (*dbl2fp_vec)(const double *x, fxp16_t *y, size_t n, uint8_t frac);
+    void     (*fp2dbl_vec)(const fxp16_t *x, double *y, size_t n, uint8_t frac);
+    void     (*rshift_vec)(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+    void     (*lshift_sat_vec)(const fxp16_t *in, fxp16_t *out, size_t n, uint8_t shift);
+    void     (*narrow_vec)(const fxp32_t *in, fxp16_t *out, size_t n, int shift);
+    void     (*gemm_kernel)(size_t kc, const fxp16_t *const a[FXP16_GEMM_MR], const fxp16_t *bp, fxp32_t *acc, size_t ldacc);
+    fxp32_t  (*dot32)(const fxp16_t *a, const fxp16_t *b, size_t n);
+    void     (*cmul_vec)(const fxp16_complex_t *a, const fxp16_complex_t *b, fxp16_complex_t *y, size_t n, uint8_t frac);
+    void     (*cmac)(int64_t *re, int64_t *im, const fxp16_complex_t *a, const fxp16_complex_t *b, size_t n);
+    void     (*cmag_vec)(const fxp16_complex_t *z, fxp16_t *mag, size_t n);
+    uint16_t (*signmag_or)(const fxp16_t *x, size_t n);
+    void     (*lut_gather)(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n);
+    void     (*tanh_vec)(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+    void     (*sigmoid_vec)(uint8_t y_frac, const fxp16_t *x, uint8_t x_frac, fxp16_t *y, size_t n);
+    void     (*round_vec)(const fxp16_t *x, fxp16_t *y, size_t n, uint8_t frac, fxp16_round_mode_t mode, uint8_t shift);
+    void     (*goertzel_block)(fxp32_t *s1, fxp32_t *s2, fxp32_t coef, const fxp16_t *x, size_t n, size_t lanes, size_t stride);
+    void     (*sumsq)(const fxp16_t *x, size_t n, int64_t *sum, uint64_t *sumsq);
+    void     (*minmax)(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max);
+    void     (*deinterleave)(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames);
+    void     (*interleave)(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames);
+} fxp16_kernel_table_t;
+
+extern _Atomic(const fxp16_kernel_table_t *) fxp16_kernels_active;
+
+const fxp16_kernel_table_t *fxp16_kernels_resolve(void);
+
+/*
+    Kernel table of the batched entry points, resolved on first use. The tables are
+    constant, so a relaxed load is enough even if several threads resolve at once.
+*/
+static inline const fxp16_kernel_table_t *fxp16_kernels(void)
+{
+    const fxp16_kernel_table_t *k = atomic_load_explicit(&fxp16_kernels_active, memory_order_relaxed);
+    return k ? k : fxp16_kernels_resolve();
+}
+
+#endif /* _FXP16_KERNELS_H_ */
@@ -0,0 +1,130 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_lut.c
+
+    \brief  Exact full-domain lookup tables for unary fxp16 functions
+*/
+
+#include "fxp16_lut.h"
+#include "fxp16_kernels.h"
+
+
+#define FXP16_LUT_WRITE_PER_LINE    16
+
+
+void fxp16_lut_build(fxp16_t lut[FXP16_LUT_ENTRIES], fxp16_lut_fn_t fn, const fxp16_lut_q_t *q)
+{
+    fxp16_stats_call_m(lut_build);
+#if FXP16CONF_STATUS_FLAGS
+    uint8_t flags = fxp16_status_get();
+#endif
+
+    for (int32_t x = INT16_MIN; x <= INT16_MAX; x++)
+    {
+        lut[(uint16_t)x] = fn((fxp16_t)x, q);
+    }
+
+    lut[FXP16_LUT_SIZE] = 0;
+
+#if FXP16CONF_STATUS_FLAGS
+    fxp16_status_flags = flags;
+#endif
+}
+
+
+size_t fxp16_lut_bytes(void)
+{
+    return FXP16_ARENA_SIZE(FXP16_LUT_ENTRIES * sizeof(fxp16_t));
+}
+
+
+fxp16_t *fxp16_lut_build_arena(fxp16_arena_t *a, fxp16_lut_fn_t fn, const fxp16_lut_q_t *q)
+{
+    fxp16_t *lut = fxp16_arena_alloc(a, FXP16_LUT_ENTRIES * sizeof(fxp16_t));
+
+    if (lut != NULL)
+    {
+        fxp16_lut_build(lut, fn, q);
+    }
+
+    return lut;
+}
+
+
+void fxp16_lut_gather_scalar(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        y[i] = lut[(uint16_t)x[i]];
+    }
+}
+
+
+void fxp16_lut_gather(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    fxp16_stats_call_m(lut_gather);
+    fxp16_kernels()->lut_gather(lut, x, y, n);
+}
+
+
+int fxp16_lut_write_c(FILE *f, const char *name, const fxp16_t lut[FXP16_LUT_ENTRIES])
+{
+    if (fprintf(f, "const fxp16_t %s[FXP16_LUT_ENTRIES] = {\n", name) < 0)
+        return -1;
+
+    for (size_t i = 0; i < FXP16_LUT_ENTRIES; i++)
+    {
+        const char *sep = (i + 1 == FXP16_LUT_ENTRIES) ? "\n"
+                        : ((i + 1) % FXP16_LUT_WRITE_PER_LINE == 0) ? ",\n" : ",";
+
+        if (fprintf(f, "%s%d%s", (i % FXP16_LUT_WRITE_PER_LINE == 0) ? "    " : "", lut[i], sep) < 0)
+            return -1;
+    }
+
+    if (fprintf(f, "};\n") < 0)
+        return -1;
+
+    return 0;
+}
+
+
+/* ---- adapters ---------------------------------------------------------- */
+
+fxp16_t fxp16_lut_sin(fxp16_t x, const fxp16_lut_q_t *q)  { (void)q; return fxp16_sin(x); }
+fxp16_t fxp16_lut_cos(fxp16_t x, const fxp16_lut_q_t *q)  { (void)q; return fxp16_cos(x); }
+fxp16_t fxp16_lut_tan(fxp16_t x, const fxp16_lut_q_t *q)  { return fxp16_tan(x, q->y_frac); }
+fxp16_t fxp16_lut_asin(fxp16_t x, const fxp16_lut_q_t *q) { (void)q; return fxp16_asin(x); }
+fxp16_t fxp16_lut_acos(fxp16_t x, const fxp16_lut_q_t *q) { (void)q; return fxp16_acos(x); }
+fxp16_t fxp16_lut_atan(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_atan(x, q->x_frac); }
+fxp16_t fxp16_lut_sqrt(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_sqrt(x, q->x_frac); }
+fxp16_t fxp16_lut_cbrt(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_cbrt(x, q->x_frac); }
+fxp16_t fxp16_lut_sinh(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_sinh(q->y_frac, x, q->x_frac); }
+fxp16_t fxp16_lut_cosh(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_cosh(q->y_frac, x, q->x_frac); }
+fxp16_t fxp16_lut_tanh(fxp16_t x, const fxp16_lut_q_t *q) { return fxp16_tanh(q->y_frac, x, q->x_frac); }
@@ -0,0 +1,136 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_lut.h
+
+    \brief  Exact full-domain lookup tables for unary fxp16 functions
+
+    \details A unary fxp16 function has only 65536 inputs per Q format, so a table
+             of all results (128 KiB) replaces the computation by one load. Tables
+             are built from the computing path and therefore bit-identical to it.
+             They can be built at init into caller storage, or once by a host
+             program that writes them as C source with fxp16_lut_write_c().
+*/
+
+#ifndef _FXP16_LUT_H_
+#define _FXP16_LUT_H_
+
+#include "fxp16.h"
+#include "fxp16_arena.h"
+#include <stdio.h>
+
+
+#define FXP16_LUT_SIZE      65536                   /* one entry per fxp16 input */
+#define FXP16_LUT_ENTRIES   (FXP16_LUT_SIZE + 1)    /* + 1 pad entry for the 32 bit vector gather */
+
+
+/*! \brief Q formats passed to the tabulated function */
+typedef struct {
+    uint8_t x_frac;     /*!< fractional bits of the input */
+    uint8_t y_frac;     /*!< fractional bits of the result */
+} fxp16_lut_q_t;
+
+/*!
+    \brief      Unary function to tabulate
+    \details    Must be deterministic; functions that ignore a format ignore the
+                corresponding field of q.
+*/
+typedef fxp16_t (*fxp16_lut_fn_t)(fxp16_t x, const fxp16_lut_q_t *q);
+
+
+/*!
+    \brief      Builds the table of a unary function
+    \details    Evaluates fn for all 65536 inputs, lut[(uint16_t)x] = fn(x, q).
+                Status flags raised while building are discarded.
+    \param[out] lut     Table of FXP16_LUT_ENTRIES elements
+    \param[in]  fn      Function to tabulate
+    \param[in]  q       Q formats passed to fn, may be NULL if fn ignores them
+*/
+void fxp16_lut_build(fxp16_t lut[FXP16_LUT_ENTRIES], fxp16_lut_fn_t fn, const fxp16_lut_q_t *q);
+
+/*! \brief Arena bytes fxp16_lut_build_arena() takes */
+size_t fxp16_lut_bytes(void);
+
+/*!
+    \brief      fxp16_lut_build() into a table taken from an arena
+    \returns    The table, NULL if the arena is too small
+*/
+fxp16_t *fxp16_lut_build_arena(fxp16_arena_t *a, fxp16_lut_fn_t fn, const fxp16_lut_q_t *q);
+
+/*!
+    \brief      Table lookup of a single value
+    \param[in]  lut     Table built by fxp16_lut_build()
+    \param[in]  x       Input
+    \returns    fn(x, q) of the tabulated function
+*/
+static inline fxp16_t fxp16_lut_lookup(const fxp16_t *lut, fxp16_t x)
+{
+    return lut[(uint16_t)x];
+}
+
+/*!
+    \brief      Table lookup of an array
+    \details    y[i] = lut[(uint16_t)x[i]]. In-place operation (x == y) is allowed.
+    \param[in]  lut     Table built by fxp16_lut_build()
+    \param[in]  x       Inputs
+    \param[out] y       Results
+    \param[in]  n       Number of elements
+*/
+void fxp16_lut_gather(const fxp16_t *lut, const fxp16_t *x, fxp16_t *y, size_t n);
+
+/*!
+    \brief      Writes a table as C source
+    \details    Emits "const fxp16_t <name>[FXP16_LUT_ENTRIES] = { ... };" for
+                inclusion in a build that should not pay the build time at init.
+    \param[in]  f       Output stream
+    \param[in]  name    Identifier of the array
+    \param[in]  lut     Table built by fxp16_lut_build()
+    \returns    0 on success, -1 on a write error
+*/
+int fxp16_lut_write_c(FILE *f, const char *name, const fxp16_t lut[FXP16_LUT_ENTRIES]);
+
+
+/*
+    Adapters of the library functions to fxp16_lut_fn_t. Field use:
+    sin, cos, asin, acos: none; tan: y_frac; atan: x_frac; sqrt, cbrt: x_frac
+    (result in the same format); sinh, cosh, tanh: x_frac and y_frac.
+*/
+fxp16_t fxp16_lut_sin(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_cos(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_tan(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_asin(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_acos(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_atan(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_sqrt(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_cbrt(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_sinh(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_cosh(fxp16_t x, const fxp16_lut_q_t *q);
+fxp16_t fxp16_lut_tanh(fxp16_t x, const fxp16_lut_q_t *q);
+
+#endif /* _FXP16_LUT_H_ */
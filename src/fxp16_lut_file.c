@@ -0,0 +1,266 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_lut_file.c
+
+    \brief  Versioned on-disk cache of full-domain lookup tables
+*/
+
+#if !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE     200809L     /* mkstemp */
+#endif
+
+#include "fxp16_lut_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#define FXP16_LUT_FILE_SIZE     (sizeof(fxp16_lut_file_header_t) + FXP16_LUT_ENTRIES * sizeof(fxp16_t))
+
+#define FXP16_FNV32_OFFSET      2166136261u
+#define FXP16_FNV32_PRIME       16777619u
+
+
+typedef char fxp16_lut_file_header_size_check[(sizeof(fxp16_lut_file_header_t) == 64) ? 1 : -1];
+
+
+/* FNV-1a over the entries, one 16 bit entry per step */
+static uint32_t fxp16_lut_checksum(const fxp16_t *lut)
+{
+    uint32_t h = FXP16_FNV32_OFFSET;
+
+    for (size_t i = 0; i < FXP16_LUT_ENTRIES; i++)
+    {
+        h = (h ^ (uint16_t)lut[i]) * FXP16_FNV32_PRIME;
+    }
+
+    return h;
+}
+
+
+static void fxp16_lut_file_header(fxp16_lut_file_header_t *h, uint32_t fn_id, const fxp16_lut_q_t *q)
+{
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, FXP16_LUT_FILE_MAGIC, sizeof(h->magic));
+    h->bom     = FXP16_LUT_FILE_BOM;
+    h->format  = FXP16_LUT_FILE_FORMAT;
+    h->version = FXP16_LUT_FILE_VERSION;
+    h->fn_id   = fn_id;
+    h->x_frac  = q ? q->x_frac : 0;
+    h->y_frac  = q ? q->y_frac : 0;
+    h->entries = FXP16_LUT_ENTRIES;
+}
+
+
+/* write all of buf, retrying short writes and EINTR */
+static int fxp16_write_all(int fd, const void *buf, size_t size)
+{
+    const char *p = buf;
+
+    while (size)
+    {
+        ssize_t w = write(fd, p, size);
+
+        if (w < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        p += w;
+        size -= (size_t)w;
+    }
+
+    return 0;
+}
+
+
+fxp16_lut_fn_t fxp16_lut_fn_by_id(uint32_t fn_id)
+{
+    switch (fn_id)
+    {
+        case FXP16_LUT_ID_SIN:  return fxp16_lut_sin;
+        case FXP16_LUT_ID_COS:  return fxp16_lut_cos;
+        case FXP16_LUT_ID_TAN:  return fxp16_lut_tan;
+        case FXP16_LUT_ID_ASIN: return fxp16_lut_asin;
+        case FXP16_LUT_ID_ACOS: return fxp16_lut_acos;
+        case FXP16_LUT_ID_ATAN: return fxp16_lut_atan;
+        case FXP16_LUT_ID_SQRT: return fxp16_lut_sqrt;
+        case FXP16_LUT_ID_CBRT: return fxp16_lut_cbrt;
+        case FXP16_LUT_ID_SINH: return fxp16_lut_sinh;
+        case FXP16_LUT_ID_COSH: return fxp16_lut_cosh;
+        case FXP16_LUT_ID_TANH: return fxp16_lut_tanh;
+        default:                return NULL;
+    }
+}
+
+
+int fxp16_lut_file_write(const char *path, uint32_t fn_id, const fxp16_lut_q_t *q,
+                         const fxp16_t lut[FXP16_LUT_ENTRIES])
+{
+    fxp16_lut_file_header_t h;
+    size_t len = strlen(path);
+    char *tmp = malloc(len + 32);
+    int fd, err;
+
+    if (!tmp) return -1;
+
+    fxp16_lut_file_header(&h, fn_id, q);
+    h.checksum = fxp16_lut_checksum(lut);
+
+    /* a unique name per call, so writers in threads of one process do not share it */
+    snprintf(tmp, len + 32, "%s.XXXXXX", path);
+    fd = mkstemp(tmp);
+
+    if (fd < 0)
+    {
+        free(tmp);
+        return -1;
+    }
+
+    /* mkstemp() creates 0600, tables are meant to be shared */
+    if (fchmod(fd, 0644))
+    {
+        int e = errno;
+        close(fd);
+        unlink(tmp);
+        free(tmp);
+        errno = e;
+        return -1;
+    }
+
+    err = fxp16_write_all(fd, &h, sizeof(h))
+       || fxp16_write_all(fd, lut, FXP16_LUT_ENTRIES * sizeof(fxp16_t));
+    err = close(fd) || err;
+    err = err || rename(tmp, path);
+
+    if (err)
+    {
+        int e = errno;
+        unlink(tmp);
+        errno = e;
+    }
+
+    free(tmp);
+    return err ? -1 : 0;
+}
+
+
+int fxp16_lut_file_map(fxp16_lut_map_t *map, const char *path, uint32_t fn_id, const fxp16_lut_q_t *q)
+{
+    fxp16_lut_file_header_t expect;
+    const fxp16_lut_file_header_t *h;
+    struct stat st;
+    void *base;
+    int fd;
+
+    memset(map, 0, sizeof(*map));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    if (fstat(fd, &st) || (size_t)st.st_size != FXP16_LUT_FILE_SIZE)
+    {
+        close(fd);
+        return -1;
+    }
+
+    base = mmap(NULL, FXP16_LUT_FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    h = base;
+    fxp16_lut_file_header(&expect, fn_id, q);
+    expect.checksum = h->checksum;
+
+    if (memcmp(h, &expect, sizeof(expect)) ||
+        fxp16_lut_checksum((const fxp16_t *)(h + 1)) != h->checksum)
+    {
+        munmap(base, FXP16_LUT_FILE_SIZE);
+        return -1;
+    }
+
+    map->lut  = (const fxp16_t *)(h + 1);
+    map->base = base;
+    map->size = FXP16_LUT_FILE_SIZE;
+
+    return 0;
+}
+
+
+int fxp16_lut_file_open(fxp16_lut_map_t *map, const char *path, uint32_t fn_id,
+                        fxp16_lut_fn_t fn, const fxp16_lut_q_t *q)
+{
+    fxp16_t *lut;
+
+    if (fxp16_lut_file_map(map, path, fn_id, q) == 0)
+        return 0;
+
+    if (!fn) fn = fxp16_lut_fn_by_id(fn_id);
+    if (!fn) return -1;
+
+    lut = malloc(FXP16_LUT_ENTRIES * sizeof(fxp16_t));
+    if (!lut) return -1;
+
+    fxp16_lut_build(lut, fn, q);
+
+    if (fxp16_lut_file_write(path, fn_id, q, lut) == 0 &&
+        fxp16_lut_file_map(map, path, fn_id, q) == 0)
+    {
+        free(lut);
+        return 0;
+    }
+
+    map->lut  = lut;
+    map->base = lut;
+    map->size = 0;
+
+    return 0;
+}
+
+
+void fxp16_lut_file_close(fxp16_lut_map_t *map)
+{
+    if (map->size)
+        munmap(map->base, map->size);
+    else
+        free(map->base);
+
+    memset(map, 0, sizeof(*map));
+}
+
+#endif /* POSIX */
@@ -0,0 +1,152 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_lut_file.h
+
+    \brief  Versioned on-disk cache of full-domain lookup tables
+
+    \details A table file holds one fxp16_lut table behind a header that records
+             the function id, both Q formats, the library version and a checksum.
+             Files are written once and mapped read-only afterwards, so processes
+             that use the same tables share their pages and skip the build.
+             Available on POSIX hosts only.
+*/
+
+#ifndef _FXP16_LUT_FILE_H_
+#define _FXP16_LUT_FILE_H_
+
+#include "fxp16_lut.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define FXP16_LUT_FILE_MAGIC        "FXP16LUT"
+#define FXP16_LUT_FILE_FORMAT       1
+#define FXP16_LUT_FILE_BOM          0x01020304u     /* written native, rejects foreign byte order */
+#define FXP16_LUT_FILE_VERSION      ((FXP16_VERSION_MAJOR << 16) | (FXP16_VERSION_MINOR << 8) | FXP16_VERSION_PATCH)
+
+
+/*! \brief Function ids of the library adapters, user functions start at FXP16_LUT_ID_USER */
+typedef enum {
+    FXP16_LUT_ID_SIN = 1,
+    FXP16_LUT_ID_COS,
+    FXP16_LUT_ID_TAN,
+    FXP16_LUT_ID_ASIN,
+    FXP16_LUT_ID_ACOS,
+    FXP16_LUT_ID_ATAN,
+    FXP16_LUT_ID_SQRT,
+    FXP16_LUT_ID_CBRT,
+    FXP16_LUT_ID_SINH,
+    FXP16_LUT_ID_COSH,
+    FXP16_LUT_ID_TANH,
+    FXP16_LUT_ID_USER = 0x8000
+} fxp16_lut_id_t;
+
+/*!
+    \brief      File header, followed by FXP16_LUT_ENTRIES table entries
+    \details    64 bytes, so the mapped table starts cache line aligned.
+*/
+typedef struct {
+    char     magic[8];      /*!< FXP16_LUT_FILE_MAGIC without terminator */
+    uint32_t bom;           /*!< FXP16_LUT_FILE_BOM */
+    uint32_t format;        /*!< FXP16_LUT_FILE_FORMAT */
+    uint32_t version;       /*!< FXP16_LUT_FILE_VERSION of the writer */
+    uint32_t fn_id;         /*!< fxp16_lut_id_t or user id */
+    uint8_t  x_frac;        /*!< input format */
+    uint8_t  y_frac;        /*!< result format */
+    uint16_t reserved;      /*!< 0 */
+    uint32_t entries;       /*!< FXP16_LUT_ENTRIES */
+    uint32_t checksum;      /*!< FNV-1a over the table entries */
+    uint8_t  pad[28];       /*!< 0 */
+} fxp16_lut_file_header_t;
+
+/*! \brief A mapped (or, as fallback, heap allocated) table */
+typedef struct {
+    const fxp16_t *lut;     /*!< table, NULL if not available */
+    void          *base;    /*!< mapping or heap block */
+    size_t         size;    /*!< mapping size, 0 for a heap block */
+} fxp16_lut_map_t;
+
+
+/*!
+    \brief      Adapter of a library function id
+    \param[in]  fn_id   fxp16_lut_id_t
+    \returns    Adapter, NULL for user and unknown ids
+*/
+fxp16_lut_fn_t fxp16_lut_fn_by_id(uint32_t fn_id);
+
+/*!
+    \brief      Writes a table file
+    \details    Writes to a uniquely named temporary file next to path and renames
+                it, so readers never see a partial file and concurrent writers, in
+                threads or processes, are harmless.
+    \param[in]  path    File name
+    \param[in]  fn_id   Function id stored in the header
+    \param[in]  q       Q formats stored in the header
+    \param[in]  lut     Table built by fxp16_lut_build()
+    \returns    0 on success, -1 on an I/O error (errno set)
+*/
+int fxp16_lut_file_write(const char *path, uint32_t fn_id, const fxp16_lut_q_t *q,
+                         const fxp16_t lut[FXP16_LUT_ENTRIES]);
+
+/*!
+    \brief      Maps a table file read-only
+    \details    Fails unless magic, byte order, format, library version, function
+                id, Q formats, size and checksum all match.
+    \param[out] map     Mapping, map->lut is the table
+    \param[in]  path    File name
+    \param[in]  fn_id   Expected function id
+    \param[in]  q       Expected Q formats
+    \returns    0 on success, -1 if the file is missing, stale or corrupt
+*/
+int fxp16_lut_file_map(fxp16_lut_map_t *map, const char *path, uint32_t fn_id, const fxp16_lut_q_t *q);
+
+/*!
+    \brief      Maps a table file, creating it first if needed
+    \details    If the file cannot be mapped, the table is built with fn, written
+                and mapped again. If the file cannot be written (e.g. read-only
+                directory) the built table is kept on the heap instead.
+    \param[out] map     Mapping, map->lut is the table
+    \param[in]  path    File name
+    \param[in]  fn_id   Function id
+    \param[in]  fn      Function to tabulate, NULL to use fxp16_lut_fn_by_id(fn_id)
+    \param[in]  q       Q formats
+    \returns    0 on success, -1 if no table could be provided
+*/
+int fxp16_lut_file_open(fxp16_lut_map_t *map, const char *path, uint32_t fn_id,
+                        fxp16_lut_fn_t fn, const fxp16_lut_q_t *q);
+
+/*!
+    \brief      Releases a table of fxp16_lut_file_map() or fxp16_lut_file_open()
+    \param[in,out] map  Mapping, reset to empty
+*/
+void fxp16_lut_file_close(fxp16_lut_map_t *map);
+
+#endif /* POSIX */
+
+#endif /* _FXP16_LUT_FILE_H_ */
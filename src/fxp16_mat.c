@@ -0,0 +1,413 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_mat.c
+
+    \brief  Small fixed-size matrices, quaternions and Euler angles
+*/
+
+#include "fxp16_mat.h"
+
+
+/* sums of three or four full scale products leave int32, accumulate in 64 bit */
+static inline fxp16_t fxp16_mat_round(int64_t acc, uint8_t frac)
+{
+    fpxx_arshift_m(acc, frac);
+    fxp16_sat_m(acc);
+    return (fxp16_t)acc;
+}
+
+
+static void fxp16_mat_identity_n(fxp16_t *a, unsigned n, uint8_t frac)
+{
+    fxp32_t one = (fxp32_t)1 << frac;
+    fxp16_sat_m(one);
+
+    for (unsigned i = 0; i < n * n; i++)
+    {
+        a[i] = (i % (n + 1) == 0) ? (fxp16_t)one : 0;
+    }
+}
+
+
+static void fxp16_mat_mul_n(const fxp16_t *a, const fxp16_t *b, fxp16_t *c, unsigned n, uint8_t frac)
+{
+    fxp16_t t[4 * 4];
+
+    fxp16_stats_call_m(mat_mul);
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        for (unsigned j = 0; j < n; j++)
+        {
+            int64_t acc = 0;
+
+            for (unsigned k = 0; k < n; k++)
+            {
+                acc += (fxp32_t)a[i * n + k] * b[k * n + j];
+            }
+
+            t[i * n + j] = fxp16_mat_round(acc, frac);
+        }
+    }
+
+    for (unsigned i = 0; i < n * n; i++)
+    {
+        c[i] = t[i];
+    }
+}
+
+
+static void fxp16_mat_transpose_n(const fxp16_t *a, fxp16_t *t, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+    {
+        t[i * n + i] = a[i * n + i];
+
+        for (unsigned j = i + 1; j < n; j++)
+        {
+            fxp16_t upper = a[i * n + j];
+            t[i * n + j] = a[j * n + i];
+            t[j * n + i] = upper;
+        }
+    }
+}
+
+
+static void fxp16_mat_mulv_n(const fxp16_t *a, const fxp16_t *v, fxp16_t *y, unsigned n, uint8_t frac)
+{
+    fxp16_t t[4];
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        int64_t acc = 0;
+
+        for (unsigned k = 0; k < n; k++)
+        {
+            acc += (fxp32_t)a[i * n + k] * v[k];
+        }
+
+        t[i] = fxp16_mat_round(acc, frac);
+    }
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        y[i] = t[i];
+    }
+}
+
+
+void fxp16_mat2_identity(fxp16_mat2_t *a, uint8_t frac)
+{
+    fxp16_mat_identity_n((fxp16_t *)a, 2, frac);
+}
+
+void fxp16_mat3_identity(fxp16_mat3_t *a, uint8_t frac)
+{
+    fxp16_mat_identity_n((fxp16_t *)a, 3, frac);
+}
+
+void fxp16_mat4_identity(fxp16_mat4_t *a, uint8_t frac)
+{
+    fxp16_mat_identity_n((fxp16_t *)a, 4, frac);
+}
+
+
+void fxp16_mat2_mul(const fxp16_mat2_t *a, const fxp16_mat2_t *b, fxp16_mat2_t *c, uint8_t frac)
+{
+    fxp16_mat_mul_n((const fxp16_t *)a, (const fxp16_t *)b, (fxp16_t *)c, 2, frac);
+}
+
+void fxp16_mat3_mul(const fxp16_mat3_t *a, const fxp16_mat3_t *b, fxp16_mat3_t *c, uint8_t frac)
+{
+    fxp16_mat_mul_n((const fxp16_t *)a, (const fxp16_t *)b, (fxp16_t *)c, 3, frac);
+}
+
+void fxp16_mat4_mul(const fxp16_mat4_t *a, const fxp16_mat4_t *b, fxp16_mat4_t *c, uint8_t frac)
+{
+    fxp16_mat_mul_n((const fxp16_t *)a, (const fxp16_t *)b, (fxp16_t *)c, 4, frac);
+}
+
+
+void fxp16_mat2_transpose(const fxp16_mat2_t *a, fxp16_mat2_t *t)
+{
+    fxp16_mat_transpose_n((const fxp16_t *)a, (fxp16_t *)t, 2);
+}
+
+void fxp16_mat3_transpose(const fxp16_mat3_t *a, fxp16_mat3_t *t)
+{
+    fxp16_mat_transpose_n((const fxp16_t *)a, (fxp16_t *)t, 3);
+}
+
+void fxp16_mat4_transpose(const fxp16_mat4_t *a, fxp16_mat4_t *t)
+{
+    fxp16_mat_transpose_n((const fxp16_t *)a, (fxp16_t *)t, 4);
+}
+
+
+void fxp16_mat2_mulv(const fxp16_mat2_t *a, const fxp16_t v[2], fxp16_t y[2], uint8_t frac)
+{
+    fxp16_mat_mulv_n((const fxp16_t *)a, v, y, 2, frac);
+}
+
+void fxp16_mat3_mulv(const fxp16_mat3_t *a, const fxp16_t v[3], fxp16_t y[3], uint8_t frac)
+{
+    fxp16_mat_mulv_n((const fxp16_t *)a, v, y, 3, frac);
+}
+
+void fxp16_mat4_mulv(const fxp16_mat4_t *a, const fxp16_t v[4], fxp16_t y[4], uint8_t frac)
+{
+    fxp16_mat_mulv_n((const fxp16_t *)a, v, y, 4, frac);
+}
+
+
+void fxp16_mat2_transform_soa(const fxp16_mat2_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y,
+                              fxp16_t *ox, fxp16_t *oy, size_t n)
+{
+    fxp16_stats_call_m(mat_transform);
+
+    const fxp32_t m00 = a->m[0][0], m01 = a->m[0][1];
+    const fxp32_t m10 = a->m[1][0], m11 = a->m[1][1];
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp32_t xi = x[i], yi = y[i];
+
+        ox[i] = fxp16_mat_round((int64_t)m00 * xi + (int64_t)m01 * yi, frac);
+        oy[i] = fxp16_mat_round((int64_t)m10 * xi + (int64_t)m11 * yi, frac);
+    }
+}
+
+
+/* translation t is pre-scaled to the product format, zero for the linear case */
+static void fxp16_mat3_transform_soa_t(const fxp16_t m[3][4], uint8_t frac, const int64_t t[3],
+                                       const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                                       fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n)
+{
+    const fxp32_t m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const fxp32_t m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const fxp32_t m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fxp32_t xi = x[i], yi = y[i], zi = z[i];
+
+        ox[i] = fxp16_mat_round(t[0] + (int64_t)m00 * xi + (int64_t)m01 * yi + (int64_t)m02 * zi, frac);
+        oy[i] = fxp16_mat_round(t[1] + (int64_t)m10 * xi + (int64_t)m11 * yi + (int64_t)m12 * zi, frac);
+        oz[i] = fxp16_mat_round(t[2] + (int64_t)m20 * xi + (int64_t)m21 * yi + (int64_t)m22 * zi, frac);
+    }
+}
+
+
+void fxp16_mat3_transform_soa(const fxp16_mat3_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                              fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n)
+{
+    fxp16_stats_call_m(mat_transform);
+
+    const fxp16_t m[3][4] = {
+        { a->m[0][0], a->m[0][1], a->m[0][2], 0 },
+        { a->m[1][0], a->m[1][1], a->m[1][2], 0 },
+        { a->m[2][0], a->m[2][1], a->m[2][2], 0 },
+    };
+    const int64_t t[3] = { 0, 0, 0 };
+
+    fxp16_mat3_transform_soa_t(m, frac, t, x, y, z, ox, oy, oz, n);
+}
+
+
+void fxp16_mat4_transform_soa(const fxp16_mat4_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                              fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n)
+{
+    fxp16_stats_call_m(mat_transform);
+
+    const int64_t t[3] = {
+        (int64_t)a->m[0][3] * ((int64_t)1 << frac),
+        (int64_t)a->m[1][3] * ((int64_t)1 << frac),
+        (int64_t)a->m[2][3] * ((int64_t)1 << frac),
+    };
+
+    fxp16_mat3_transform_soa_t((const fxp16_t (*)[4])a->m, frac, t, x, y, z, ox, oy, oz, n);
+}
+
+
+fxp16_quat_t fxp16_quat_mul(fxp16_quat_t a, fxp16_quat_t b)
+{
+    fxp16_quat_t q;
+
+    q.w = fxp16_mat_round((int64_t)a.w * b.w - (int64_t)a.x * b.x - (int64_t)a.y * b.y - (int64_t)a.z * b.z, FXP16_QUAT_FRAC);
+    q.x = fxp16_mat_round((int64_t)a.w * b.x + (int64_t)a.x * b.w + (int64_t)a.y * b.z - (int64_t)a.z * b.y, FXP16_QUAT_FRAC);
+    q.y = fxp16_mat_round((int64_t)a.w * b.y - (int64_t)a.x * b.z + (int64_t)a.y * b.w + (int64_t)a.z * b.x, FXP16_QUAT_FRAC);
+    q.z = fxp16_mat_round((int64_t)a.w * b.z + (int64_t)a.x * b.y - (int64_t)a.y * b.x + (int64_t)a.z * b.w, FXP16_QUAT_FRAC);
+
+    return q;
+}
+
+
+fxp16_quat_t fxp16_quat_conj(fxp16_quat_t q)
+{
+    fxp32_t x = -(fxp32_t)q.x;
+    fxp32_t y = -(fxp32_t)q.y;
+    fxp32_t z = -(fxp32_t)q.z;
+
+    fxp16_sat_m(x);
+    fxp16_sat_m(y);
+    fxp16_sat_m(z);
+
+    q.x = (fxp16_t)x;
+    q.y = (fxp16_t)y;
+    q.z = (fxp16_t)z;
+    return q;
+}
+
+
+/* 1/sqrt(u) in Q30 at the interval midpoints u = (i + 4.5) / 16, u in [0.25, 1) */
+static const uint32_t fxp16_quat_rsqrt_seed[12] = {
+    2024667000u, 1831380208u, 1684624773u, 1568300315u,
+    1473161629u, 1393471397u, 1325455684u, 1266516759u,
+    1214800200u, 1168942037u, 1127913670u, 1090922784u,
+};
+
+
+fxp16_quat_t fxp16_quat_normalize(fxp16_quat_t q)
+{
+    fxp16_stats_call_m(quat_normalize);
+
+    uint64_t m = (uint64_t)((fxp32_t)q.w * q.w) + (uint64_t)((fxp32_t)q.x * q.x)
+               + (uint64_t)((fxp32_t)q.y * q.y) + (uint64_t)((fxp32_t)q.z * q.z);
+
+    if (m == 0)
+    {
+        const fxp16_quat_t identity = FXP16_QUAT_IDENTITY;
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return identity;
+    }
+
+    /* m = |q|^2 * 4^k in [2^30, 2^32), so that u = m / 2^32 in [0.25, 1) */
+    int k = 0;
+
+    if (m >> 32)
+    {
+        m >>= 2;    /* only |q|^2 = 2^32 (all components -1.0), exact */
+        k = -1;
+    }
+
+    while (m < ((uint64_t)1 << 30))
+    {
+        m <<= 2;
+        k++;
+    }
+
+    /* Newton-Raphson y' = y (3 - u y^2) / 2, quadratic convergence from a 4 bit seed */
+    int64_t y = fxp16_quat_rsqrt_seed[(m >> 28) - 4];
+
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t t = (int64_t)(((uint64_t)(y * y) >> 30) * m >> 32);
+        y = (y * (((int64_t)3 << 30) - t)) >> 31;
+    }
+
+    /* 1/|q| = 2^k / sqrt(m) = y * 2^(k - 46), Q14 result */
+    uint8_t shift = (uint8_t)(46 - FXP16_QUAT_FRAC - k);
+
+    q.w = fxp16_mat_round((int64_t)q.w * y, shift);
+    q.x = fxp16_mat_round((int64_t)q.x * y, shift);
+    q.y = fxp16_mat_round((int64_t)q.y * y, shift);
+    q.z = fxp16_mat_round((int64_t)q.z * y, shift);
+    return q;
+}
+
+
+void fxp16_quat_to_mat3(fxp16_quat_t q, fxp16_mat3_t *r)
+{
+    /* products in Q28, 2 * p in Q14 is p >> 13 */
+    const int64_t one = (int64_t)1 << (2 * FXP16_QUAT_FRAC);
+    const int64_t xx = (fxp32_t)q.x * q.x;
+    const int64_t yy = (fxp32_t)q.y * q.y, zz = (fxp32_t)q.z * q.z;
+    const int64_t xy = (fxp32_t)q.x * q.y, xz = (fxp32_t)q.x * q.z, yz = (fxp32_t)q.y * q.z;
+    const int64_t wx = (fxp32_t)q.w * q.x, wy = (fxp32_t)q.w * q.y, wz = (fxp32_t)q.w * q.z;
+
+    r->m[0][0] = fxp16_mat_round(one - 2 * (yy + zz), FXP16_QUAT_FRAC);
+    r->m[0][1] = fxp16_mat_round(xy - wz, FXP16_QUAT_FRAC - 1);
+    r->m[0][2] = fxp16_mat_round(xz + wy, FXP16_QUAT_FRAC - 1);
+
+    r->m[1][0] = fxp16_mat_round(xy + wz, FXP16_QUAT_FRAC - 1);
+    r->m[1][1] = fxp16_mat_round(one - 2 * (xx + zz), FXP16_QUAT_FRAC);
+    r->m[1][2] = fxp16_mat_round(yz - wx, FXP16_QUAT_FRAC - 1);
+
+    r->m[2][0] = fxp16_mat_round(xz - wy, FXP16_QUAT_FRAC - 1);
+    r->m[2][1] = fxp16_mat_round(yz + wx, FXP16_QUAT_FRAC - 1);
+    r->m[2][2] = fxp16_mat_round(one - 2 * (xx + yy), FXP16_QUAT_FRAC);
+}
+
+
+void fxp16_quat_rotate_soa(fxp16_quat_t q, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                           fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n)
+{
+    fxp16_mat3_t r;
+
+    fxp16_quat_to_mat3(q, &r);
+    fxp16_mat3_transform_soa(&r, FXP16_QUAT_FRAC, x, y, z, ox, oy, oz, n);
+}
+
+
+fxp16_euler_t fxp16_quat_to_euler(fxp16_quat_t q)
+{
+    fxp16_stats_call_m(quat_euler);
+
+    const int64_t one = (int64_t)1 << (2 * FXP16_QUAT_FRAC);
+    const int64_t xx = (fxp32_t)q.x * q.x, yy = (fxp32_t)q.y * q.y, zz = (fxp32_t)q.z * q.z;
+    fxp16_euler_t e;
+
+    /* atan2 arguments in Q14, the sine of pitch in Q15 */
+    e.roll  = fxp16_atan2(fxp16_mat_round((int64_t)q.w * q.x + (int64_t)q.y * q.z, FXP16_QUAT_FRAC - 1),
+                          fxp16_mat_round(one - 2 * (xx + yy), FXP16_QUAT_FRAC));
+    e.pitch = fxp16_asin (fxp16_mat_round((int64_t)q.w * q.y - (int64_t)q.z * q.x, FXP16_QUAT_FRAC - 2));
+    e.yaw   = fxp16_atan2(fxp16_mat_round((int64_t)q.w * q.z + (int64_t)q.x * q.y, FXP16_QUAT_FRAC - 1),
+                          fxp16_mat_round(one - 2 * (yy + zz), FXP16_QUAT_FRAC));
+    return e;
+}
+
+
+fxp16_quat_t fxp16_euler_to_quat(fxp16_euler_t e)
+{
+    fxp16_stats_call_m(quat_euler);
+
+    /* half angles, Q15 sines and cosines, Q45 triple products */
+    const fxp32_t cr = fxp16_cos(e.roll  >> 1), sr = fxp16_sin(e.roll  >> 1);
+    const fxp32_t cp = fxp16_cos(e.pitch >> 1), sp = fxp16_sin(e.pitch >> 1);
+    const fxp32_t cy = fxp16_cos(e.yaw   >> 1), sy = fxp16_sin(e.yaw   >> 1);
+    const uint8_t shift = 3 * FXP16_Q15 - FXP16_QUAT_FRAC;
+    fxp16_quat_t q;
+
+    q.w = fxp16_mat_round((int64_t)(cr * cp) * cy + (int64_t)(sr * sp) * sy, shift);
+    q.x = fxp16_mat_round((int64_t)(sr * cp) * cy - (int64_t)(cr * sp) * sy, shift);
+    q.y = fxp16_mat_round((int64_t)(cr * sp) * cy + (int64_t)(sr * cp) * sy, shift);
+    q.z = fxp16_mat_round((int64_t)(cr * cp) * sy - (int64_t)(sr * sp) * cy, shift);
+    return q;
+}
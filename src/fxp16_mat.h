@@ -0,0 +1,211 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_mat.h
+
+    \brief  Small fixed-size matrices, quaternions and Euler angles
+
+    \details 2x2, 3x3 and 4x4 row-major matrices for rotations and transforms, and
+             unit quaternions for attitude estimation. Every output element is the
+             exact sum of its products, rounded like fxp32_arshift and saturated once,
+             instead of a chain of fxp16_mult and fxp16_add calls that rounds and
+             saturates per product.
+
+             Matrices carry a caller-supplied Q format, Q14 holds rotations exactly
+             including 1.0. Quaternions are fixed to Q14 (FXP16_QUAT_FRAC). Angles are
+             π-normalized Q15 like everywhere else in the library (see \ref fxp16_trig).
+
+             Point arrays are transformed in deinterleaved (SoA) form: one array per
+             coordinate, which is what the batched loops vectorize best.
+*/
+
+#ifndef _FXP16_MAT_H_
+#define _FXP16_MAT_H_
+
+#include "fxp16.h"
+
+
+/*! \brief Fractional bits of fxp16_quat_t components */
+#define FXP16_QUAT_FRAC     FXP16_Q14
+
+
+/*! \brief 2x2 matrix, m[row][column] */
+typedef struct {
+    fxp16_t m[2][2];
+} fxp16_mat2_t;
+
+/*! \brief 3x3 matrix, m[row][column] */
+typedef struct {
+    fxp16_t m[3][3];
+} fxp16_mat3_t;
+
+/*!
+    \brief      4x4 matrix, m[row][column]
+    \details    As an affine transform the bottom row is {0, 0, 0, 1.0} and the
+                translation column m[0..2][3] is in the format of the points, so that
+                products of transforms compose their translations correctly.
+*/
+typedef struct {
+    fxp16_t m[4][4];
+} fxp16_mat4_t;
+
+/*! \brief Quaternion w + xi + yj + zk in Q14, unit length for rotations */
+typedef struct {
+    fxp16_t w;
+    fxp16_t x;
+    fxp16_t y;
+    fxp16_t z;
+} fxp16_quat_t;
+
+/*!
+    \brief      Euler angles, π-normalized Q15
+    \details    Aerospace sequence: yaw about z, then pitch about the new y, then roll
+                about the new x. pitch is limited to [-π/2, +π/2].
+*/
+typedef struct {
+    fxp16_t roll;
+    fxp16_t pitch;
+    fxp16_t yaw;
+} fxp16_euler_t;
+
+/*! \brief Identity rotation */
+#define FXP16_QUAT_IDENTITY     { 1 << FXP16_QUAT_FRAC, 0, 0, 0 }
+
+
+/*!
+    \brief      Identity matrix
+    \param[out] a       Matrix
+    \param[in]  frac    Fractional bits of the matrix (0..14)
+*/
+void fxp16_mat2_identity(fxp16_mat2_t *a, uint8_t frac);
+void fxp16_mat3_identity(fxp16_mat3_t *a, uint8_t frac);   /*!< \brief 3x3 form of fxp16_mat2_identity() */
+void fxp16_mat4_identity(fxp16_mat4_t *a, uint8_t frac);   /*!< \brief 4x4 form of fxp16_mat2_identity() */
+
+/*!
+    \brief      Matrix product c = a * b
+    \details    c has the format of \p a. c may alias a or b.
+    \param[in]  a       Left factor
+    \param[in]  b       Right factor
+    \param[out] c       Product
+    \param[in]  frac    Fractional bits of \p b
+*/
+void fxp16_mat2_mul(const fxp16_mat2_t *a, const fxp16_mat2_t *b, fxp16_mat2_t *c, uint8_t frac);
+void fxp16_mat3_mul(const fxp16_mat3_t *a, const fxp16_mat3_t *b, fxp16_mat3_t *c, uint8_t frac);   /*!< \brief 3x3 form of fxp16_mat2_mul() */
+void fxp16_mat4_mul(const fxp16_mat4_t *a, const fxp16_mat4_t *b, fxp16_mat4_t *c, uint8_t frac);   /*!< \brief 4x4 form of fxp16_mat2_mul() */
+
+/*!
+    \brief      Transposed matrix, the inverse of a rotation
+    \details    t may alias a.
+*/
+void fxp16_mat2_transpose(const fxp16_mat2_t *a, fxp16_mat2_t *t);
+void fxp16_mat3_transpose(const fxp16_mat3_t *a, fxp16_mat3_t *t);  /*!< \brief 3x3 form of fxp16_mat2_transpose() */
+void fxp16_mat4_transpose(const fxp16_mat4_t *a, fxp16_mat4_t *t);  /*!< \brief 4x4 form of fxp16_mat2_transpose() */
+
+/*!
+    \brief      Matrix-vector product y = a * v
+    \details    y has the format of \p v. y may alias v.
+    \param[in]  a       Matrix
+    \param[in]  v       Vector
+    \param[out] y       Product
+    \param[in]  frac    Fractional bits of \p a
+*/
+void fxp16_mat2_mulv(const fxp16_mat2_t *a, const fxp16_t v[2], fxp16_t y[2], uint8_t frac);
+void fxp16_mat3_mulv(const fxp16_mat3_t *a, const fxp16_t v[3], fxp16_t y[3], uint8_t frac);   /*!< \brief 3x3 form of fxp16_mat2_mulv() */
+void fxp16_mat4_mulv(const fxp16_mat4_t *a, const fxp16_t v[4], fxp16_t y[4], uint8_t frac);   /*!< \brief 4x4 form of fxp16_mat2_mulv() */
+
+/*!
+    \brief      Transforms an array of 2D points
+    \details    (ox[i], oy[i]) = a * (x[i], y[i]), in the format of the points.
+                In-place operation (ox == x, oy == y) is allowed.
+    \param[in]  a       Matrix
+    \param[in]  frac    Fractional bits of \p a
+    \param[in]  x,y     Point coordinates
+    \param[out] ox,oy   Transformed coordinates
+    \param[in]  n       Number of points
+*/
+void fxp16_mat2_transform_soa(const fxp16_mat2_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y,
+                              fxp16_t *ox, fxp16_t *oy, size_t n);
+/*! \brief 3D form of fxp16_mat2_transform_soa() */
+void fxp16_mat3_transform_soa(const fxp16_mat3_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                              fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n);
+/*!
+    \brief      Affine transform of an array of 3D points
+    \details    Like fxp16_mat3_transform_soa() with the upper left 3x3 block, plus the
+                translation column m[0..2][3] (point format). The bottom row is ignored.
+*/
+void fxp16_mat4_transform_soa(const fxp16_mat4_t *a, uint8_t frac, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                              fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n);
+
+
+/*!
+    \brief      Hamilton product a * b, the rotation b followed by a
+*/
+fxp16_quat_t fxp16_quat_mul(fxp16_quat_t a, fxp16_quat_t b);
+
+/*!
+    \brief      Conjugate, the inverse rotation of a unit quaternion
+*/
+fxp16_quat_t fxp16_quat_conj(fxp16_quat_t q);
+
+/*!
+    \brief      Scales a quaternion to unit length
+    \details    Multiplies by 1/|q| from a table seeded Newton-Raphson reciprocal square
+                root, without a division or a square root. Use it after integrating
+                gyro rates to keep the rounding drift out of the attitude.
+    \returns    q / |q|; the identity and a domain error for the zero quaternion
+*/
+fxp16_quat_t fxp16_quat_normalize(fxp16_quat_t q);
+
+/*!
+    \brief      Rotation matrix of a unit quaternion
+    \param[in]  q       Rotation
+    \param[out] r       Matrix in Q14, r * v rotates v like q v q*
+*/
+void fxp16_quat_to_mat3(fxp16_quat_t q, fxp16_mat3_t *r);
+
+/*!
+    \brief      Rotates an array of 3D points
+    \details    fxp16_mat3_transform_soa() with the matrix of \p q.
+*/
+void fxp16_quat_rotate_soa(fxp16_quat_t q, const fxp16_t *x, const fxp16_t *y, const fxp16_t *z,
+                           fxp16_t *ox, fxp16_t *oy, fxp16_t *oz, size_t n);
+
+/*!
+    \brief      Euler angles of a unit quaternion
+    \details    roll and yaw from fxp16_atan2(), pitch from fxp16_asin(). Near pitch = ±π/2
+                (gimbal lock) roll and yaw are not unique.
+*/
+fxp16_euler_t fxp16_quat_to_euler(fxp16_quat_t q);
+
+/*!
+    \brief      Unit quaternion of Euler angles
+*/
+fxp16_quat_t fxp16_euler_to_quat(fxp16_euler_t e);
+
+#endif /* _FXP16_MAT_H_ */
@@ -0,0 +1,378 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_moments.c
+
+    \brief  Mean, RMS, variance and peak of fxp16 buffers and streams
+*/
+
+#include "fxp16_moments.h"
+#include "fxp16_kernels.h"
+
+
+#define fxp16_sumsq_impl    (fxp16_kernels()->sumsq)
+#define fxp16_minmax_impl   (fxp16_kernels()->minmax)
+
+/* samples per sumsq kernel call, keeps its 64 bit sum of squares exact */
+#define FXP16_MOMENTS_CHUNK     ((size_t)1 << 24)
+
+
+/* ---- 128 bit helpers ---------------------------------------------------- */
+
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} fxp16_u128_t;
+
+static fxp16_u128_t fxp16_u128_mul(uint64_t a, uint64_t b)
+{
+    uint64_t p00 = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+    uint64_t p01 = (a & 0xFFFFFFFFu) * (b >> 32);
+    uint64_t p10 = (a >> 32) * (b & 0xFFFFFFFFu);
+    uint64_t p11 = (a >> 32) * (b >> 32);
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+    fxp16_u128_t r;
+
+    r.lo = (mid << 32) | (p00 & 0xFFFFFFFFu);
+    r.hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return r;
+}
+
+static fxp16_u128_t fxp16_u128_add(fxp16_u128_t a, fxp16_u128_t b)
+{
+    a.lo += b.lo;
+    a.hi += b.hi + (a.lo < b.lo);
+    return a;
+}
+
+static fxp16_u128_t fxp16_u128_sub(fxp16_u128_t a, fxp16_u128_t b)
+{
+    a.hi -= b.hi + (a.lo < b.lo);
+    a.lo -= b.lo;
+    return a;
+}
+
+static fxp16_u128_t fxp16_u128_shl(fxp16_u128_t a, unsigned s)
+{
+    if (s >= 64) { a.hi = s < 128 ? a.lo << (s - 64) : 0; a.lo = 0; }
+    else if (s > 0) { a.hi = (a.hi << s) | (a.lo >> (64 - s)); a.lo <<= s; }
+    return a;
+}
+
+static fxp16_u128_t fxp16_u128_shr(fxp16_u128_t a, unsigned s)
+{
+    if (s >= 64) { a.lo = s < 128 ? a.hi >> (s - 64) : 0; a.hi = 0; }
+    else if (s > 0) { a.lo = (a.lo >> s) | (a.hi << (64 - s)); a.hi >>= s; }
+    return a;
+}
+
+static unsigned fxp16_u128_bits(fxp16_u128_t a)
+{
+    uint64_t v = a.hi ? a.hi : a.lo;
+    unsigned n = a.hi ? 64 : 0;
+
+    while (v) { v >>= 1; n++; }
+    return n;
+}
+
+/*
+    round(num * 2^e / den), UINT64_MAX if it does not fit. Operands that would leave
+    128 bits are scaled down together, far below the final rounding.
+*/
+static uint64_t fxp16_u128_ratio(fxp16_u128_t num, fxp16_u128_t den, int e)
+{
+    unsigned l;
+
+    if (e > 0)
+    {
+        l = 127 - fxp16_u128_bits(num);
+        if (l > (unsigned)e) l = (unsigned)e;
+        num = fxp16_u128_shl(num, l);
+        den = fxp16_u128_shr(den, (unsigned)e - l);
+    }
+    else if (e < 0)
+    {
+        l = 127 - fxp16_u128_bits(den);
+        if (l > (unsigned)-e) l = (unsigned)-e;
+        den = fxp16_u128_shl(den, l);
+        num = fxp16_u128_shr(num, (unsigned)-e - l);
+    }
+
+    l = fxp16_u128_bits(den);
+    if (l > 64)
+    {
+        num = fxp16_u128_shr(num, l - 64);
+        den = fxp16_u128_shr(den, l - 64);
+    }
+
+    uint64_t d = den.lo, r = num.hi, q = 0;
+
+    if (d == 0 || r >= d)
+    {
+        return UINT64_MAX;
+    }
+
+    /* restoring division of the 128 bit numerator, the quotient fits 64 bits */
+    for (int i = 63; i >= 0; i--)
+    {
+        uint64_t carry = r >> 63;
+
+        r = (r << 1) | ((num.lo >> i) & 1);
+        q <<= 1;
+
+        if (carry || r >= d)
+        {
+            r -= d;
+            q |= 1;
+        }
+    }
+
+    return (r >= d - r && q != UINT64_MAX) ? q + 1 : q;
+}
+
+
+/* ---- results ------------------------------------------------------------ */
+
+static fxp16_t fxp16_moments_sat(uint64_t v, int neg)
+{
+    int64_t t = v > INT32_MAX ? INT32_MAX : (int64_t)v;
+
+    if (neg) t = -t;
+    fxp16_sat_m(t);
+    return (fxp16_t)t;
+}
+
+/* sqrt(t) for an integer radicand in Q(2 yfrac), through fxp16_sqrt on its top 15 bits */
+static fxp16_t fxp16_moments_sqrt(uint64_t t)
+{
+    unsigned f = 0;
+    uint64_t v = t;
+
+    if (t >= ((uint64_t)1 << 30))
+    {
+        return fxp16_moments_sat(t, 0);
+    }
+
+    while ((v >> f) > INT16_MAX) f++;
+
+    if (f > 0)
+    {
+        v = (t + ((uint64_t)1 << (f - 1))) >> f;
+        if (v > INT16_MAX) v = INT16_MAX;
+    }
+
+    return fxp16_sqrt((fxp16_t)v, (uint8_t)f);
+}
+
+static fxp16_u128_t fxp16_moments_u128(uint64_t v)
+{
+    fxp16_u128_t r = { 0, v };
+    return r;
+}
+
+/* n sum(x^2) - sum(x)^2 = n^2 var */
+static fxp16_u128_t fxp16_moments_n2var(const fxp16_moments_t *m)
+{
+    uint64_t s = m->sum < 0 ? 0 - (uint64_t)m->sum : (uint64_t)m->sum;
+    fxp16_u128_t a = fxp16_u128_mul(m->sumsq_lo, m->count);
+
+    a.hi += m->sumsq_hi * m->count;
+    return fxp16_u128_sub(a, fxp16_u128_mul(s, s));
+}
+
+
+void fxp16_moments_reset(fxp16_moments_t *m)
+{
+    const fxp16_moments_t empty = FXP16_MOMENTS_INIT;
+    *m = empty;
+}
+
+
+void fxp16_sumsq_scalar(const fxp16_t *x, size_t n, int64_t *sum, uint64_t *sumsq)
+{
+    int64_t  s = 0;
+    uint64_t q = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        s += x[i];
+        q += (uint32_t)((fxp32_t)x[i] * x[i]);
+    }
+
+    *sum   = s;
+    *sumsq = q;
+}
+
+
+void fxp16_minmax_scalar(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max)
+{
+    fxp16_t lo = *min, hi = *max;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        lo = x[i] < lo ? x[i] : lo;
+        hi = x[i] > hi ? x[i] : hi;
+    }
+
+    *min = lo;
+    *max = hi;
+}
+
+
+/* sums and count, without the min/max pass */
+static void fxp16_moments_sums(fxp16_moments_t *m, const fxp16_t *x, size_t n)
+{
+    for (size_t i = 0; i < n; i += FXP16_MOMENTS_CHUNK)
+    {
+        size_t   k = n - i < FXP16_MOMENTS_CHUNK ? n - i : FXP16_MOMENTS_CHUNK;
+        int64_t  s;
+        uint64_t q;
+
+        fxp16_sumsq_impl(x + i, k, &s, &q);
+        m->sum += s;
+        m->sumsq_lo += q;
+        m->sumsq_hi += m->sumsq_lo < q;
+    }
+
+    m->count += n;
+}
+
+
+void fxp16_moments_update(fxp16_moments_t *m, const fxp16_t *x, size_t n)
+{
+    fxp16_stats_call_m(moments_update);
+
+    fxp16_moments_sums(m, x, n);
+    fxp16_minmax_impl(x, n, &m->min, &m->max);
+}
+
+
+void fxp16_moments_merge(fxp16_moments_t *m, const fxp16_moments_t *other)
+{
+    fxp16_u128_t a = { m->sumsq_hi, m->sumsq_lo };
+    fxp16_u128_t b = { other->sumsq_hi, other->sumsq_lo };
+
+    a = fxp16_u128_add(a, b);
+    m->sumsq_hi = a.hi;
+    m->sumsq_lo = a.lo;
+    m->count += other->count;
+    m->sum   += other->sum;
+    m->min    = other->min < m->min ? other->min : m->min;
+    m->max    = other->max > m->max ? other->max : m->max;
+}
+
+
+fxp16_t fxp16_moments_mean(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac)
+{
+    uint64_t s = m->sum < 0 ? 0 - (uint64_t)m->sum : (uint64_t)m->sum;
+
+    if (m->count == 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_moments_sat(fxp16_u128_ratio(fxp16_moments_u128(s), fxp16_moments_u128(m->count),
+                                              yfrac - xfrac), m->sum < 0);
+}
+
+
+fxp16_t fxp16_moments_rms(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac)
+{
+    fxp16_u128_t q = { m->sumsq_hi, m->sumsq_lo };
+
+    if (m->count == 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_moments_sqrt(fxp16_u128_ratio(q, fxp16_moments_u128(m->count), 2 * yfrac - 2 * xfrac));
+}
+
+
+fxp16_t fxp16_moments_var(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac)
+{
+    if (m->count == 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_moments_sat(fxp16_u128_ratio(fxp16_moments_n2var(m), fxp16_u128_mul(m->count, m->count),
+                                              yfrac - 2 * xfrac), 0);
+}
+
+
+fxp16_t fxp16_moments_std(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac)
+{
+    if (m->count == 0)
+    {
+        fxp16_status_raise_m(FXP16_STATUS_DOMAIN);
+        return 0;
+    }
+
+    return fxp16_moments_sqrt(fxp16_u128_ratio(fxp16_moments_n2var(m), fxp16_u128_mul(m->count, m->count),
+                                               2 * yfrac - 2 * xfrac));
+}
+
+
+fxp16_t fxp16_rms_vec(const fxp16_t *x, size_t n, uint8_t xfrac, uint8_t yfrac)
+{
+    fxp16_moments_t m = FXP16_MOMENTS_INIT;
+
+    fxp16_stats_call_m(rms_vec);
+
+    fxp16_moments_sums(&m, x, n);
+    return fxp16_moments_rms(&m, xfrac, yfrac);
+}
+
+
+void fxp16_minmax_vec(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max)
+{
+    fxp16_t lo = INT16_MAX, hi = INT16_MIN;
+
+    fxp16_stats_call_m(minmax_vec);
+
+    fxp16_minmax_impl(x, n, &lo, &hi);
+    *min = lo;
+    *max = hi;
+}
+
+
+void fxp16_meanvar_vec(const fxp16_t *x, size_t n, uint8_t xfrac, uint8_t yfrac, fxp16_t *mean, fxp16_t *var)
+{
+    fxp16_moments_t m = FXP16_MOMENTS_INIT;
+
+    fxp16_stats_call_m(meanvar_vec);
+
+    fxp16_moments_sums(&m, x, n);
+    *mean = fxp16_moments_mean(&m, xfrac, yfrac);
+    *var  = fxp16_moments_var(&m, xfrac, yfrac);
+}
@@ -0,0 +1,139 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_moments.h
+
+    \brief  Mean, RMS, variance and peak of fxp16 buffers and streams
+
+    \details Block functions (fxp16_rms_vec(), fxp16_minmax_vec(), fxp16_meanvar_vec())
+             take a single pass over the buffer. fxp16_moments_t keeps the same sums
+             for a sequence of any length that is fed block by block.
+
+             The sums are exact integers: sum of x in 64 bit, sum of x^2 in 128 bit.
+             Results are computed from them only when asked for, rounded once to the
+             Q format chosen by the caller; RMS and standard deviation go through
+             fxp16_sqrt(). The sum of x limits a stream to 2^48 samples.
+*/
+
+#ifndef _FXP16_MOMENTS_H_
+#define _FXP16_MOMENTS_H_
+
+#include "fxp16.h"
+
+
+/*! \brief Running sums of a sequence */
+typedef struct {
+    uint64_t count;         /*!< number of samples */
+    int64_t  sum;           /*!< sum of x */
+    uint64_t sumsq_lo;      /*!< sum of x^2, low 64 bits */
+    uint64_t sumsq_hi;      /*!< sum of x^2, high 64 bits */
+    fxp16_t  min;           /*!< smallest sample, INT16_MAX while empty */
+    fxp16_t  max;           /*!< largest sample, INT16_MIN while empty */
+} fxp16_moments_t;
+
+/*! \brief Initializer of an empty fxp16_moments_t */
+#define FXP16_MOMENTS_INIT  { 0, 0, 0, 0, INT16_MAX, INT16_MIN }
+
+
+/*!
+    \brief      Empties the running sums
+*/
+void fxp16_moments_reset(fxp16_moments_t *m);
+
+/*!
+    \brief      Adds a block of samples
+    \param[in]  m   Running sums
+    \param[in]  x   Samples
+    \param[in]  n   Number of samples
+*/
+void fxp16_moments_update(fxp16_moments_t *m, const fxp16_t *x, size_t n);
+
+/*!
+    \brief      Adds the samples of another fxp16_moments_t, e.g. of a parallel channel
+*/
+void fxp16_moments_merge(fxp16_moments_t *m, const fxp16_moments_t *other);
+
+/*!
+    \brief      Mean
+    \param[in]  m       Running sums
+    \param[in]  xfrac   Fractional bits of the samples
+    \param[in]  yfrac   Fractional bits of the result
+    \returns    Mean in Q\p yfrac, saturated; 0 and a domain error if empty
+*/
+fxp16_t fxp16_moments_mean(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac);
+
+/*!
+    \brief      Root mean square
+    \details    sqrt(mean(x^2)) in Q\p yfrac, saturated; 0 and a domain error if empty.
+*/
+fxp16_t fxp16_moments_rms(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac);
+
+/*!
+    \brief      Population variance
+    \details    mean(x^2) - mean(x)^2 in Q\p yfrac, saturated; 0 and a domain error if
+                empty. Computed as (n sum(x^2) - sum(x)^2) / n^2 exactly, so a small
+                variance on a large offset does not cancel out.
+*/
+fxp16_t fxp16_moments_var(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac);
+
+/*!
+    \brief      Population standard deviation
+    \details    Square root of fxp16_moments_var(), in Q\p yfrac.
+*/
+fxp16_t fxp16_moments_std(const fxp16_moments_t *m, uint8_t xfrac, uint8_t yfrac);
+
+
+/*!
+    \brief      RMS of a buffer
+    \param[in]  x       Samples
+    \param[in]  n       Number of samples
+    \param[in]  xfrac   Fractional bits of \p x
+    \param[in]  yfrac   Fractional bits of the result
+    \returns    sqrt(mean(x^2)) in Q\p yfrac
+*/
+fxp16_t fxp16_rms_vec(const fxp16_t *x, size_t n, uint8_t xfrac, uint8_t yfrac);
+
+/*!
+    \brief      Smallest and largest sample of a buffer
+    \details    INT16_MAX and INT16_MIN for an empty buffer.
+*/
+void fxp16_minmax_vec(const fxp16_t *x, size_t n, fxp16_t *min, fxp16_t *max);
+
+/*!
+    \brief      Mean and population variance of a buffer
+    \param[in]  x       Samples
+    \param[in]  n       Number of samples
+    \param[in]  xfrac   Fractional bits of \p x
+    \param[in]  yfrac   Fractional bits of the results
+    \param[out] mean    Mean in Q\p yfrac
+    \param[out] var     Variance in Q\p yfrac
+*/
+void fxp16_meanvar_vec(const fxp16_t *x, size_t n, uint8_t xfrac, uint8_t yfrac, fxp16_t *mean, fxp16_t *var);
+
+#endif /* _FXP16_MOMENTS_H_ */
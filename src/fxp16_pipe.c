@@ -0,0 +1,623 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_pipe.c
+
+    \brief  Multithreaded block pipeline of fxp16 stages
+*/
+
+#if !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE     200809L     /* clock_gettime */
+#endif
+
+#include "fxp16_pipe.h"
+#include "fxp16_complex.h"
+#include "fxp16_stats.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+#define FXP16_PIPE_CACHE_LINE   64
+
+_Static_assert(FXP16_ARENA_ALIGN % FXP16_PIPE_CACHE_LINE == 0, "arena allocations must keep the workers aligned");
+
+
+/* ---- pool --------------------------------------------------------------- */
+
+typedef struct {
+    /* channels [lo, hi) still to run, lo in the low and hi in the high 32 bits;
+       the owner takes from lo, thieves cut off the upper half */
+    _Alignas(FXP16_PIPE_CACHE_LINE) _Atomic uint64_t range;
+
+    /* written by the owning thread only */
+    _Alignas(FXP16_PIPE_CACHE_LINE) fxp16_t *scratch[2];
+    uint64_t calls[FXP16CONF_PIPE_MAX_STAGES];
+    uint64_t samples[FXP16CONF_PIPE_MAX_STAGES];
+    uint64_t ns[FXP16CONF_PIPE_MAX_STAGES];
+    uint64_t steals;
+    pthread_t tid;
+    int index;
+    struct fxp16_pipe_pool *pool;
+} fxp16_pipe_worker_t;
+
+struct fxp16_pipe_pool {
+    fxp16_pipe_worker_t *workers;
+    int                  nworkers;      /* allocated */
+    int                  threads;       /* running, including the caller */
+
+    pthread_mutex_t      lock;
+    pthread_cond_t       start;
+    pthread_cond_t       done;
+    uint64_t             generation;    /* incremented per run */
+    int                  pending;       /* threads still working on the run */
+    int                  quit;
+    int                  arena;         /* memory belongs to an arena, nothing to free */
+
+    /* current run, published by the lock */
+    const fxp16_pipe_t     *p;
+    const fxp16_t *const   *in;
+    fxp16_t *const         *out;
+    size_t                 *out_n;
+    size_t                  n;
+};
+
+
+static uint64_t fxp16_pipe_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t fxp16_pipe_range(uint32_t lo, uint32_t hi)
+{
+    return ((uint64_t)hi << 32) | lo;
+}
+
+
+/* ---- one channel -------------------------------------------------------- */
+
+static size_t fxp16_pipe_call(const fxp16_pipe_t *p, fxp16_pipe_worker_t *w, size_t s, size_t c,
+                              const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_pipe_stage_t *st = &p->stages[s];
+    void *state = st->state ? (char *)st->state + c * st->state_size : NULL;
+    uint64_t t0;
+    size_t m;
+
+    w->calls[s]++;
+    w->samples[s] += n;
+
+    if (!p->timing)
+    {
+        return st->fn(st->arg, state, x, y, n);
+    }
+
+    t0 = fxp16_pipe_now();
+    m = st->fn(st->arg, state, x, y, n);
+    w->ns[s] += fxp16_pipe_now() - t0;
+    return m;
+}
+
+/* runs stage groups alternately into the two scratch blocks, the last one into out */
+static size_t fxp16_pipe_channel(const fxp16_pipe_t *p, fxp16_pipe_worker_t *w, size_t c,
+                                 const fxp16_t *x, fxp16_t *out, size_t n)
+{
+    const fxp16_t *src = x;
+    size_t s = 0;
+    int k = 0;
+
+    while (s < p->nstages)
+    {
+        size_t e = s + 1;
+        fxp16_t *dst;
+
+        if (p->stages[s].flags & FXP16_PIPE_ELEMENTWISE)
+        {
+            while (e < p->nstages && (p->stages[e].flags & FXP16_PIPE_ELEMENTWISE))
+            {
+                e++;
+            }
+        }
+
+        dst = (e == p->nstages) ? out : w->scratch[k];
+
+        if (p->stages[s].flags & FXP16_PIPE_ELEMENTWISE)
+        {
+            /* fused: every tile passes all stages of the group while it is in L1 */
+            for (size_t off = 0; off < n; off += FXP16CONF_PIPE_TILE)
+            {
+                size_t len = (n - off < FXP16CONF_PIPE_TILE) ? n - off : FXP16CONF_PIPE_TILE;
+
+                fxp16_pipe_call(p, w, s, c, src + off, dst + off, len);
+
+                for (size_t j = s + 1; j < e; j++)
+                {
+                    fxp16_pipe_call(p, w, j, c, dst + off, dst + off, len);
+                }
+            }
+        }
+        else
+        {
+            n = fxp16_pipe_call(p, w, s, c, src, dst, n);
+        }
+
+        src = dst;
+        k ^= 1;
+        s = e;
+    }
+
+    return n;
+}
+
+
+/* ---- work stealing ------------------------------------------------------ */
+
+/* the ranges only hand out channel indices, the block data is published by the pool lock */
+
+static int fxp16_pipe_pop(fxp16_pipe_worker_t *w, uint32_t *c)
+{
+    uint64_t r = atomic_load_explicit(&w->range, memory_order_relaxed);
+
+    for (;;)
+    {
+        uint32_t lo = (uint32_t)r;
+        uint32_t hi = (uint32_t)(r >> 32);
+
+        if (lo >= hi)
+        {
+            return 0;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&w->range, &r, fxp16_pipe_range(lo + 1, hi),
+                                                  memory_order_relaxed, memory_order_relaxed))
+        {
+            *c = lo;
+            return 1;
+        }
+    }
+}
+
+/* moves the upper half of another worker's range into the empty own one */
+static int fxp16_pipe_steal(struct fxp16_pipe_pool *pool, fxp16_pipe_worker_t *w)
+{
+    for (int i = 1; i < pool->threads; i++)
+    {
+        fxp16_pipe_worker_t *v = &pool->workers[(w->index + i) % pool->threads];
+        uint64_t r = atomic_load_explicit(&v->range, memory_order_relaxed);
+
+        for (;;)
+        {
+            uint32_t lo  = (uint32_t)r;
+            uint32_t hi  = (uint32_t)(r >> 32);
+            uint32_t mid = lo + (hi - lo) / 2;
+
+            if (lo >= hi)
+            {
+                break;
+            }
+
+            if (atomic_compare_exchange_weak_explicit(&v->range, &r, fxp16_pipe_range(lo, mid),
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                atomic_store_explicit(&w->range, fxp16_pipe_range(mid, hi), memory_order_relaxed);
+                w->steals++;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void fxp16_pipe_work(struct fxp16_pipe_pool *pool, fxp16_pipe_worker_t *w)
+{
+    uint32_t c;
+
+    do
+    {
+        while (fxp16_pipe_pop(w, &c))
+        {
+            size_t m = fxp16_pipe_channel(pool->p, w, c, pool->in[c], pool->out[c], pool->n);
+
+            if (pool->out_n)
+            {
+                pool->out_n[c] = m;
+            }
+        }
+    }
+    while (fxp16_pipe_steal(pool, w));
+}
+
+static void *fxp16_pipe_thread(void *arg)
+{
+    fxp16_pipe_worker_t *w = (fxp16_pipe_worker_t *)arg;
+    struct fxp16_pipe_pool *pool = w->pool;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+
+    for (;;)
+    {
+        while (!pool->quit && pool->generation == seen)
+        {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+
+        if (pool->quit)
+        {
+            break;
+        }
+
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        fxp16_pipe_work(pool, w);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+
+/* ---- API ---------------------------------------------------------------- */
+
+/* argument check shared by both inits */
+static int fxp16_pipe_check(const fxp16_pipe_stage_t *stages, size_t nstages, size_t max_block, int threads)
+{
+    if (nstages == 0 || nstages > FXP16CONF_PIPE_MAX_STAGES || max_block == 0
+        || threads < 1 || threads > FXP16CONF_PIPE_MAX_THREADS)
+    {
+        return -1;
+    }
+
+    for (size_t s = 0; s < nstages; s++)
+    {
+        if (stages[s].fn == NULL)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* pool, workers and their first scratch blocks are allocated and cleared */
+static void fxp16_pipe_start(fxp16_pipe_t *p, struct fxp16_pipe_pool *pool, const fxp16_pipe_stage_t *stages,
+                             size_t nstages, size_t max_block, int threads)
+{
+    for (int t = 0; t < threads; t++)
+    {
+        fxp16_pipe_worker_t *w = &pool->workers[t];
+
+        w->scratch[1] = w->scratch[0] + max_block;
+        w->index = t;
+        w->pool = pool;
+    }
+
+    pool->nworkers = threads;
+
+    memcpy(p->stages, stages, nstages * sizeof(*stages));
+    p->nstages   = nstages;
+    p->max_block = max_block;
+    p->pool      = pool;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    /* worker 0 is the caller of fxp16_pipe_run(); run with the threads that started */
+    pool->threads = 1;
+    for (int t = 1; t < threads; t++)
+    {
+        if (pthread_create(&pool->workers[t].tid, NULL, fxp16_pipe_thread, &pool->workers[t]) != 0)
+        {
+            break;
+        }
+        pool->threads = t + 1;
+    }
+}
+
+
+int fxp16_pipe_init(fxp16_pipe_t *p, const fxp16_pipe_stage_t *stages, size_t nstages,
+                    size_t max_block, int threads)
+{
+    struct fxp16_pipe_pool *pool;
+
+    memset(p, 0, sizeof(*p));
+
+    if (fxp16_pipe_check(stages, nstages, max_block, threads) != 0)
+    {
+        return -1;
+    }
+
+    pool = calloc(1, sizeof(*pool));
+    if (pool == NULL)
+    {
+        return -1;
+    }
+
+    /* workers are cache line aligned, so their size is a multiple of the alignment */
+    pool->workers = aligned_alloc(FXP16_PIPE_CACHE_LINE, (size_t)threads * sizeof(fxp16_pipe_worker_t));
+    if (pool->workers == NULL)
+    {
+        free(pool);
+        return -1;
+    }
+
+    memset(pool->workers, 0, (size_t)threads * sizeof(fxp16_pipe_worker_t));
+
+    for (int t = 0; t < threads; t++)
+    {
+        pool->workers[t].scratch[0] = malloc(2 * max_block * sizeof(fxp16_t));
+
+        if (pool->workers[t].scratch[0] == NULL)
+        {
+            while (t-- > 0)
+            {
+                free(pool->workers[t].scratch[0]);
+            }
+            free(pool->workers);
+            free(pool);
+            return -1;
+        }
+    }
+
+    fxp16_pipe_start(p, pool, stages, nstages, max_block, threads);
+    return 0;
+}
+
+
+size_t fxp16_pipe_bytes(size_t max_block, int threads)
+{
+    return FXP16_ARENA_SIZE(sizeof(struct fxp16_pipe_pool))
+         + FXP16_ARENA_SIZE((size_t)threads * sizeof(fxp16_pipe_worker_t))
+         + (size_t)threads * FXP16_ARENA_SIZE(2 * max_block * sizeof(fxp16_t));
+}
+
+
+int fxp16_pipe_init_arena(fxp16_pipe_t *p, fxp16_arena_t *a, const fxp16_pipe_stage_t *stages, size_t nstages,
+                          size_t max_block, int threads)
+{
+    size_t mark = fxp16_arena_mark(a);
+    struct fxp16_pipe_pool *pool;
+
+    memset(p, 0, sizeof(*p));
+
+    if (fxp16_pipe_check(stages, nstages, max_block, threads) != 0)
+    {
+        return -1;
+    }
+
+    pool = fxp16_arena_alloc(a, sizeof(*pool));
+    if (pool == NULL)
+    {
+        return -1;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->arena = 1;
+    pool->workers = fxp16_arena_alloc(a, (size_t)threads * sizeof(fxp16_pipe_worker_t));
+    if (pool->workers == NULL)
+    {
+        fxp16_arena_release(a, mark);
+        return -1;
+    }
+
+    memset(pool->workers, 0, (size_t)threads * sizeof(fxp16_pipe_worker_t));
+
+    /* one block per worker keeps the scratch of different workers on different lines */
+    for (int t = 0; t < threads; t++)
+    {
+        pool->workers[t].scratch[0] = fxp16_arena_alloc(a, 2 * max_block * sizeof(fxp16_t));
+
+        if (pool->workers[t].scratch[0] == NULL)
+        {
+            fxp16_arena_release(a, mark);
+            return -1;
+        }
+    }
+
+    fxp16_pipe_start(p, pool, stages, nstages, max_block, threads);
+    return 0;
+}
+
+
+void fxp16_pipe_free(fxp16_pipe_t *p)
+{
+    struct fxp16_pipe_pool *pool = p->pool;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int t = 1; t < pool->threads; t++)
+    {
+        pthread_join(pool->workers[t].tid, NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+
+    p->pool = NULL;
+
+    if (pool->arena)
+    {
+        return;
+    }
+
+    /* workers whose thread failed to start have scratch blocks too */
+    for (int t = 0; t < pool->nworkers; t++)
+    {
+        free(pool->workers[t].scratch[0]);
+    }
+
+    free(pool->workers);
+    free(pool);
+}
+
+
+int fxp16_pipe_threads(const fxp16_pipe_t *p)
+{
+    return p->pool ? p->pool->threads : 0;
+}
+
+
+int fxp16_pipe_run(fxp16_pipe_t *p, const fxp16_t *const *in, fxp16_t *const *out,
+                   size_t *out_n, size_t channels, size_t n)
+{
+    struct fxp16_pipe_pool *pool = p->pool;
+
+    fxp16_stats_call_m(pipe_run);
+
+    if (n > p->max_block || channels > UINT32_MAX)
+    {
+        return -1;
+    }
+
+    /* contiguous initial ranges, stealing evens out the rest */
+    for (int t = 0; t < pool->threads; t++)
+    {
+        uint32_t lo = (uint32_t)(channels * (size_t)t / (size_t)pool->threads);
+        uint32_t hi = (uint32_t)(channels * (size_t)(t + 1) / (size_t)pool->threads);
+        atomic_store_explicit(&pool->workers[t].range, fxp16_pipe_range(lo, hi), memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->p       = p;
+    pool->in      = in;
+    pool->out     = out;
+    pool->out_n   = out_n;
+    pool->n       = n;
+    pool->pending = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    fxp16_pipe_work(pool, &pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
+
+
+void fxp16_pipe_set_timing(fxp16_pipe_t *p, int on)
+{
+    p->timing = on;
+}
+
+
+void fxp16_pipe_timing(const fxp16_pipe_t *p, fxp16_pipe_timing_t *t)
+{
+    const struct fxp16_pipe_pool *pool = p->pool;
+
+    for (size_t s = 0; s < p->nstages; s++)
+    {
+        t[s].name    = p->stages[s].name;
+        t[s].calls   = 0;
+        t[s].samples = 0;
+        t[s].ns      = 0;
+
+        for (int w = 0; w < pool->nworkers; w++)
+        {
+            t[s].calls   += pool->workers[w].calls[s];
+            t[s].samples += pool->workers[w].samples[s];
+            t[s].ns      += pool->workers[w].ns[s];
+        }
+    }
+}
+
+
+void fxp16_pipe_timing_reset(fxp16_pipe_t *p)
+{
+    struct fxp16_pipe_pool *pool = p->pool;
+
+    for (int w = 0; w < pool->nworkers; w++)
+    {
+        memset(pool->workers[w].calls, 0, sizeof(pool->workers[w].calls));
+        memset(pool->workers[w].samples, 0, sizeof(pool->workers[w].samples));
+        memset(pool->workers[w].ns, 0, sizeof(pool->workers[w].ns));
+    }
+}
+
+
+uint64_t fxp16_pipe_steals(const fxp16_pipe_t *p)
+{
+    uint64_t steals = 0;
+
+    for (int w = 0; w < p->pool->nworkers; w++)
+    {
+        steals += p->pool->workers[w].steals;
+    }
+
+    return steals;
+}
+
+
+/* ---- stock stages ------------------------------------------------------- */
+
+size_t fxp16_pipe_fp2fp(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_pipe_fp2fp_t *q = (const fxp16_pipe_fp2fp_t *)arg;
+
+    (void)state;
+    fxp16_fp2fp_vec(x, y, n, q->fracold, q->fracnew);
+    return n;
+}
+
+
+size_t fxp16_pipe_cmag(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    (void)arg;
+    (void)state;
+    fxp16_cmag_vec((const fxp16_complex_t *)x, y, n / 2);
+    return n / 2;
+}
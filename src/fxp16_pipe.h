@@ -0,0 +1,215 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_pipe.h
+
+    \brief  Multithreaded block pipeline of fxp16 stages
+
+    \details Runs a chain of block stages (requantize, filter, mix, decimate,
+             magnitude, ...) over many independent channels. Adjacent elementwise
+             stages are fused: they run tile by tile, so a tile of
+             FXP16CONF_PIPE_TILE samples stays in L1 while it passes all of them,
+             instead of each stage streaming the whole block through memory.
+             Block stages see the whole block and may shorten it.
+
+             Channels are spread over a pool of worker threads created once at
+             init. Each worker starts on its own contiguous range of channels and,
+             when that runs dry, steals half of the remaining range of another
+             worker, so uneven channel costs still keep every thread busy. The
+             calling thread is worker 0.
+
+             Optionally each worker times every stage call; fxp16_pipe_timing()
+             sums the times per stage.
+*/
+
+#ifndef _FXP16_PIPE_H_
+#define _FXP16_PIPE_H_
+
+#include "fxp16.h"
+#include "fxp16_arena.h"
+
+
+/*! \brief Maximum number of stages of a pipeline */
+#ifndef FXP16CONF_PIPE_MAX_STAGES
+#define FXP16CONF_PIPE_MAX_STAGES   16
+#endif
+
+/*! \brief Maximum number of worker threads, including the caller */
+#ifndef FXP16CONF_PIPE_MAX_THREADS
+#define FXP16CONF_PIPE_MAX_THREADS  16
+#endif
+
+/*! \brief Samples per tile of fused elementwise stages */
+#ifndef FXP16CONF_PIPE_TILE
+#define FXP16CONF_PIPE_TILE         256
+#endif
+
+
+/*! \brief Stage flag: output sample i depends on input samples up to i only, in order */
+#define FXP16_PIPE_ELEMENTWISE      0x01
+
+
+/*!
+    \brief      Stage function
+    \details    Elementwise stages must return \p n and accept \p y == \p x, since
+                fused stages run in place on a tile. Block stages get \p x != \p y and
+                the whole block and may return fewer samples than \p n, never more.
+    \param[in]  arg     Stage argument shared by all channels
+    \param[in]  state   State of the channel, NULL if the stage has none
+    \param[in]  x       Input samples
+    \param[out] y       Output samples
+    \param[in]  n       Number of input samples
+    \returns    Number of output samples
+*/
+typedef size_t (*fxp16_pipe_fn_t)(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n);
+
+/*!
+    \brief      Pipeline stage
+    \details    Channel c uses the state at (char *)state + c * state_size. A channel's
+                states are only touched by the worker that runs the channel.
+*/
+typedef struct {
+    const char      *name;          /*!< label of the timing report */
+    fxp16_pipe_fn_t  fn;
+    const void      *arg;           /*!< shared, read only while running */
+    void            *state;         /*!< state of channel 0, or NULL */
+    size_t           state_size;    /*!< bytes between the states of adjacent channels */
+    unsigned         flags;         /*!< FXP16_PIPE_ELEMENTWISE or 0 */
+} fxp16_pipe_stage_t;
+
+/*! \brief Accumulated time of one stage over all workers */
+typedef struct {
+    const char *name;
+    uint64_t    calls;      /*!< stage function calls, one per tile when fused */
+    uint64_t    samples;    /*!< input samples */
+    uint64_t    ns;         /*!< wall time inside the stage function, summed over workers */
+} fxp16_pipe_timing_t;
+
+struct fxp16_pipe_pool;
+
+/*! \brief Pipeline, set up by fxp16_pipe_init() */
+typedef struct {
+    fxp16_pipe_stage_t      stages[FXP16CONF_PIPE_MAX_STAGES];
+    size_t                  nstages;
+    size_t                  max_block;
+    int                     timing;     /*!< time the stages, see fxp16_pipe_set_timing() */
+    struct fxp16_pipe_pool *pool;
+} fxp16_pipe_t;
+
+
+/*!
+    \brief      Sets up a pipeline and starts its worker threads
+    \details    The stage array is copied. If fewer threads can be started than
+                requested the pipeline runs with those that could.
+    \param[out] p           Pipeline
+    \param[in]  stages      Stages in processing order
+    \param[in]  nstages     1 to FXP16CONF_PIPE_MAX_STAGES
+    \param[in]  max_block   Largest block fxp16_pipe_run() will be given
+    \param[in]  threads     Worker threads including the caller, 1 to FXP16CONF_PIPE_MAX_THREADS
+    \returns    0 on success, -1 on bad arguments or failed allocation
+*/
+int fxp16_pipe_init(fxp16_pipe_t *p, const fxp16_pipe_stage_t *stages, size_t nstages,
+                    size_t max_block, int threads);
+
+/*! \brief Arena bytes fxp16_pipe_init_arena() takes */
+size_t fxp16_pipe_bytes(size_t max_block, int threads);
+
+/*!
+    \brief      fxp16_pipe_init() with all its memory taken from an arena
+    \details    Only the thread stacks come from the system, when the threads start.
+    \returns    0 on success, -1 on bad arguments or a too small arena; the arena is
+                unchanged then
+*/
+int fxp16_pipe_init_arena(fxp16_pipe_t *p, fxp16_arena_t *a, const fxp16_pipe_stage_t *stages, size_t nstages,
+                          size_t max_block, int threads);
+
+/*!
+    \brief      Stops the worker threads and releases the scratch memory
+    \details    Memory of fxp16_pipe_init_arena() stays in the arena.
+*/
+void fxp16_pipe_free(fxp16_pipe_t *p);
+
+/*! \brief Number of worker threads the pipeline runs with, including the caller */
+int fxp16_pipe_threads(const fxp16_pipe_t *p);
+
+/*!
+    \brief      Runs one block of every channel through all stages
+    \details    Returns when all channels are done. Not reentrant for the same pipeline.
+    \param[in]  p           Pipeline
+    \param[in]  in          \p channels input blocks of \p n samples
+    \param[out] out         \p channels output blocks of room for \p n samples, not
+                            overlapping the input blocks
+    \param[out] out_n       Output length per channel, or NULL
+    \param[in]  channels    Number of channels, at most UINT32_MAX
+    \param[in]  n           Block length, at most max_block
+    \returns    0 on success, -1 if \p n or \p channels is too large
+*/
+int fxp16_pipe_run(fxp16_pipe_t *p, const fxp16_t *const *in, fxp16_t *const *out,
+                   size_t *out_n, size_t channels, size_t n);
+
+/*!
+    \brief      Switches the per stage timing on or off
+    \details    Timing costs two clock reads per stage call, i.e. per tile of fused stages.
+*/
+void fxp16_pipe_set_timing(fxp16_pipe_t *p, int on);
+
+/*!
+    \brief      Accumulated stage times since init or the last reset
+    \param[in]  p       Pipeline
+    \param[out] t       nstages entries in stage order
+*/
+void fxp16_pipe_timing(const fxp16_pipe_t *p, fxp16_pipe_timing_t *t);
+
+/*! \brief Clears the stage times */
+void fxp16_pipe_timing_reset(fxp16_pipe_t *p);
+
+/*! \brief Number of successful steals since init, a measure of load imbalance */
+uint64_t fxp16_pipe_steals(const fxp16_pipe_t *p);
+
+
+/*! \brief Argument of fxp16_pipe_fp2fp() */
+typedef struct {
+    uint8_t fracold;
+    uint8_t fracnew;
+} fxp16_pipe_fp2fp_t;
+
+/*!
+    \brief      Elementwise stage: requantizes with fxp16_fp2fp_vec()
+    \details    \p arg is a fxp16_pipe_fp2fp_t, no state.
+*/
+size_t fxp16_pipe_fp2fp(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n);
+
+/*!
+    \brief      Block stage: magnitude of interleaved complex samples with fxp16_cmag_vec()
+    \details    Returns n / 2 magnitudes, an odd last sample is dropped. No argument or state.
+*/
+size_t fxp16_pipe_cmag(const void *arg, void *state, const fxp16_t *x, fxp16_t *y, size_t n);
+
+
+#endif /* _FXP16_PIPE_H_ */
@@ -0,0 +1,310 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_ring.c
+
+    \brief  Lock-free single-producer/single-consumer ring of fxp16 samples
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE     /* memfd_create */
+#endif
+
+#include "fxp16_ring.h"
+#include <string.h>
+
+#if FXP16CONF_RING_MMAP
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+
+int fxp16_ring_init(fxp16_ring_t *r, fxp16_t *buf, size_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+    {
+        return -1;
+    }
+
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->tail_cache = 0;
+    r->head_cache = 0;
+    r->buf        = buf;
+    r->capacity   = capacity;
+    r->mapped     = 0;
+    return 0;
+}
+
+
+int fxp16_ring_init_mapped(fxp16_ring_t *r, size_t capacity)
+{
+#if FXP16CONF_RING_MMAP
+    size_t bytes = capacity * sizeof(fxp16_t);
+    long   page  = sysconf(_SC_PAGESIZE);
+    int    fd;
+    char  *base;
+
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || page <= 0 || bytes % (size_t)page != 0)
+    {
+        return -1;
+    }
+
+    fd = memfd_create("fxp16_ring", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    /* reserve twice the size, then map the same pages into both halves */
+    base = mmap(NULL, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED
+        || ftruncate(fd, (off_t)bytes) != 0
+        || mmap(base, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+        || mmap(base + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        if (base != MAP_FAILED) munmap(base, 2 * bytes);
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+    fxp16_ring_init(r, (fxp16_t *)base, capacity);
+    r->mapped = 1;
+    return 0;
+#else
+    (void)r;
+    (void)capacity;
+    return -1;
+#endif
+}
+
+
+size_t fxp16_ring_bytes(size_t capacity)
+{
+    return FXP16_ARENA_SIZE(capacity * sizeof(fxp16_t));
+}
+
+
+int fxp16_ring_init_arena(fxp16_ring_t *r, fxp16_arena_t *a, size_t capacity)
+{
+    size_t mark = fxp16_arena_mark(a);
+    fxp16_t *buf = fxp16_arena_alloc(a, capacity * sizeof(fxp16_t));
+
+    if (buf == NULL || fxp16_ring_init(r, buf, capacity) != 0)
+    {
+        fxp16_arena_release(a, mark);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void fxp16_ring_free(fxp16_ring_t *r)
+{
+#if FXP16CONF_RING_MMAP
+    if (r->mapped)
+    {
+        munmap(r->buf, 2 * r->capacity * sizeof(fxp16_t));
+        r->buf    = NULL;
+        r->mapped = 0;
+    }
+#else
+    (void)r;
+#endif
+}
+
+
+size_t fxp16_ring_count(const fxp16_ring_t *r)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    return atomic_load_explicit(&r->head, memory_order_acquire) - tail;
+}
+
+
+size_t fxp16_ring_space(const fxp16_ring_t *r)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    return r->capacity - (head - atomic_load_explicit(&r->tail, memory_order_acquire));
+}
+
+
+/* ---- producer ----------------------------------------------------------- */
+
+/* free samples, re-reading the consumer index only if the cached one leaves fewer than n */
+static size_t fxp16_ring_free_n(fxp16_ring_t *r, size_t head, size_t n)
+{
+    size_t free = r->capacity - (head - r->tail_cache);
+
+    if (free < n)
+    {
+        r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+        free = r->capacity - (head - r->tail_cache);
+    }
+
+    return free;
+}
+
+
+size_t fxp16_ring_write_acquire(fxp16_ring_t *r, fxp16_t **region)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    size_t off  = head & (r->capacity - 1);
+    size_t span = r->mapped ? r->capacity : r->capacity - off;
+    size_t n    = fxp16_ring_free_n(r, head, span);
+
+    if (n > span)
+    {
+        n = span;
+    }
+
+    *region = r->buf + off;
+    return n;
+}
+
+
+fxp16_t *fxp16_ring_write_reserve(fxp16_ring_t *r, size_t n)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    size_t off  = head & (r->capacity - 1);
+
+    if (fxp16_ring_free_n(r, head, n) < n || (!r->mapped && n > r->capacity - off))
+    {
+        return NULL;
+    }
+
+    return r->buf + off;
+}
+
+
+void fxp16_ring_write_commit(fxp16_ring_t *r, size_t n)
+{
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    atomic_store_explicit(&r->head, head + n, memory_order_release);
+}
+
+
+size_t fxp16_ring_write(fxp16_ring_t *r, const fxp16_t *x, size_t n)
+{
+    size_t done = 0;
+
+    /* at most two regions, before and after the wrap point */
+    for (int i = 0; i < 2 && done < n; i++)
+    {
+        fxp16_t *p;
+        size_t   k = fxp16_ring_write_acquire(r, &p);
+
+        if (k == 0) break;
+        if (k > n - done) k = n - done;
+
+        memcpy(p, x + done, k * sizeof(fxp16_t));
+        fxp16_ring_write_commit(r, k);
+        done += k;
+    }
+
+    return done;
+}
+
+
+/* ---- consumer ----------------------------------------------------------- */
+
+/* filled samples, re-reading the producer index only if the cached one shows fewer than n */
+static size_t fxp16_ring_filled_n(fxp16_ring_t *r, size_t tail, size_t n)
+{
+    size_t filled = r->head_cache - tail;
+
+    if (filled < n)
+    {
+        r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+        filled = r->head_cache - tail;
+    }
+
+    return filled;
+}
+
+
+size_t fxp16_ring_read_acquire(fxp16_ring_t *r, const fxp16_t **region)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    size_t off  = tail & (r->capacity - 1);
+    size_t span = r->mapped ? r->capacity : r->capacity - off;
+    size_t n    = fxp16_ring_filled_n(r, tail, span);
+
+    if (n > span)
+    {
+        n = span;
+    }
+
+    *region = r->buf + off;
+    return n;
+}
+
+
+const fxp16_t *fxp16_ring_read_peek(fxp16_ring_t *r, size_t n)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    size_t off  = tail & (r->capacity - 1);
+
+    if (fxp16_ring_filled_n(r, tail, n) < n || (!r->mapped && n > r->capacity - off))
+    {
+        return NULL;
+    }
+
+    return r->buf + off;
+}
+
+
+void fxp16_ring_read_release(fxp16_ring_t *r, size_t n)
+{
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+}
+
+
+size_t fxp16_ring_read(fxp16_ring_t *r, fxp16_t *y, size_t n)
+{
+    size_t done = 0;
+
+    for (int i = 0; i < 2 && done < n; i++)
+    {
+        const fxp16_t *p;
+        size_t         k = fxp16_ring_read_acquire(r, &p);
+
+        if (k == 0) break;
+        if (k > n - done) k = n - done;
+
+        memcpy(y + done, p, k * sizeof(fxp16_t));
+        fxp16_ring_read_release(r, k);
+        done += k;
+    }
+
+    return done;
+}
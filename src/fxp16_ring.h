@@ -0,0 +1,192 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_ring.h
+
+    \brief  Lock-free single-producer/single-consumer ring of fxp16 samples
+
+    \details Moves sample blocks from one thread to another without locks and
+             without copies. The producer acquires a contiguous free region, fills it
+             in place and commits it; the consumer acquires a contiguous filled region,
+             processes it in place and releases it. Each side writes only its own
+             index, on its own cache line, and re-reads the other side's index only
+             when its cached copy does not cover the request.
+
+             Storage is either supplied by the caller or, with
+             fxp16_ring_init_mapped(), mapped twice back to back into virtual memory.
+             In the mapped mode every region is contiguous across the wrap point, so
+             FIR and FFT kernels can run over the ring directly.
+
+             Exactly one thread may call the write functions and exactly one thread
+             the read functions of a ring at any time.
+*/
+
+#ifndef _FXP16_RING_H_
+#define _FXP16_RING_H_
+
+#include "fxp16.h"
+#include "fxp16_arena.h"
+#include <stdatomic.h>
+
+
+/*! \brief Cache line size the indices are aligned to */
+#ifndef FXP16CONF_RING_CACHE_LINE
+#define FXP16CONF_RING_CACHE_LINE   64
+#endif
+
+/*! \brief Builds fxp16_ring_init_mapped(), needs memfd_create() and mmap() */
+#ifndef FXP16CONF_RING_MMAP
+    #if defined(__linux__)
+        #define FXP16CONF_RING_MMAP     1
+    #else
+        #define FXP16CONF_RING_MMAP     0
+    #endif
+#endif
+
+
+/*!
+    \brief      SPSC ring
+    \details    The indices run freely and are reduced modulo the capacity only to
+                address the buffer. Cache line alignment holds for static and automatic
+                objects; heap allocated rings need aligned_alloc().
+*/
+typedef struct {
+    /* producer side */
+    _Alignas(FXP16CONF_RING_CACHE_LINE) _Atomic size_t head;
+    size_t   tail_cache;
+
+    /* consumer side */
+    _Alignas(FXP16CONF_RING_CACHE_LINE) _Atomic size_t tail;
+    size_t   head_cache;
+
+    /* shared, read only after init */
+    _Alignas(FXP16CONF_RING_CACHE_LINE) fxp16_t *buf;
+    size_t   capacity;
+    int      mapped;
+} fxp16_ring_t;
+
+
+/*!
+    \brief      Sets up an empty ring on caller storage
+    \param[out] r           Ring
+    \param[in]  buf         \p capacity samples
+    \param[in]  capacity    Power of two
+    \returns    0 on success, -1 if \p capacity is not a power of two
+*/
+int fxp16_ring_init(fxp16_ring_t *r, fxp16_t *buf, size_t capacity);
+
+/*!
+    \brief      Sets up an empty ring on double mapped storage
+    \details    The storage is mapped a second time directly behind the first mapping,
+                so buf[i] and buf[i + capacity] are the same sample. Release it with
+                fxp16_ring_free().
+    \param[out] r           Ring
+    \param[in]  capacity    Power of two, capacity * sizeof(fxp16_t) a multiple of the page size
+    \returns    0 on success, -1 on a bad capacity, a failed mapping or without
+                FXP16CONF_RING_MMAP
+*/
+int fxp16_ring_init_mapped(fxp16_ring_t *r, size_t capacity);
+
+/*! \brief Arena bytes fxp16_ring_init_arena() takes */
+size_t fxp16_ring_bytes(size_t capacity);
+
+/*!
+    \brief      fxp16_ring_init() with the storage taken from an arena
+    \returns    0 on success, -1 on a bad capacity or a too small arena; the arena is
+                unchanged then
+*/
+int fxp16_ring_init_arena(fxp16_ring_t *r, fxp16_arena_t *a, size_t capacity);
+
+/*!
+    \brief      Releases the storage of fxp16_ring_init_mapped(), no-op for caller storage
+*/
+void fxp16_ring_free(fxp16_ring_t *r);
+
+/*! \brief Number of samples ready to read, exact on the consumer side */
+size_t fxp16_ring_count(const fxp16_ring_t *r);
+
+/*! \brief Number of free samples, exact on the producer side */
+size_t fxp16_ring_space(const fxp16_ring_t *r);
+
+
+/*!
+    \brief      Contiguous free region
+    \details    Producer side. The region ends at the wrap point unless the ring is
+                mapped, and is empty only if the ring is full. The consumer's index is
+                re-read only when the cached one does not free the whole region.
+    \param[in]  r       Ring
+    \param[out] region  Start of the region
+    \returns    Number of samples that may be written to \p region
+*/
+size_t fxp16_ring_write_acquire(fxp16_ring_t *r, fxp16_t **region);
+
+/*!
+    \brief      Reserves exactly n contiguous free samples
+    \details    Producer side. Returns NULL if fewer are free, or, without the mapped
+                mode, if they would cross the wrap point.
+*/
+fxp16_t *fxp16_ring_write_reserve(fxp16_ring_t *r, size_t n);
+
+/*!
+    \brief      Publishes n written samples to the consumer
+*/
+void fxp16_ring_write_commit(fxp16_ring_t *r, size_t n);
+
+/*!
+    \brief      Copies up to n samples in, across the wrap point
+    \returns    Number of samples written
+*/
+size_t fxp16_ring_write(fxp16_ring_t *r, const fxp16_t *x, size_t n);
+
+
+/*!
+    \brief      Contiguous readable region
+    \details    Consumer side, counterpart of fxp16_ring_write_acquire().
+*/
+size_t fxp16_ring_read_acquire(fxp16_ring_t *r, const fxp16_t **region);
+
+/*!
+    \brief      Exactly n contiguous readable samples
+    \details    Consumer side, counterpart of fxp16_ring_write_reserve(). Several peeks
+                may precede a release, e.g. for the overlap of a FIR filter.
+*/
+const fxp16_t *fxp16_ring_read_peek(fxp16_ring_t *r, size_t n);
+
+/*!
+    \brief      Returns n read samples to the producer
+*/
+void fxp16_ring_read_release(fxp16_ring_t *r, size_t n);
+
+/*!
+    \brief      Copies up to n samples out, across the wrap point
+    \returns    Number of samples read
+*/
+size_t fxp16_ring_read(fxp16_ring_t *r, fxp16_t *y, size_t n);
+
+#endif /* _FXP16_RING_H_ */
@@ -0,0 +1,206 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_stats.c
+
+    \brief  Optional call, saturation and early-exit counters
+*/
+
+#include "fxp16.h"
+#include "fxp16_stats.h"
+
+
+#define FXP16_STATS_NAME_M(name)    #name,
+
+static const char *const fxp16_stats_names[FXP16_STATS_COUNT] = {
+    FXP16_STATS_FUNCTIONS(FXP16_STATS_NAME_M)
+};
+
+
+const char *fxp16_stats_name(fxp16_stats_fn_t fn)
+{
+    return ((unsigned)fn < FXP16_STATS_COUNT) ? fxp16_stats_names[fn] : "?";
+}
+
+
+#if FXP16CONF_STATS
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/*
+    One block per thread, allocated on first use and never freed, so the counts of
+    finished threads stay part of the aggregate. Only the owning thread writes a
+    block; relaxed atomics make the concurrent reads of fxp16_stats_get well defined.
+*/
+typedef struct fxp16_stats_block_s {
+    _Atomic uint64_t calls[FXP16_STATS_COUNT];
+    _Atomic uint64_t saturations[FXP16_STATS_COUNT];
+    _Atomic uint64_t early_exits[FXP16_STATS_COUNT];
+    struct fxp16_stats_block_s *next;
+} fxp16_stats_block_t;
+
+static _Atomic(fxp16_stats_block_t *) fxp16_stats_head = NULL;
+
+static FXP16_THREAD_LOCAL fxp16_stats_block_t *fxp16_stats_mine = NULL;
+static FXP16_THREAD_LOCAL uint8_t fxp16_stats_current = FXP16_STATS_internal;
+
+
+static fxp16_stats_block_t *fxp16_stats_block(void)
+{
+    fxp16_stats_block_t *b = fxp16_stats_mine;
+
+    if (b == NULL)
+    {
+        b = calloc(1, sizeof(*b));
+
+        if (b == NULL)
+        {
+            return NULL;        /* out of memory: the event is not counted */
+        }
+
+        b->next = atomic_load_explicit(&fxp16_stats_head, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&fxp16_stats_head, &b->next, b,
+                                                      memory_order_release, memory_order_relaxed))
+        {
+        }
+
+        fxp16_stats_mine = b;
+    }
+
+    return b;
+}
+
+
+/* single writer increment, a plain add on common targets */
+static inline void fxp16_stats_inc(_Atomic uint64_t *c)
+{
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+
+uint8_t fxp16_stats_enter(uint8_t fn)
+{
+    fxp16_stats_block_t *b = fxp16_stats_block();
+    uint8_t prev = fxp16_stats_current;
+
+    if (b != NULL)
+    {
+        fxp16_stats_inc(&b->calls[fn]);
+    }
+
+    fxp16_stats_current = fn;
+    return prev;
+}
+
+
+void fxp16_stats_leave(uint8_t *prev)
+{
+    fxp16_stats_current = *prev;
+}
+
+
+void fxp16_stats_saturation(void)
+{
+    fxp16_stats_block_t *b = fxp16_stats_block();
+
+    if (b != NULL)
+    {
+        fxp16_stats_inc(&b->saturations[fxp16_stats_current]);
+    }
+}
+
+
+void fxp16_stats_early_exit(void)
+{
+    fxp16_stats_block_t *b = fxp16_stats_block();
+
+    if (b != NULL)
+    {
+        fxp16_stats_inc(&b->early_exits[fxp16_stats_current]);
+    }
+}
+
+
+void fxp16_stats_get(fxp16_stats_t out[FXP16_STATS_COUNT])
+{
+    fxp16_stats_block_t *b = atomic_load_explicit(&fxp16_stats_head, memory_order_acquire);
+
+    for (int fn = 0; fn < FXP16_STATS_COUNT; fn++)
+    {
+        out[fn].calls = 0;
+        out[fn].saturations = 0;
+        out[fn].early_exits = 0;
+    }
+
+    for (; b != NULL; b = b->next)
+    {
+        for (int fn = 0; fn < FXP16_STATS_COUNT; fn++)
+        {
+            out[fn].calls       += atomic_load_explicit(&b->calls[fn], memory_order_relaxed);
+            out[fn].saturations += atomic_load_explicit(&b->saturations[fn], memory_order_relaxed);
+            out[fn].early_exits += atomic_load_explicit(&b->early_exits[fn], memory_order_relaxed);
+        }
+    }
+}
+
+
+void fxp16_stats_reset(void)
+{
+    fxp16_stats_block_t *b = atomic_load_explicit(&fxp16_stats_head, memory_order_acquire);
+
+    for (; b != NULL; b = b->next)
+    {
+        for (int fn = 0; fn < FXP16_STATS_COUNT; fn++)
+        {
+            atomic_store_explicit(&b->calls[fn], 0, memory_order_relaxed);
+            atomic_store_explicit(&b->saturations[fn], 0, memory_order_relaxed);
+            atomic_store_explicit(&b->early_exits[fn], 0, memory_order_relaxed);
+        }
+    }
+}
+
+#else
+
+void fxp16_stats_get(fxp16_stats_t out[FXP16_STATS_COUNT])
+{
+    for (int fn = 0; fn < FXP16_STATS_COUNT; fn++)
+    {
+        out[fn].calls = 0;
+        out[fn].saturations = 0;
+        out[fn].early_exits = 0;
+    }
+}
+
+
+void fxp16_stats_reset(void)
+{
+}
+
+#endif /* FXP16CONF_STATS */
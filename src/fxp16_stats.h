@@ -0,0 +1,147 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_stats.h
+
+    \brief  Optional call, saturation and early-exit counters
+
+    \details With FXP16CONF_STATS = 1 every instrumented function counts its calls,
+             the saturations that happen while it runs and the early-exit paths it
+             takes (special cases, early saturation). Counters live in per-thread
+             blocks that only their own thread writes; fxp16_stats_get() sums all
+             blocks on demand, including those of threads that already ended.
+
+             With FXP16CONF_STATS = 0 (default) all hooks compile to nothing.
+             The instrumentation build needs C11 atomics.
+*/
+
+#ifndef _FXP16_STATS_H_
+#define _FXP16_STATS_H_
+
+#include <stdint.h>
+
+
+/*! \brief Enables the instrumentation build */
+#ifndef FXP16CONF_STATS
+#define FXP16CONF_STATS     0
+#endif
+
+
+/*!
+    \brief      Instrumented functions
+    \details    X macro list; entry "internal" collects events outside any
+                instrumented function.
+*/
+#define FXP16_STATS_FUNCTIONS(X) \
+    X(internal)                                                                     \
+    X(flt2fp) X(dbl2fp) X(fp2fp) X(add) X(sub) X(mult) X(div)                       \
+    X(ceil) X(round) X(fmod) X(lround) X(rint) X(remainder) X(sqrt) X(cbrt)         \
+    X(sin) X(cos) X(tan) X(atan2) X(atan) X(asin) X(acos)                           \
+    X(sinh) X(cosh) X(tanh) X(sinhcoshtanh)                                         \
+    X(copysign) X(fabs) X(abs) X(fma)                                               \
+    X(tanh_vec) X(sigmoid_vec) X(flt2fp_vec) X(dbl2fp_vec) X(fp2fp_vec) X(narrow_vec) \
+    X(gemm) X(gemv) X(cmul_vec) X(cmac) X(cmag_vec)                                 \
+    X(bfp_add) X(bfp_mult) X(bfp_dot)                                               \
+    X(lut_build) X(lut_gather) X(unwrap_vec)                                        \
+    X(round_vec) X(remainder_vec)                                                   \
+    X(mat_mul) X(mat_transform) X(quat_normalize) X(quat_euler)                     \
+    X(goertzel_block) X(sdft_update)                                                \
+    X(moments_update) X(rms_vec) X(minmax_vec) X(meanvar_vec)                       \
+    X(pipe_run) X(deinterleave) X(interleave)
+
+#define FXP16_STATS_ENUM_M(name)    FXP16_STATS_##name,
+
+typedef enum {
+    FXP16_STATS_FUNCTIONS(FXP16_STATS_ENUM_M)
+    FXP16_STATS_COUNT
+} fxp16_stats_fn_t;
+
+/*! \brief Aggregated counters of one function */
+typedef struct {
+    uint64_t calls;         /*!< calls of the function */
+    uint64_t saturations;   /*!< saturating clamps while the function was innermost */
+    uint64_t early_exits;   /*!< special case / early saturation paths taken */
+} fxp16_stats_t;
+
+
+#if FXP16CONF_STATS
+
+    uint8_t fxp16_stats_enter(uint8_t fn);
+    void fxp16_stats_leave(uint8_t *prev);
+    void fxp16_stats_saturation(void);
+    void fxp16_stats_early_exit(void);
+
+    /*
+        Counts a call and attributes following events to fn until the enclosing block
+        ends. With GCC/Clang the previous function is restored automatically on return,
+        otherwise events after a nested instrumented call go to the nested function.
+    */
+    #if defined(__GNUC__)
+        #define fxp16_stats_call_m(fn) \
+            uint8_t fxp16_stats_scope_ __attribute__((cleanup(fxp16_stats_leave), unused)) = \
+                fxp16_stats_enter(FXP16_STATS_##fn)
+    #else
+        #define fxp16_stats_call_m(fn)  (void)fxp16_stats_enter(FXP16_STATS_##fn)
+    #endif
+
+    #define fxp16_stats_sat_m()         fxp16_stats_saturation()
+    #define fxp16_stats_early_m()       fxp16_stats_early_exit()
+
+#else
+
+    #define fxp16_stats_call_m(fn)
+    #define fxp16_stats_sat_m()         do{}while(0)
+    #define fxp16_stats_early_m()       do{}while(0)
+
+#endif
+
+
+/*!
+    \brief      Sums the counters of all threads
+    \details    Counters of running threads are read while they may still change,
+                so a snapshot taken during activity is approximate.
+    \param[out] out     FXP16_STATS_COUNT entries indexed by fxp16_stats_fn_t;
+                        all zero if FXP16CONF_STATS is 0
+*/
+void fxp16_stats_get(fxp16_stats_t out[FXP16_STATS_COUNT]);
+
+/*!
+    \brief      Resets the counters of all threads
+    \details    Increments racing with the reset in other threads may survive it.
+*/
+void fxp16_stats_reset(void);
+
+/*!
+    \brief      Name of an instrumented function
+    \param[in]  fn  Function id
+    \returns    Function name without the fxp16_ prefix, "?" for unknown ids
+*/
+const char *fxp16_stats_name(fxp16_stats_fn_t fn);
+
+#endif /* _FXP16_STATS_H_ */
@@ -0,0 +1,286 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_view.c
+
+    \brief  Strided views, interleave/deinterleave and view variants of the batch API
+*/
+
+#include "fxp16_view.h"
+#include "fxp16_kernels.h"
+#include "fxp16_lut.h"
+#include "fxp16_stats.h"
+
+
+#define fxp16_deinterleave_impl     (fxp16_kernels()->deinterleave)
+#define fxp16_interleave_impl       (fxp16_kernels()->interleave)
+
+
+/* ---- scalar kernels ----------------------------------------------------- */
+
+void fxp16_deinterleave_scalar(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames)
+{
+    for (size_t c = 0; c < channels; c++)
+    {
+        const fxp16_t *s = x + c;
+        fxp16_t *p = planes[c];
+
+        for (size_t f = 0; f < frames; f++)
+        {
+            p[f] = s[f * channels];
+        }
+    }
+}
+
+void fxp16_interleave_scalar(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames)
+{
+    for (size_t c = 0; c < channels; c++)
+    {
+        const fxp16_t *p = planes[c];
+        fxp16_t *d = y + c;
+
+        for (size_t f = 0; f < frames; f++)
+        {
+            d[f * channels] = p[f];
+        }
+    }
+}
+
+
+void fxp16_deinterleave(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames)
+{
+    fxp16_stats_call_m(deinterleave);
+    fxp16_deinterleave_impl(x, planes, channels, frames);
+}
+
+void fxp16_interleave(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames)
+{
+    fxp16_stats_call_m(interleave);
+    fxp16_interleave_impl(planes, y, channels, frames);
+}
+
+
+/* ---- tiled views -------------------------------------------------------- */
+
+/* pointer steps instead of index * stride, about a third faster; n > 0, and no step
+   past the last sample, which would leave the array for negative strides */
+static void fxp16_view_gather(fxp16_t *t, const fxp16_t *s, ptrdiff_t stride, size_t n)
+{
+    for (size_t i = 0; i + 1 < n; i++, s += stride)
+    {
+        t[i] = *s;
+    }
+    t[n - 1] = *s;
+}
+
+static void fxp16_view_scatter(fxp16_t *d, ptrdiff_t stride, const fxp16_t *t, size_t n)
+{
+    for (size_t i = 0; i + 1 < n; i++, d += stride)
+    {
+        *d = t[i];
+    }
+    *d = t[n - 1];
+}
+
+/* batch kernel on a contiguous block, in place allowed */
+typedef void (*fxp16_view_fn_t)(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n);
+
+/* contiguous views go to the kernel directly, strided ones through an L1 tile */
+static void fxp16_view_map(fxp16_cview_t x, fxp16_view_t y, fxp16_view_fn_t fn, const void *arg)
+{
+    fxp16_t t[FXP16CONF_VIEW_TILE];
+    size_t n = (x.count < y.count) ? x.count : y.count;
+
+    if (x.stride == 1 && y.stride == 1)
+    {
+        fn(arg, x.data, y.data, n);
+        return;
+    }
+
+    for (size_t off = 0; off < n; off += FXP16CONF_VIEW_TILE)
+    {
+        size_t len = (n - off < FXP16CONF_VIEW_TILE) ? n - off : FXP16CONF_VIEW_TILE;
+        const fxp16_t *s = x.data + (ptrdiff_t)off * x.stride;
+        fxp16_t *d = y.data + (ptrdiff_t)off * y.stride;
+
+        fxp16_view_gather(t, s, x.stride, len);
+        fn(arg, t, t, len);
+        fxp16_view_scatter(d, y.stride, t, len);
+    }
+}
+
+
+typedef struct {
+    uint8_t x_frac;
+    uint8_t y_frac;
+    fxp16_round_mode_t mode;
+    const fxp16_t *lut;
+} fxp16_view_arg_t;
+
+static void fxp16_view_fp2fp_fn(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_view_arg_t *a = (const fxp16_view_arg_t *)arg;
+    fxp16_fp2fp_vec(x, y, n, a->x_frac, a->y_frac);
+}
+
+static void fxp16_view_round_fn(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_view_arg_t *a = (const fxp16_view_arg_t *)arg;
+    fxp16_round_vec(x, y, n, a->x_frac, a->mode);
+}
+
+static void fxp16_view_lut_fn(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_view_arg_t *a = (const fxp16_view_arg_t *)arg;
+    fxp16_lut_gather(a->lut, x, y, n);
+}
+
+static void fxp16_view_tanh_fn(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_view_arg_t *a = (const fxp16_view_arg_t *)arg;
+    fxp16_tanh_vec(a->y_frac, x, a->x_frac, y, n);
+}
+
+static void fxp16_view_sigmoid_fn(const void *arg, const fxp16_t *x, fxp16_t *y, size_t n)
+{
+    const fxp16_view_arg_t *a = (const fxp16_view_arg_t *)arg;
+    fxp16_sigmoid_vec(a->y_frac, x, a->x_frac, y, n);
+}
+
+
+void fxp16_fp2fp_view(fxp16_cview_t x, fxp16_view_t y, uint8_t fracold, uint8_t fracnew)
+{
+    fxp16_view_arg_t a = { fracold, fracnew, FXP16_ROUND_NEAREST_AWAY, NULL };
+    fxp16_view_map(x, y, fxp16_view_fp2fp_fn, &a);
+}
+
+void fxp16_round_view(fxp16_cview_t x, fxp16_view_t y, uint8_t frac, fxp16_round_mode_t mode)
+{
+    fxp16_view_arg_t a = { frac, frac, mode, NULL };
+    fxp16_view_map(x, y, fxp16_view_round_fn, &a);
+}
+
+void fxp16_lut_gather_view(const fxp16_t *lut, fxp16_cview_t x, fxp16_view_t y)
+{
+    fxp16_view_arg_t a = { 0, 0, FXP16_ROUND_NEAREST_AWAY, lut };
+    fxp16_view_map(x, y, fxp16_view_lut_fn, &a);
+}
+
+void fxp16_tanh_view(uint8_t y_frac, fxp16_cview_t x, uint8_t x_frac, fxp16_view_t y)
+{
+    fxp16_view_arg_t a = { x_frac, y_frac, FXP16_ROUND_NEAREST_AWAY, NULL };
+    fxp16_view_map(x, y, fxp16_view_tanh_fn, &a);
+}
+
+void fxp16_sigmoid_view(uint8_t y_frac, fxp16_cview_t x, uint8_t x_frac, fxp16_view_t y)
+{
+    fxp16_view_arg_t a = { x_frac, y_frac, FXP16_ROUND_NEAREST_AWAY, NULL };
+    fxp16_view_map(x, y, fxp16_view_sigmoid_fn, &a);
+}
+
+
+void fxp16_moments_update_view(fxp16_moments_t *m, fxp16_cview_t x)
+{
+    fxp16_t t[FXP16CONF_VIEW_TILE];
+
+    if (x.stride == 1)
+    {
+        fxp16_moments_update(m, x.data, x.count);
+        return;
+    }
+
+    for (size_t off = 0; off < x.count; off += FXP16CONF_VIEW_TILE)
+    {
+        size_t len = (x.count - off < FXP16CONF_VIEW_TILE) ? x.count - off : FXP16CONF_VIEW_TILE;
+        const fxp16_t *s = x.data + (ptrdiff_t)off * x.stride;
+
+        fxp16_view_gather(t, s, x.stride, len);
+        fxp16_moments_update(m, t, len);
+    }
+}
+
+
+/* ---- elementwise scalar views ------------------------------------------- */
+
+static size_t fxp16_view_min3(size_t a, size_t b, size_t c)
+{
+    size_t n = (a < b) ? a : b;
+    return (n < c) ? n : c;
+}
+
+void fxp16_add_view(fxp16_cview_t a, fxp16_cview_t b, fxp16_view_t y)
+{
+    size_t n = fxp16_view_min3(a.count, b.count, y.count);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y.data[(ptrdiff_t)i * y.stride] = fxp16_add(a.data[(ptrdiff_t)i * a.stride], b.data[(ptrdiff_t)i * b.stride]);
+    }
+}
+
+void fxp16_sub_view(fxp16_cview_t a, fxp16_cview_t b, fxp16_view_t y)
+{
+    size_t n = fxp16_view_min3(a.count, b.count, y.count);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y.data[(ptrdiff_t)i * y.stride] = fxp16_sub(a.data[(ptrdiff_t)i * a.stride], b.data[(ptrdiff_t)i * b.stride]);
+    }
+}
+
+void fxp16_mult_view(fxp16_cview_t a, uint8_t afrac, fxp16_cview_t b, uint8_t bfrac, fxp16_view_t y)
+{
+    size_t n = fxp16_view_min3(a.count, b.count, y.count);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y.data[(ptrdiff_t)i * y.stride] = fxp16_mult(a.data[(ptrdiff_t)i * a.stride], afrac,
+                                                     b.data[(ptrdiff_t)i * b.stride], bfrac);
+    }
+}
+
+void fxp16_sin_view(fxp16_cview_t x, fxp16_view_t y)
+{
+    size_t n = (x.count < y.count) ? x.count : y.count;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y.data[(ptrdiff_t)i * y.stride] = fxp16_sin(x.data[(ptrdiff_t)i * x.stride]);
+    }
+}
+
+void fxp16_cos_view(fxp16_cview_t x, fxp16_view_t y)
+{
+    size_t n = (x.count < y.count) ? x.count : y.count;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        y.data[(ptrdiff_t)i * y.stride] = fxp16_cos(x.data[(ptrdiff_t)i * x.stride]);
+    }
+}
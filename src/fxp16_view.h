@@ -0,0 +1,178 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_view.h
+
+    \brief  Strided views, interleave/deinterleave and view variants of the batch API
+
+    \details Multi-channel frames usually arrive interleaved (ch0, ch1, ..., ch0, ...),
+             while the batch kernels want contiguous arrays. A view describes count
+             samples that are stride elements apart, so one channel of an
+             interleaved buffer is fxp16_view_channel() and no temporary copy is needed.
+
+             The _view functions take views instead of pointers. Views with stride 1 go
+             straight to the batch kernel; other views pass through an L1 resident tile
+             of FXP16CONF_VIEW_TILE samples, which keeps the vectorized kernel and
+             costs one gather and one scatter per sample. Elementwise scalar
+             operations walk the strides directly.
+
+             To process all channels of a buffer with the kernels, the buffer can also be
+             transposed to planes and back with fxp16_deinterleave() and
+             fxp16_interleave(), which are vectorized for 2 and 4 channels.
+*/
+
+#ifndef _FXP16_VIEW_H_
+#define _FXP16_VIEW_H_
+
+#include "fxp16.h"
+#include "fxp16_moments.h"
+#include <stddef.h>
+
+
+/*! \brief Samples per gather/scatter tile of strided views */
+#ifndef FXP16CONF_VIEW_TILE
+#define FXP16CONF_VIEW_TILE     256
+#endif
+
+
+/*!
+    \brief      Strided window on fxp16 samples
+    \details    Sample i is data[i * stride]; the stride may be negative.
+*/
+typedef struct {
+    fxp16_t  *data;
+    size_t    count;
+    ptrdiff_t stride;   /*!< in samples */
+} fxp16_view_t;
+
+/*! \brief Read only strided window on fxp16 samples */
+typedef struct {
+    const fxp16_t *data;
+    size_t         count;
+    ptrdiff_t      stride;  /*!< in samples */
+} fxp16_cview_t;
+
+
+/*! \brief View of count samples stride apart */
+static inline fxp16_view_t fxp16_view(fxp16_t *data, size_t count, ptrdiff_t stride)
+{
+    fxp16_view_t v = { data, count, stride };
+    return v;
+}
+
+/*! \brief Read only view of count samples stride apart */
+static inline fxp16_cview_t fxp16_cview(const fxp16_t *data, size_t count, ptrdiff_t stride)
+{
+    fxp16_cview_t v = { data, count, stride };
+    return v;
+}
+
+/*!
+    \brief      View of one channel of interleaved frames
+    \param[in]  frames      Interleaved buffer, frames * channels samples
+    \param[in]  nframes     Number of frames
+    \param[in]  channels    Samples per frame
+    \param[in]  ch          Channel, below \p channels
+*/
+static inline fxp16_view_t fxp16_view_channel(fxp16_t *frames, size_t nframes, size_t channels, size_t ch)
+{
+    return fxp16_view(frames + ch, nframes, (ptrdiff_t)channels);
+}
+
+/*! \brief Read only view of one channel of interleaved frames, see fxp16_view_channel() */
+static inline fxp16_cview_t fxp16_cview_channel(const fxp16_t *frames, size_t nframes, size_t channels, size_t ch)
+{
+    return fxp16_cview(frames + ch, nframes, (ptrdiff_t)channels);
+}
+
+/*! \brief Read only version of a view */
+static inline fxp16_cview_t fxp16_view_const(fxp16_view_t v)
+{
+    return fxp16_cview(v.data, v.count, v.stride);
+}
+
+
+/*!
+    \brief      Splits interleaved frames into one plane per channel
+    \details    planes[c][f] = x[f * channels + c]. Vectorized for 2 and 4 channels.
+    \param[in]  x           frames * channels interleaved samples
+    \param[out] planes      \p channels arrays of \p frames samples, not overlapping \p x
+    \param[in]  channels    Samples per frame
+    \param[in]  frames      Number of frames
+*/
+void fxp16_deinterleave(const fxp16_t *x, fxp16_t *const *planes, size_t channels, size_t frames);
+
+/*!
+    \brief      Merges one plane per channel into interleaved frames
+    \details    y[f * channels + c] = planes[c][f], inverse of fxp16_deinterleave().
+*/
+void fxp16_interleave(const fxp16_t *const *planes, fxp16_t *y, size_t channels, size_t frames);
+
+
+/*
+    View variants. Unless noted they process min(x.count, y.count) samples, are
+    bit-identical to the pointer function named in the brief and allow y to be the
+    same view as x. Partially overlapping views are not allowed.
+*/
+
+/*! \brief fxp16_fp2fp_vec() on views */
+void fxp16_fp2fp_view(fxp16_cview_t x, fxp16_view_t y, uint8_t fracold, uint8_t fracnew);
+
+/*! \brief fxp16_round_vec() on views */
+void fxp16_round_view(fxp16_cview_t x, fxp16_view_t y, uint8_t frac, fxp16_round_mode_t mode);
+
+/*! \brief fxp16_add() of two views, min of the three counts */
+void fxp16_add_view(fxp16_cview_t a, fxp16_cview_t b, fxp16_view_t y);
+
+/*! \brief fxp16_sub() of two views, min of the three counts */
+void fxp16_sub_view(fxp16_cview_t a, fxp16_cview_t b, fxp16_view_t y);
+
+/*! \brief fxp16_mult() of two views, min of the three counts */
+void fxp16_mult_view(fxp16_cview_t a, uint8_t afrac, fxp16_cview_t b, uint8_t bfrac, fxp16_view_t y);
+
+/*! \brief fxp16_sin() on views */
+void fxp16_sin_view(fxp16_cview_t x, fxp16_view_t y);
+
+/*! \brief fxp16_cos() on views */
+void fxp16_cos_view(fxp16_cview_t x, fxp16_view_t y);
+
+/*! \brief fxp16_lut_gather() on views, e.g. with a fxp16_lut_sin table */
+void fxp16_lut_gather_view(const fxp16_t *lut, fxp16_cview_t x, fxp16_view_t y);
+
+/*! \brief fxp16_tanh_vec() on views */
+void fxp16_tanh_view(uint8_t y_frac, fxp16_cview_t x, uint8_t x_frac, fxp16_view_t y);
+
+/*! \brief fxp16_sigmoid_vec() on views */
+void fxp16_sigmoid_view(uint8_t y_frac, fxp16_cview_t x, uint8_t x_frac, fxp16_view_t y);
+
+/*! \brief fxp16_moments_update() with the x.count samples of a view */
+void fxp16_moments_update_view(fxp16_moments_t *m, fxp16_cview_t x);
+
+
+#endif /* _FXP16_VIEW_H_ */
@@ -0,0 +1,78 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_wrap.c
+
+    \brief  Constant-divisor remainder and phase unwrapping
+*/
+
+#include "fxp16_wrap.h"
+
+
+int fxp16_fmod_const_init(fxp16_fmod_const_t *c, uint8_t xfrac, fxp16_t y, uint8_t yfrac)
+{
+    if (y == 0)
+    {
+        return -1;
+    }
+
+    uint32_t d = (uint32_t)((y < 0) ? -(int32_t)y : y) << xfrac;
+    uint8_t  l = 0;
+
+    while (((uint64_t)1 << l) < d)
+    {
+        l++;
+    }
+
+    c->y     = y;
+    c->xfrac = xfrac;
+    c->yfrac = yfrac;
+    c->shift = 31 + l;
+    c->magic = (((uint64_t)1 << c->shift) + d - 1) / d;
+    return 0;
+}
+
+
+void fxp16_unwrap_vec(fxp16_unwrap_t *st, const fxp16_t *phase, fxp32_t *out, size_t n)
+{
+    fxp16_stats_call_m(unwrap_vec);
+
+    fxp16_t  prev = st->prev;
+    uint32_t acc  = (uint32_t)st->acc;     /* unsigned: wraps instead of overflowing */
+
+    for (size_t i = 0; i < n; i++)
+    {
+        acc += (uint32_t)(int32_t)fxp16_wrap_pi((fxp32_t)phase[i] - prev);
+        out[i] = (fxp32_t)acc;
+        prev = phase[i];
+    }
+
+    st->prev = prev;
+    st->acc  = (fxp32_t)acc;
+}
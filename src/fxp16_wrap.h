@@ -0,0 +1,133 @@
+/*! \copyright
+    Copyright (c) 2017-2022, marco@bacchi.at
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. The name of the author may not be used to endorse or promote
+       products derived from this software without specific prior
+       written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+    OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+    GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+    WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+    NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*!
+    \file   fxp16_wrap.h
+
+    \brief  Constant-divisor remainder, angle wrapping and phase unwrapping
+
+    \details fxp16_fmod() divides on every call. When the divisor is fixed, e.g. when
+             wrapping phases into a period, fxp16_fmod_const_init() turns it into a
+             magic reciprocal once and fxp16_fmod_const() needs one 64 bit multiply
+             and a shift instead, with results bit-identical to fxp16_fmod().
+
+             π-normalized Q1.15 angles (see \ref fxp16_trig) need no division at all:
+             [-1.0, +1.0) is the full int16 range, so wrapping into [-π, +π) is the
+             two's complement wrap of fxp16_wrap_pi(). fxp16_unwrap_vec() builds on it
+             to remove the 2π jumps from a stream of fxp16_atan2() angles.
+*/
+
+#ifndef _FXP16_WRAP_H_
+#define _FXP16_WRAP_H_
+
+#include "fxp16.h"
+
+
+/*! \brief Precomputed divisor of fxp16_fmod_const() */
+typedef struct {
+    fxp16_t  y;         /*!< divisor */
+    uint8_t  xfrac;     /*!< fractional bits of the dividend */
+    uint8_t  yfrac;     /*!< fractional bits of the divisor */
+    uint8_t  shift;     /*!< 31 + ceil(log2(|y| << xfrac)) */
+    uint64_t magic;     /*!< ceil(2^shift / (|y| << xfrac)) */
+} fxp16_fmod_const_t;
+
+/*! \brief Phase unwrapping state, zero-initialize or use FXP16_UNWRAP_INIT */
+typedef struct {
+    fxp16_t  prev;      /*!< last input angle */
+    fxp32_t  acc;       /*!< last unwrapped angle */
+} fxp16_unwrap_t;
+
+#define FXP16_UNWRAP_INIT   { 0, 0 }
+
+
+/*!
+    \brief      Precomputes a divisor for fxp16_fmod_const()
+    \param[out] c       Divisor state
+    \param[in]  xfrac   Number of fractional bits of the dividends
+    \param[in]  y       Divisor
+    \param[in]  yfrac   Number of fractional bits of y
+    \returns    0 on success, -1 if y is zero
+*/
+int fxp16_fmod_const_init(fxp16_fmod_const_t *c, uint8_t xfrac, fxp16_t y, uint8_t yfrac);
+
+/*!
+    \brief      Remainder of a division by a precomputed divisor
+    \details    Same result as fxp16_fmod(x, c->xfrac, c->y, c->yfrac). The truncated
+                quotient trunc(|x| / (|y| << xfrac)) is taken as (|x| << yfrac) * magic >> shift,
+                which is exact for every 31 bit numerator.
+    \param[in]  x       Dividend with c->xfrac fractional bits
+    \param[in]  c       Divisor from fxp16_fmod_const_init()
+    \returns    Remainder in the format of x
+*/
+static inline fxp16_t fxp16_fmod_const(fxp16_t x, const fxp16_fmod_const_t *c)
+{
+    int32_t  n = (int32_t)x * (1 << c->yfrac);
+    uint32_t a = (n < 0) ? -(uint32_t)n : (uint32_t)n;
+    int32_t  q = (int32_t)(((uint64_t)a * c->magic) >> c->shift) << c->xfrac;
+
+    if ((n < 0) != (c->y < 0))
+    {
+        q = -q;
+    }
+
+    int32_t result = q * c->y;
+    fpxx_arshift_m(result, c->yfrac);
+
+    result = x - result;
+    fxp16_sat_m(result);
+    return (fxp16_t)result;
+}
+
+/*!
+    \brief      Wraps a π-normalized Q15 angle into [-π, +π)
+    \details    The angle may be any sum or difference of Q15 angles; the result is its
+                value modulo 2π (2.0), i.e. the low 16 bits.
+    \param[in]  phase   Angle in Q15 units of π
+    \returns    Wrapped angle, Q15 π-normalized
+*/
+static inline fxp16_t fxp16_wrap_pi(fxp32_t phase)
+{
+    return (fxp16_t)(uint16_t)phase;
+}
+
+/*!
+    \brief      Unwraps a stream of π-normalized Q15 angles
+    \details    out[i] = out[i-1] + fxp16_wrap_pi(phase[i] - phase[i-1]), i.e. every jump
+                is taken as the shortest rotation; a jump of exactly π counts as -π.
+                The state carries the stream across calls; a zeroed state starts at
+                out[0] = phase[0]. The unwrapped angle is Q15 in units of π and wraps
+                modulo 2^32 after 32768 turns.
+    \param[in,out] st       Unwrapping state
+    \param[in]  phase   Angles, e.g. from fxp16_atan2() or fxp16_carg_vec()
+    \param[out] out     Unwrapped angles
+    \param[in]  n       Number of elements
+*/
+void fxp16_unwrap_vec(fxp16_unwrap_t *st, const fxp16_t *phase, fxp32_t *out, size_t n);
+
+#endif /* _FXP16_WRAP_H_ */